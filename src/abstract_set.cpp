@@ -132,8 +132,8 @@ void AbstractSet::printOptimalPartitionListInCSV (double threshold, Dataset *dat
 	
 			addCSVField(file,(int) q->sumValue);
 			addCSVField(file,(int) q->sumRefValue);
-			addCSVField(file,q->sizeReduction);
-			addCSVField(file,q->divergence,false);
+			addCSVField(file,q->getGain());
+			addCSVField(file,q->getLoss(),false);
 	
 			endCSVLine(file);
 		}
@@ -160,25 +160,25 @@ PartitionList *AbstractSet::getOptimalPartitionList (double threshold)
 	addOptimalPartitionList(partitionList,minPartition,maxPartition,0,1,threshold);
 	partitionList->push_back(maxPartition);
 	
-	Partition *currentPartition;
+	unsigned long long currentFingerprint;
 	bool first = true;
 	
 	
 	for (PartitionList::iterator it = partitionList->begin(); it != partitionList->end(); )
 	{
 		Partition *newPartition = *it;
+		unsigned long long newFingerprint = newPartition->getFingerprint();
 		if (first)
 		{
-			currentPartition = newPartition;
+			currentFingerprint = newFingerprint;
 			first = false;
 			++it;
 		}
 		else
 		{
-			if (!newPartition->value->equal(currentPartition->value))
-			//if (!newPartition->equal(currentPartition))
+			if (newFingerprint != currentFingerprint)
 			{
-				currentPartition = newPartition;
+				currentFingerprint = newFingerprint;
 				++it;
 			}
 			else
@@ -196,7 +196,7 @@ PartitionList *AbstractSet::getOptimalPartitionList (double threshold)
 void AbstractSet::addOptimalPartitionList (PartitionList *partitionList, Partition *minPartition, Partition *maxPartition,
 	double minUnit, double maxUnit, double threshold)
 {
-	if (minPartition->equal(maxPartition) || (objective->getUnitDistance(minUnit,maxUnit) <= threshold)) return;
+	if (minPartition->getFingerprint() == maxPartition->getFingerprint() || (objective->getUnitDistance(minUnit,maxUnit) <= threshold)) return;
 
 	double newUnit = objective->getIntermediaryUnit(minUnit,maxUnit);
 	Partition *newPartition = getOptimalPartition(objective->getParameter(newUnit));
@@ -0,0 +1,127 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <math.h>
+
+#include "aggregated_statistics.hpp"
+
+
+AggregatedStatistics::AggregatedStatistics (int s, double *val, double *refVal, Mode m, bool n) : RelativeEntropy (s, val, refVal)
+{
+	entropyGainFactor = 1;
+	setMode(m,n);
+}
+
+
+void AggregatedStatistics::setMode (Mode m, bool n)
+{
+	mode = m;
+	normalized = n;
+}
+
+
+ObjectiveValue *AggregatedStatistics::newObjectiveValue (int id) { return new StatisticsObjectiveValue(this,id); }
+
+void AggregatedStatistics::computeObjectiveValues ()
+{
+	RelativeEntropy::computeObjectiveValues();
+	entropyGainFactor = 1;
+}
+
+void AggregatedStatistics::normalizeObjectiveValues (ObjectiveValue *q)
+{
+	StatisticsObjectiveValue *rq = (StatisticsObjectiveValue *) q;
+
+	// The base class sets the size reduction and divergence factors: only the entropy reduction one is missing
+	RelativeEntropy::normalizeObjectiveValues(q);
+	entropyGainFactor = 1;
+	if (rq->entropyReduction > 0) { entropyGainFactor = rq->entropyReduction; }
+}
+
+double AggregatedStatistics::getParameter (double unit)
+{
+	if (mode != INFORMATION_CRITERION) { return unit; }
+	if (unit < 1) return unit / (1 - unit);
+	else return -1;
+}
+
+
+
+StatisticsObjectiveValue::StatisticsObjectiveValue (AggregatedStatistics *m, int id) : RelativeObjectiveValue (m, id) {}
+
+
+void StatisticsObjectiveValue::print (bool v)
+{
+	AggregatedStatistics *m = (AggregatedStatistics*) objective;
+
+	if (v)
+	{
+		std::cout << "value = " << std::setw(5) << std::setprecision(3) << sumValue
+				  << "   refvalue = " << std::setw(5) << std::setprecision(3) << sumRefValue;
+
+		if (m->mode == AggregatedStatistics::ENTROPY_REDUCTION) { std::cout << "   gain = " << std::setw(5) << std::setprecision(3) << entropyReduction; }
+		else { std::cout << "   gain = " << std::setw(5) << std::setprecision(3) << sizeReduction; }
+
+		std::cout << "   loss = " << std::setw(5) << std::setprecision(3) << divergence << std::endl;
+	}
+	else {
+		std::cout << "value = " << std::setw(5) << std::setprecision(3) << sumValue
+				  << "   refvalue = " << std::setw(5) << std::setprecision(3) << sumRefValue << std::endl;
+	}
+}
+
+
+double StatisticsObjectiveValue::getValue (double param)
+{
+	AggregatedStatistics *m = (AggregatedStatistics*) objective;
+
+	double gain = getGain(m->normalized);
+	double loss = getLoss(m->normalized);
+	if (m->mode == AggregatedStatistics::ENTROPY_REDUCTION) { gain = m->normalized ? entropyReduction / m->entropyGainFactor : entropyReduction; }
+
+	if (m->mode == AggregatedStatistics::INFORMATION_CRITERION)
+	{
+		if (param >= 0) return gain - param * loss;
+		return -loss;
+	}
+	
+	return param * gain - (1-param) * loss;
+}
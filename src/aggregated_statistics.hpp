@@ -0,0 +1,113 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_AGGREGATED_STATISTICS
+#define INCLUDE_AGGREGATED_STATISTICS
+
+/*!
+ * \file aggregated_statistics.hpp
+ * \brief Objective function computing once the sufficient statistics of all feasible parts, so that several information-theoretic objectives can be evaluated on the same set without aggregating the data again
+ * \author Robin Lamarche-Perrin
+ * \date 06/11/2015
+ */
+
+#include "relative_entropy.hpp"
+
+/*!
+ * \class AggregatedStatistics
+ * \brief Objective function storing, for each feasible part, the sums of values and reference values, the microscopic entropy and information, and the resulting divergence and reductions; the objective actually optimised is selected by setMode() and can be changed at any time without calling computeObjectiveValues() again
+ */
+class AggregatedStatistics: public RelativeEntropy
+{
+public:
+	/*!
+	 * \brief Objectives that can be evaluated from the aggregated statistics
+	 */
+	enum Mode {
+		SIZE_REDUCTION, /** \brief Same as RelativeEntropy with entropy = false */
+		ENTROPY_REDUCTION, /** \brief Same as RelativeEntropy with entropy = true */
+		INFORMATION_CRITERION /** \brief Same as InformationCriterion */
+	};
+	
+	Mode mode; /** \brief The objective currently evaluated by getValue (double param) */
+	bool normalized; /** \brief True if gains and losses are divided by the ones of the whole set when evaluated */
+
+	/*!
+	 * \brief Constructor
+	 * \param size : Number of elements
+	 * \param values : Observed values of the elements
+	 * \param refValues : (Optional) Reference values of the elements (uniform if not specified)
+	 * \param mode : The objective to evaluate first
+	 * \param normalized : True if the evaluated objective should be normalised
+	 */
+	AggregatedStatistics (int size, double *values = 0, double *refValues = 0, Mode mode = SIZE_REDUCTION, bool normalized = true);
+
+	/*!
+	 * \brief Select the objective evaluated from the statistics (no recomputation of the objective values is needed)
+	 * \param mode : The objective to evaluate
+	 * \param normalized : True if the evaluated objective should be normalised
+	 */
+	void setMode (Mode mode, bool normalized = true);
+
+	ObjectiveValue *newObjectiveValue (int index = -1);
+	void computeObjectiveValues ();
+	void normalizeObjectiveValues (ObjectiveValue *q);
+
+	double getParameter (double unit);
+
+private:
+	double entropyGainFactor; /** \brief Entropy reduction of the whole set, by which gains are divided in ENTROPY_REDUCTION mode when normalised (gainFactor being the size reduction, since entropy stays false) */
+
+	friend class StatisticsObjectiveValue;
+};
+
+
+/*!
+ * \class StatisticsObjectiveValue
+ * \brief Sufficient statistics of a feasible part (accumulated by RelativeObjectiveValue), from which all the objectives of AggregatedStatistics are evaluated
+ */
+class StatisticsObjectiveValue: public RelativeObjectiveValue
+{
+public:
+	StatisticsObjectiveValue (AggregatedStatistics *objective, int index = -1);
+		
+	void print (bool verbose = true);
+	double getValue (double param);
+};
+
+
+#endif
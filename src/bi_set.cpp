@@ -123,11 +123,7 @@ void BiSet::computeObjectiveValues ()
 }
 
 
-void BiSet::normalizeObjectiveValues ()
-{
-	initReached();
-	firstBiSubset->normalizeObjectiveValues();
-}
+void BiSet::normalizeObjectiveValues () { objective->normalizeObjectiveValues(firstBiSubset->value); }
 
 
 void BiSet::printObjectiveValues ()
@@ -338,28 +334,6 @@ void BiSubset::computeObjectiveValues ()
 }
 
 
-void BiSubset::normalizeObjectiveValues (ObjectiveValue *maxQual)
-{
-	if (maxQual == 0) { maxQual = value; }
-
-	for (BiSubsetSetSet::iterator it1 = biSubsetSetSet->begin(); it1 != biSubsetSetSet->end(); ++it1)
-	{
-		BiSubsetSet *biSubsetSet = *it1;
-		for (BiSubsetSet::iterator it2 = biSubsetSet->begin(); it2 != biSubsetSet->end(); ++it2)
-		{
-			BiSubset *biSubset = *it2;
-			if (!biSubset->reached)
-			{
-				biSubset->reached = true;
-				biSubset->normalizeObjectiveValues(maxQual);
-			}
-		}
-	}
-
-	value->normalize(maxQual);
-}
-
-
 void BiSubset::printObjectiveValues ()
 {
 	printIndexSet();
@@ -414,6 +388,45 @@ void BiSubset::computeOptimalPartition (double parameter)
 			optimalCut = biSubsetSet;
 		}
 	}
+
+	// Refinements generated on demand by the uni-dimensional sets, only the best one being kept
+	UniSubset *uniSubsets [2] = {uniSubset1, uniSubset2};
+	for (int d = 0; d < 2; d++)
+	{
+		UniSubsetSetSet refinements;
+		uniSubsets[d]->uniSet->getLazyRefinements(uniSubsets[d],refinements);
+
+		for (UniSubsetSetSet::iterator it1 = refinements.begin(); it1 != refinements.end(); ++it1)
+		{
+			BiSubsetSet biSubsetSet;
+			for (UniSubsetSet::iterator it2 = (*it1)->begin(); it2 != (*it1)->end(); ++it2)
+			{
+				UniSubset *subSubset = *it2;
+				if (d == 0) { biSubsetSet.push_back(biSet->biSubsetArray[subSubset->num + uniSubset2->num * subSubset->uniSet->uniSubsetNumber]); }
+				else { biSubsetSet.push_back(biSet->biSubsetArray[uniSubset1->num + subSubset->num * uniSubset1->uniSet->uniSubsetNumber]); }
+			}
+			delete *it1;
+
+			double value = 0;
+			for (BiSubsetSet::iterator it2 = biSubsetSet.begin(); it2 != biSubsetSet.end(); ++it2)
+			{
+				BiSubset *biSubset = *it2;
+				if (!biSubset->reached)
+				{
+					biSubset->reached = true;
+					biSubset->computeOptimalPartition(parameter);
+				}
+				value += biSubset->optimalValue;
+			}
+
+			if ((objective->maximize && value > optimalValue) || (!objective->maximize && value < optimalValue))
+			{
+				optimalValue = value;
+				lazyCut.swap(biSubsetSet);
+				optimalCut = &lazyCut;
+			}
+		}
+	}
 }
 
 
@@ -98,6 +98,7 @@ public:
 	ObjectiveValue *value;
 	double optimalValue;
 	BiSubsetSet *optimalCut;
+	BiSubsetSet lazyCut;
 
 	BiSubset (UniSubset *uniSubset1, UniSubset *uniSubset2);
 	~BiSubset ();
@@ -109,7 +110,6 @@ public:
 
 	void buildDataStructure ();
 	void computeObjectiveValues ();
-	void normalizeObjectiveValues (ObjectiveValue *maxQual = 0);
 	void printObjectiveValues ();
 
 	void computeOptimalPartition (double parameter);
@@ -35,11 +35,12 @@
  */
 
 
-/*
+
 #include <cstdlib>
 #include <iostream>
 #include <iomanip>
 #include <math.h>
+#include <algorithm>
 
 #include "bidimensional_relative_entropy.hpp"
 
@@ -47,23 +48,22 @@
 BidimensionalRelativeEntropy::BidimensionalRelativeEntropy (int s1, int s2, double *val, double *refVal1, double *refVal2)
 {
 	size1 = s1;
-	size1 = s2;
+	size2 = s2;
 	maximize = true;
 	values = new double [size1*size2];
 	refValues1 = new double [size1];
 	refValues2 = new double [size2];
+	microInfos = new double [size1*size2];
+	marginals = (refVal1 == 0 || refVal2 == 0);
+	gainFactor = 1;
+	lossFactor = 1;
 
-	if (val != 0) {
-		for (int i = 0; i < size1; i++)
-			for (int j = 0; j < size2; j++)
-				values[i+size1*j] = val[i+size1*j];
+	if (val != 0) { for (int k = 0; k < size1*size2; k++) { values[k] = val[k]; } }
+	if (!marginals)
+	{
+		for (int i = 0; i < size1; i++) { refValues1[i] = refVal1[i]; }
+		for (int j = 0; j < size2; j++) { refValues2[j] = refVal2[j]; }
 	}
-	
-	if (refVal1 != 0 && val != 0) { for (int i = 0; i < size1; i++) { refValues1[i] = refVal1[i]; } }
-	if (refVal1 == 0 && val != 0) { for (int i = 0; i < size1; i++) { refValues1[i] = 1; } }
-
-	if (refVal2 != 0 && val != 0) { for (int j = 0; j < size2; j++) { refValues2[j] = refVal2[j]; } }
-	if (refVal2 == 0 && val != 0) { for (int j = 0; j < size2; j++) { refValues2[j] = 1; } }
 }
 
 
@@ -72,30 +72,69 @@ BidimensionalRelativeEntropy::~BidimensionalRelativeEntropy ()
 	delete[] values;
 	delete[] refValues1;
 	delete[] refValues2;
+	delete[] microInfos;
 }
 
 
 void BidimensionalRelativeEntropy::setRandom ()
 {
-	for (int i = 0; i < size1; i++)
+	for (int k = 0; k < size1*size2; k++) { values[k] = rand() % 1024; }
+	marginals = true;
+}
+
+
+ObjectiveValue *BidimensionalRelativeEntropy::newObjectiveValue (int id) { return new BidimensionalRelativeObjectiveValue(this,id); }
+
+
+void BidimensionalRelativeEntropy::computeObjectiveValues ()
+{
+	gainFactor = 1;
+	lossFactor = 1;
+
+	if (marginals)
+	{
+		for (int i = 0; i < size1; i++) { refValues1[i] = 0; }
+		for (int j = 0; j < size2; j++) { refValues2[j] = 0; }
+
 		for (int j = 0; j < size2; j++)
-			values[i+size1*j] = rand() % 1024;
-	for (int i = 0; i < size1; i++) { refValues1[i] = 1; }
-	for (int j = 0; j < size2; j++) { refValues2[j] = 1; }
+		{
+			const double *row = values + j*size1;
+			double sum = 0;
+			for (int i = 0; i < size1; i++) { refValues1[i] += row[i]; sum += row[i]; }
+			refValues2[j] = sum;
+		}
+	}
+
+	// Microscopic information of all elements, computed row by row on contiguous arrays so that the loop can be vectorised
+	for (int j = 0; j < size2; j++)
+	{
+		const double *row = values + j*size1;
+		double *infoRow = microInfos + j*size1;
+		double r2 = refValues2[j];
+		for (int i = 0; i < size1; i++)
+		{
+			double v = row[i];
+			double r = refValues1[i] * r2;
+			infoRow[i] = (v > 0 && r > 0) ? - v * log2(v/r) : 0;
+		}
+	}
 }
 
 
-ObjectiveValue *BidimensionalRelativeEntropy::newObjectiveValue (int id)
+void BidimensionalRelativeEntropy::normalizeObjectiveValues (ObjectiveValue *q)
 {
-	BidimensionalRelativeObjectiveValue *rq;
-	
-	rq = new BidimensionalRelativeObjectiveValue(this,id);
-	valueSet->insert(rq);
+	BidimensionalRelativeObjectiveValue *rq = (BidimensionalRelativeObjectiveValue *) q;
 
-	return rq;
+	gainFactor = 1;
+	lossFactor = 1;
+	if (rq->sizeReduction > 0) { gainFactor = rq->sizeReduction; }
+	if (rq->divergence > 0) { lossFactor = rq->divergence; }
 }
 
 
+void BidimensionalRelativeEntropy::printObjectiveValues (bool v) {}
+
+
 double BidimensionalRelativeEntropy::getParameter (double unit) { return unit; }
 
 double BidimensionalRelativeEntropy::getUnitDistance (double uMin, double uMax) { return uMax - uMin; }
@@ -108,8 +147,12 @@ BidimensionalRelativeObjectiveValue::BidimensionalRelativeObjectiveValue (Bidime
 {
 	objective = m;
 	index = id;
+	first1 = -1;
+	first2 = -1;
 	
 	sumValue = 0;
+	sumRefValue1 = 0;
+	sumRefValue2 = 0;
 	sumRefValue = 0;
 	microInfo = 0;
 	divergence = 0;
@@ -120,10 +163,19 @@ BidimensionalRelativeObjectiveValue::BidimensionalRelativeObjectiveValue (Bidime
 BidimensionalRelativeObjectiveValue::~BidimensionalRelativeObjectiveValue () {}
 
 
+bool BidimensionalRelativeObjectiveValue::equal (ObjectiveValue *q, int prec)
+{
+	double factor = pow(10,prec);
+	BidimensionalRelativeObjectiveValue *value = (BidimensionalRelativeObjectiveValue *) q;
+	return (round(divergence*factor) == round(value->divergence*factor) && round(sizeReduction*factor) == round(value->sizeReduction*factor));
+}
+
+
 void BidimensionalRelativeObjectiveValue::add (ObjectiveValue *q)
 {
 	BidimensionalRelativeObjectiveValue *value = (BidimensionalRelativeObjectiveValue *) q;
 	
+	// Parts of a partition are not aggregated along a single dimension: only their total reference value is summed
 	sumValue += value->sumValue;
 	sumRefValue += value->sumRefValue;
 	microInfo += value->microInfo;
@@ -134,70 +186,86 @@ void BidimensionalRelativeObjectiveValue::add (ObjectiveValue *q)
 
 void BidimensionalRelativeObjectiveValue::compute ()
 {
-	sumValue = ((BidimensionalRelativeEntropy*)objective)->values[index];
-	sumRefValue = ((BidimensionalRelativeEntropy*)objective)->refValues1[index] * ((BidimensionalRelativeEntropy*)objective)->refValues2[index];
-	if (sumValue > 0) { microInfo = - sumValue * log2(sumValue/sumRefValue); } else { microInfo = 0; }
+	BidimensionalRelativeEntropy *m = (BidimensionalRelativeEntropy*) objective;
+	first1 = index % m->size1;
+	first2 = index / m->size1;
+
+	sumValue = m->values[index];
+	sumRefValue1 = m->refValues1[first1];
+	sumRefValue2 = m->refValues2[first2];
+	sumRefValue = sumRefValue1 * sumRefValue2;
+	microInfo = m->microInfos[index];
 	sizeReduction = 0;
 	divergence = 0;
 }
 
 
-void BidimensionalRelativeObjectiveValue::compute (ObjectiveValue *q1, ObjectiveValue *q2, bool dim1)
+void BidimensionalRelativeObjectiveValue::compute (ObjectiveValue *q1, ObjectiveValue *q2)
 {
 	BidimensionalRelativeObjectiveValue *rq1 = (BidimensionalRelativeObjectiveValue *) q1;
 	BidimensionalRelativeObjectiveValue *rq2 = (BidimensionalRelativeObjectiveValue *) q2;
 
+	// Both parts share the same subset in the dimension along which they are not disjoint
 	sumValue = rq1->sumValue + rq2->sumValue;
-	if (dim1) { sumRefValue1 = rq1->sumRefValue1 + rq2->sumRefValue1; }
-	else { sumRefValue2 = rq1->sumRefValue2 + rq2->sumRefValue2; }
+	if (rq1->first1 != rq2->first1) { sumRefValue1 = rq1->sumRefValue1 + rq2->sumRefValue1; sumRefValue2 = rq1->sumRefValue2; }
+	else { sumRefValue1 = rq1->sumRefValue1; sumRefValue2 = rq1->sumRefValue2 + rq2->sumRefValue2; }
 	microInfo = rq1->microInfo + rq2->microInfo;
 	sizeReduction = rq1->sizeReduction + rq2->sizeReduction + 1;
-				
-	if (sumValue > 0) { divergence = - microInfo - sumValue * log2(sumValue/(sumRefValue1*sumRefValue2)); }
-	else { divergence = 0; }
+	first1 = std::min(rq1->first1,rq2->first1);
+	first2 = std::min(rq1->first2,rq2->first2);
+
+	computeDivergence();
 }
 
 
-void BidimensionalRelativeObjectiveValue::compute (ObjectiveValueSet *valueSet, bool dim1)
+void BidimensionalRelativeObjectiveValue::compute (ObjectiveValueSet *valueSet)
 {
+	// Feasible parts are products of subsets: the parts of a refinement are disjoint along one dimension only and share the same subset in the other one
+	BidimensionalRelativeObjectiveValue *rq0 = (BidimensionalRelativeObjectiveValue *) (*valueSet->begin());
+	bool dim1 = true;
+	if (valueSet->size() > 1) { dim1 = (rq0->first1 != ((BidimensionalRelativeObjectiveValue *) (*(++valueSet->begin())))->first1); }
+
 	sumValue = 0;
-	sumRefValue = 0;
+	sumRefValue1 = 0;
+	sumRefValue2 = 0;
 	microInfo = 0;
 	sizeReduction = 0;
+	first1 = rq0->first1;
+	first2 = rq0->first2;
 	for (ObjectiveValueSet::iterator it = valueSet->begin(); it != valueSet->end(); ++it)
 	{
 		BidimensionalRelativeObjectiveValue *rq = (BidimensionalRelativeObjectiveValue *) (*it);
 
 		sumValue += rq->sumValue;
-		sumRefValue += rq->sumRefValue;
+		if (dim1) { sumRefValue1 += rq->sumRefValue1; sumRefValue2 = rq->sumRefValue2; }
+		else { sumRefValue2 += rq->sumRefValue2; sumRefValue1 = rq->sumRefValue1; }
 		microInfo += rq->microInfo;
 		sizeReduction += rq->sizeReduction + 1;
+		if (rq->first1 < first1) { first1 = rq->first1; }
+		if (rq->first2 < first2) { first2 = rq->first2; }
 	}
 	sizeReduction--;
-				
-	if (sumValue > 0) { divergence = - microInfo - sumValue * log2(sumValue/sumRefValue); }
-	else { divergence = 0; }
+
+	computeDivergence();
 }
 
 
-void BidimensionalRelativeObjectiveValue::normalize (ObjectiveValue *q)
+void BidimensionalRelativeObjectiveValue::computeDivergence ()
 {
-	BidimensionalRelativeObjectiveValue *rq = (BidimensionalRelativeObjectiveValue *) q;
-
-	if (rq->sizeReduction > 0) { sizeReduction = sizeReduction / rq->sizeReduction; }
-	if (rq->divergence > 0) { divergence /= rq->divergence; }
+	sumRefValue = sumRefValue1 * sumRefValue2;
+	if (sumValue > 0 && sumRefValue > 0) { divergence = - microInfo - sumValue * log2(sumValue/sumRefValue); }
+	else { divergence = 0; }
 }
 
 
 void BidimensionalRelativeObjectiveValue::print (bool v)
 {
-
 	if (v)
 	{
 		std::cout << "value = " << std::setw(5) << std::setprecision(3) << sumValue
 		<< "   refvalue = " << std::setw(5) << std::setprecision(3) << sumRefValue
-		<< "   gain = " << std::setw(5) << std::setprecision(3) << sizeReduction
-		<< "   loss = " << std::setw(5) << std::setprecision(3) << divergence << std::endl;
+		<< "   gain = " << std::setw(5) << std::setprecision(3) << sizeReduction / ((BidimensionalRelativeEntropy*)objective)->gainFactor
+		<< "   loss = " << std::setw(5) << std::setprecision(3) << divergence / ((BidimensionalRelativeEntropy*)objective)->lossFactor << std::endl;
 	} else {
 		std::cout << "value = " << std::setw(5) << std::setprecision(3) << sumValue
 		<< "   refvalue = " << std::setw(5) << std::setprecision(3) << sumRefValue << std::endl;
@@ -205,5 +273,8 @@ void BidimensionalRelativeObjectiveValue::print (bool v)
 }
 
 
-double BidimensionalRelativeObjectiveValue::getValue (double param) { return param * sizeReduction - (1-param) * divergence; }
-*/
+double BidimensionalRelativeObjectiveValue::getValue (double param)
+{
+	BidimensionalRelativeEntropy *m = (BidimensionalRelativeEntropy*) objective;
+	return param * sizeReduction / m->gainFactor - (1-param) * divergence / m->lossFactor;
+}
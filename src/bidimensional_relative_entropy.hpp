@@ -38,23 +38,41 @@
 #ifndef INCLUDE_BIDIMENSIONAL_RELATIVE_ENTROPY
 #define INCLUDE_BIDIMENSIONAL_RELATIVE_ENTROPY
 
-/*
 #include "objective_function.hpp"
 
+/*!
+ * \class BidimensionalRelativeEntropy
+ * \brief Relative entropy of a bi-dimensional data set (size1 x size2 values, the first dimension varying fastest) with respect to a separable reference model, the reference value of element (i,j) being refValues1[i] * refValues2[j] (the product matrix is never built)
+ */
 class BidimensionalRelativeEntropy: public ObjectiveFunction
 {
 	public:
-		int size1;
-		int size2;
-		double *values;
-		double *refValues1;
-		double *refValues2;
-		
+		int size1; /** \brief Number of elements in the first dimension */
+		int size2; /** \brief Number of elements in the second dimension */
+		double *values; /** \brief Observed values (index i + size1 * j) */
+		double *refValues1; /** \brief Reference values of the first dimension */
+		double *refValues2; /** \brief Reference values of the second dimension */
+		bool marginals; /** \brief True if the reference values are the marginals of the observed values (computed by computeObjectiveValues()) */
+		double *microInfos; /** \brief Microscopic information of all elements (index i + size1 * j, computed by computeObjectiveValues() from the separable reference) */
+		double gainFactor; /** \brief Size reduction of the whole set, by which gains are divided (see normalizeObjectiveValues) */
+		double lossFactor; /** \brief Divergence of the whole set, by which losses are divided (see normalizeObjectiveValues) */
+
+		/*!
+		 * \brief Constructor
+		 * \param size1 : Number of elements in the first dimension
+		 * \param size2 : Number of elements in the second dimension
+		 * \param values : Observed values (index i + size1 * j)
+		 * \param refValues1 : (Optional) Reference values of the first dimension (if not specified, both reference values are the marginals of the observed values)
+		 * \param refValues2 : (Optional) Reference values of the second dimension (if not specified, both reference values are the marginals of the observed values)
+		 */
 		BidimensionalRelativeEntropy (int size1, int size2, double *values = 0, double *refValues1 = 0, double *refValues2 = 0);
 		~BidimensionalRelativeEntropy ();
 		
 		void setRandom ();
 		ObjectiveValue *newObjectiveValue (int index = -1);
+		void computeObjectiveValues ();
+		void normalizeObjectiveValues (ObjectiveValue *q);
+		void printObjectiveValues (bool verbose = true);
 
 		double getParameter (double unit);
 		double getUnitDistance (double uMin, double uMax);
@@ -66,9 +84,13 @@ class BidimensionalRelativeObjectiveValue: public ObjectiveValue
 {
 	public:
 		int index;
+		int first1; /** \brief Smallest index of the part in the first dimension (used to find along which dimension parts are aggregated) */
+		int first2; /** \brief Smallest index of the part in the second dimension */
 		
 		double sumValue;
-		double sumRefValue;
+		double sumRefValue1; /** \brief Sum of the reference values of the part in the first dimension */
+		double sumRefValue2; /** \brief Sum of the reference values of the part in the second dimension */
+		double sumRefValue; /** \brief Total reference value: sumRefValue1 * sumRefValue2 for a feasible part, sum over the parts for a partition (see add) */
 		double microInfo;
 		double divergence;
 		double sizeReduction;
@@ -76,14 +98,17 @@ class BidimensionalRelativeObjectiveValue: public ObjectiveValue
 		BidimensionalRelativeObjectiveValue (BidimensionalRelativeEntropy *objective, int index = -1);
 		~BidimensionalRelativeObjectiveValue ();
 		
+		bool equal (ObjectiveValue *value, int prec = 15);
 		void add (ObjectiveValue *value);
 		void compute ();
 		void compute (ObjectiveValue *value1, ObjectiveValue *value2);
 		void compute (ObjectiveValueSet *valueset);
-		void normalize (ObjectiveValue *q);
 		void print (bool verbose = true);
 		double getValue (double param);
+
+	private:
+		void computeDivergence ();
 };
 
-*/
+
 #endif
@@ -35,353 +35,385 @@
  */
 
 
-
 #include <iostream>
 #include <algorithm>
+#include <limits>
+#include <cmath>
 
 #include "check_graph_datatree.hpp"
+#include "parallel_tools.hpp"
 
 
-bool checkParts (Graph *graph)
-{
-	std::cout << "CHECK PARTS";
-	bool error = false;
-
-	PartSet *mySet = graph->getParts();
+typedef unsigned int SubsetMask;
 
-	PartSet *set = new PartSet();
-	Part *part = new Part();
-	addRecVertex (set, part, 0, graph->size);
 
-	for (PartSet::iterator it = set->begin(); it != set->end(); )
+void printSubset (SubsetMask subset)
+{
+	std::cout << "{";
+	bool first = true;
+	for (int v = 0; subset >> v != 0; v++)
 	{
-		Vertices *v = (*it)->getVertices();
-		if (!graph->isConnected(v)) {
-			PartSet::iterator itBis = it;
-			itBis++;
-			delete *it;
-			set->erase(it);
-			it = itBis;
-		} else { ++it; }
-		delete v;
+		if (((subset >> v) & 1) == 0) { continue; }
+		if (!first) { std::cout << ","; }
+		std::cout << v;
+		first = false;
 	}
+	std::cout << "}";
+}
 
-/*
-	std::cout << "COUNTING REAL PARTS:" << std::endl;
-	for (PartSet::iterator it = set->begin(); it != set->end(); ++it) { (*it)->print(); std::cout << std::endl; }
-	std::cout << "-> " << set->size() << " PARTS\n" << std::endl;
 
-	std::cout << "COUNTING OUR PARTS:" << std::endl;
-	for (PartSet::iterator it = mySet->begin(); it != mySet->end(); ++it) { (*it)->print(); std::cout << std::endl; }
-	std::cout << "-> " << mySet->size() << " PARTS\n" << std::endl;
-*/
+bool checkSize (Graph *graph)
+{
+	if (graph->size <= CHECK_MAX_SIZE) { return true; }
+	std::cout << " -> ERROR: CANNOT CHECK GRAPHS OF MORE THAN " << CHECK_MAX_SIZE << " VERTICES" << std::endl;
+	return false;
+}
 
-	for (PartSet::iterator it1 = set->begin(); it1 != set->end(); ++it1)
-	{
-		Part *part = *it1;
 
-		bool found = false;
-		for (PartSet::iterator it2 = mySet->begin(); it2 != mySet->end() && !found; ++it2)
+std::vector<char> getConnectedSubsets (Graph *graph)
+{
+	int n = graph->size;
+	std::vector<SubsetMask> adjacency (n,0);
+	for (int v = 0; v < n; v++)
+		for (int w = graph->adjacencySets[v].next(); w != -1; w = graph->adjacencySets[v].next(w+1)) { adjacency[v] |= 1u << w; }
+
+	SubsetMask subsetNb = 1u << n;
+	std::vector<char> connected (subsetNb,0);
+
+	int chunkNb = (subsetNb < 1024) ? 1 : 256;
+	SubsetMask chunkSize = subsetNb / chunkNb;
+	parallelFor(chunkNb, [&] (int c)
+	{
+		for (SubsetMask subset = std::max(c * chunkSize,1u); subset < (c+1) * chunkSize; subset++)
 		{
-			Part *myPart = *it2;
-			found = part->equal(myPart);
+			// Grow the set of vertices reachable from the first one within the subset
+			SubsetMask reached = subset & -subset;
+			SubsetMask frontier = reached;
+			while (frontier != 0)
+			{
+				SubsetMask next = 0;
+				for (SubsetMask f = frontier; f != 0; f &= f-1) { next |= adjacency[__builtin_ctz(f)]; }
+				frontier = next & subset & ~reached;
+				reached |= frontier;
+			}
+			connected[subset] = (reached == subset);
 		}
-		
-		if (!found)
-		{
-			std::cout << " -> ERROR: PART ";
-			part->print();
-			std::cout << " NOT FOUND" << std::endl;
-			error = true;
-		}	
-	}
+	});
 
-	for (PartSet::iterator it1 = mySet->begin(); it1 != mySet->end(); ++it1)
-	{
-		Part *myPart = *it1;
+	return connected;
+}
+
+
+/*!
+ * \brief Depth-first enumeration of the restricted growth strings extending a given prefix, each block of the partition being maintained as a bitmask
+ */
+struct RestrictedGrowthEnumerator
+{
+	int size;
+	const char *connected;
+	const double *scores;
 
-		bool found = false;
-		for (PartSet::iterator it2 = set->begin(); it2 != set->end() && !found; ++it2)
+	SubsetMask blocks [CHECK_MAX_SIZE];
+	long long connectedNb;
+	double bestScore;
+
+	void enumerate (int element, int blockNb)
+	{
+		if (element == size)
 		{
-			Part *part = *it2;
-			found = myPart->equal(part);
+			for (int b = 0; b < blockNb; b++) { if (!connected[blocks[b]]) { return; } }
+			connectedNb++;
+
+			if (scores != 0)
+			{
+				double score = 0;
+				for (int b = 0; b < blockNb; b++) { score += scores[blocks[b]]; }
+				if (score > bestScore) { bestScore = score; }
+			}
+			return;
 		}
-		
-		if (!found)
-		{
-			std::cout << " -> ERROR: PART ";
-			myPart->print();
-			std::cout << " SHOULD NOT BE THERE" << std::endl;
-			error = true;
-		}	
-	}
-	
-	for (PartSet::iterator it1 = mySet->begin(); it1 != mySet->end(); ++it1)
-	{
-		Part *myPart1 = *it1;
 
-		int foundNb = 0;
-		for (PartSet::iterator it2 = mySet->begin(); it2 != mySet->end(); ++it2)
+		// The element goes either in one of the current blocks or in a new one
+		SubsetMask bit = 1u << element;
+		for (int b = 0; b <= blockNb; b++)
 		{
-			Part *myPart2 = *it2;
-			if (myPart1->equal(myPart2)) { foundNb++; }
+			blocks[b] |= bit;
+			enumerate(element+1, (b == blockNb) ? blockNb+1 : blockNb);
+			blocks[b] ^= bit;
 		}
-		
-		if (foundNb > 1)
-		{
-			std::cout << " -> ERROR: PART ";
-			myPart1->print();
-			std::cout << " FOUND " << foundNb << " TIMES" << std::endl;
-			error = true;
-		}	
 	}
+};
+
 
-	if (set->size() != mySet->size())
+void addPrefixes (std::vector<int> &prefixes, std::vector<int> &prefix, int element, int blockNb)
+{
+	if (element == (int) prefix.size())
 	{
-		std::cout << " -> ERROR: " << mySet->size() << " PARTS INSTEAD OF " << set->size() << std::endl;
-		error = true;
+		prefixes.insert(prefixes.end(),prefix.begin(),prefix.end());
+		return;
 	}
-	
-	if (!error)
+
+	for (int b = 0; b <= blockNb; b++)
 	{
-		std::cout << " -> ALL " << set->size() << " PARTS HAVE BEEN FOUND" << std::endl;
+		prefix[element] = b;
+		addPrefixes(prefixes, prefix, element+1, (b == blockNb) ? blockNb+1 : blockNb);
 	}
-	
-	delete set;
-	delete mySet;
-	
-	return error;
 }
 
 
-void checkPartitions (Graph *graph)
+long long countConnectedPartitions (int size, const std::vector<char> &connected, const std::vector<double> *scores, double *bestScore)
 {
-	std::cout << "CHECK PARTITIONS" << std::endl;
-	bool error = false;
-	
-	VerticesSetsSet *set = new VerticesSetsSet();
+	if (size == 0) { return 0; }
 
-	int s[16]; /* s[i] is the number of the set in which the ith element should go */
-	int m[16]; /* m[i] is the largest of the first i elements in s */
- 
-	int n = graph->size;
-	int i;
+	// The first elements of the restricted growth strings are fixed for each task (Bell(7) = 877 tasks)
+	int prefixSize = std::min(size,7);
+	std::vector<int> prefix (prefixSize);
+	std::vector<int> prefixes;
+	addPrefixes(prefixes, prefix, 0, 0);
 
-	for (i = 0; i < n; ++i) /* The first way to partition a set is to put all the elements in the same subset. */
-	{
-		s[i] = 1;
-		m[i] = 1;
-	}
- 
-	set->insert(getPartition(s,n));
-	while (next(s,m,n)) { set->insert(getPartition(s,n)); }
+	int taskNb = prefixes.size() / prefixSize;
+	std::vector<long long> counts (taskNb);
+	std::vector<double> bestScores (taskNb);
 
-	for (VerticesSetsSet::iterator it1 = set->begin(); it1 != set->end(); )
+	parallelFor(taskNb, [&] (int t)
 	{
-		bool connected = true;
-		VerticesSet *vSet = *it1;
-		
-		for (VerticesSet::iterator it2 = vSet->begin(); it2 != vSet->end(); ++it2)
+		RestrictedGrowthEnumerator e;
+		e.size = size;
+		e.connected = &connected[0];
+		e.scores = (scores != 0) ? &(*scores)[0] : 0;
+		e.connectedNb = 0;
+		e.bestScore = -std::numeric_limits<double>::infinity();
+
+		int blockNb = 0;
+		for (int b = 0; b < size; b++) { e.blocks[b] = 0; }
+		for (int i = 0; i < prefixSize; i++)
 		{
-			if (!graph->isConnected(*it2)) { connected = false; }	
+			int b = prefixes[t * prefixSize + i];
+			e.blocks[b] |= 1u << i;
+			if (b == blockNb) { blockNb++; }
 		}
-		
-		if (!connected)
-		{
-			for (VerticesSet::iterator it2 = vSet->begin(); it2 != vSet->end(); ++it2) { delete *it2; }
-			delete *it1;
-			set->erase(it1++);
-		} else { ++it1; }
-	}
-	
-	int partitionsNb = graph->printPartitions(false);
-	if ((int) set->size() != partitionsNb)
+
+		e.enumerate(prefixSize, blockNb);
+		counts[t] = e.connectedNb;
+		bestScores[t] = e.bestScore;
+	});
+
+	long long connectedNb = 0;
+	if (bestScore != 0) { *bestScore = -std::numeric_limits<double>::infinity(); }
+	for (int t = 0; t < taskNb; t++)
 	{
-		std::cout << "ERROR: " << partitionsNb << " PARTITIONS INSTEAD OF " << set->size() << std::endl;
-		error = true;
+		connectedNb += counts[t];
+		if (bestScore != 0 && bestScores[t] > *bestScore) { *bestScore = bestScores[t]; }
 	}
-	
-	/*
-	for (VerticesSetsSet::iterator it = set->begin(); it != set->end(); ++it)
-	{
-		VerticesSet *p = *it;
-	}*/
-	
-	if (!error)
+	return connectedNb;
+}
+
+
+/*!
+ * \brief Compare a list of subsets with the connected subsets, print the differences, and return true if there are some
+ */
+bool compareSubsets (const std::vector<SubsetMask> &subsets, const std::vector<char> &connected, std::string name)
+{
+	bool error = false;
+	std::vector<char> found (connected.size(),0);
+
+	for (unsigned int s = 0; s < subsets.size(); s++)
 	{
-		std::cout << "-> ALL " << partitionsNb << " PARTITIONS HAVE BEEN FOUND" << std::endl;
+		SubsetMask subset = subsets[s];
+		if (!connected[subset] || found[subset])
+		{
+			std::cout << " -> ERROR: " << name << " ";
+			printSubset(subset);
+			std::cout << (connected[subset] ? " FOUND TWICE" : " SHOULD NOT BE THERE") << std::endl;
+			error = true;
+		}
+		found[subset] = 1;
 	}
-	std::cout << std::endl;
 
-	for (VerticesSetsSet::iterator it1 = set->begin(); it1 != set->end(); ++it1)
+	int connectedNb = 0;
+	for (SubsetMask subset = 1; subset < connected.size(); subset++)
 	{
-		VerticesSet *vSet = *it1;
-		for (VerticesSet::iterator it2 = vSet->begin(); it2 != vSet->end(); ++it2)
+		if (!connected[subset]) { continue; }
+		connectedNb++;
+		if (!found[subset])
 		{
-			delete *it2;
+			std::cout << " -> ERROR: " << name << " ";
+			printSubset(subset);
+			std::cout << " NOT FOUND" << std::endl;
+			error = true;
 		}
-		delete *it1;
 	}
-	delete set;
-}
 
+	if (!error) { std::cout << " -> ALL " << connectedNb << " " << name << "S HAVE BEEN FOUND" << std::endl; }
+	return error;
+}
 
 
-void addRecVertex(PartSet *set, Part *part, int vMin, int vMax)
+bool checkParts (Graph *graph)
 {
-	for (int v = vMin; v < vMax; v++)
+	std::cout << "CHECK PARTS";
+	if (!checkSize(graph)) { return true; }
+
+	std::vector<SubsetMask> subsets;
+	PartSet *set = graph->getParts();
+	for (PartSet::iterator it = set->begin(); it != set->end(); ++it)
 	{
-		Part *newPart = new Part(part);
-		newPart->addIndividual(v);
-		set->insert(newPart);
-		
-		addRecVertex(set, newPart, v+1, vMax);
+		SubsetMask subset = 0;
+		for (std::list<int>::iterator it2 = (*it)->individuals->begin(); it2 != (*it)->individuals->end(); ++it2) { subset |= 1u << *it2; }
+		subsets.push_back(subset);
+		delete *it;
 	}
-}
-
+	delete set;
 
+	return compareSubsets(subsets, getConnectedSubsets(graph), "PART");
+}
 
 
-VerticesSet *getPartition(int *s, int n) {
-	VerticesSet *set = new VerticesSet();
-	/* Get the total number of partitions. In the exemple above, 2.*/
-	int part_num = 1;
-	int i;
-	for (i = 0; i < n; ++i)
-		if (s[i] > part_num)
-			part_num = s[i];
- 
-	/* Print the p partitions. */
-	int p;
-	for (p = part_num; p >= 1; --p) {
-		/* If s[i] == p, then i + 1 is part of the pth partition. */
-		Vertices *V = new Vertices();
-		for (i = 0; i < n; ++i) {
-			if (s[i] == p) {
-				V->insert(i);
-			}
+/*!
+ * \brief Return the subsets enumerated by the ConnectedSubsetIterator of each component of the graph
+ */
+std::vector<SubsetMask> getIteratedSubsets (Graph *graph)
+{
+	std::vector<SubsetMask> subsets;
+	for (GraphComponentSet::iterator it = graph->graphComponentSet->begin(); it != graph->graphComponentSet->end(); ++it)
+	{
+		ConnectedSubsetIterator *subsetIt = (*it)->getConnectedSubsets();
+		while (subsetIt->next())
+		{
+			VertexSet *subset = subsetIt->getSubset();
+			SubsetMask mask = 0;
+			for (int v = subset->next(); v != -1; v = subset->next(v+1)) { mask |= 1u << v; }
+			subsets.push_back(mask);
 		}
-		set->insert(V);
+		delete subsetIt;
 	}
-	return set;
+	return subsets;
 }
 
 
- 
-/*
-	next
-		- given the partitioning scheme represented by s and m, generate
-		the next
- 
-	Returns: 1, if a valid partitioning was found
-		0, otherwise
-*/
-int next(int *s, int *m, int n) {
-	/* Update s: 1 1 1 1 -> 2 1 1 1 -> 1 2 1 1 -> 2 2 1 1 -> 3 2 1 1 ->
-	1 1 2 1 ... */
-	/*int j;
-	printf(" -> (");
-	for (j = 0; j &lt; n; ++j)
-		printf("%d, ", s[j]);
-	printf("\\b\\b)\\n");*/
-	int i = 0;
-	++s[i];
-	while ((i < n - 1) && (s[i] > m[i] + 1)) {
-		s[i] = 1;
-		++i;
-		++s[i];
-	}
- 
-	/* If i is has reached n-1 th element, then the last unique partitiong
-	has been found*/
-	if (i == n - 1)
-		return 0;
- 
-	/* Because all the first i elements are now 1, s[i] (i + 1 th element)
-	is the largest. So we update max by copying it to all the first i
-	positions in m.*/
-	int max = s[i];
-	if (m[i] > max) max = m[i];
-	for (i = i - 1; i >= 0; --i)
-		m[i] = max;
- 
-/*  for (i = 0; i &lt; n; ++i)
-		printf("%d ", m[i]);
-	getchar();*/
-	return 1;
+bool checkConnectedSubsets (Graph *graph)
+{
+	std::cout << "CHECK CONNECTED SUBSETS";
+	if (!checkSize(graph)) { return true; }
+
+	return compareSubsets(getIteratedSubsets(graph), getConnectedSubsets(graph), "SUBSET");
 }
- 
-/*
-VerticesSetsSet *getAllPartitions (Tree *tree)
+
+
+bool checkPartitions (Graph *graph)
 {
-	VerticesSetsSet *set = new VerticesSetsSet();
-	
-	std::list<Tree*> *treeList = new std::list<Tree*>();
-	std::list<VerticesSet*> *setList = new std::list<VerticesSet*>();
-
-	treeList->push_back(tree->parent);
-	strList->push_back(new VerticesSet());
-	
-	while (!treeList->empty())
+	std::cout << "CHECK PARTITIONS";
+	if (!checkSize(graph)) { return true; }
+
+	int n = graph->size;
+	long long bruteForceNb = countConnectedPartitions(n, getConnectedSubsets(graph));
+
+	// Partitions of a subset: choose the part containing its first vertex among the iterated subsets, then partition the rest
+	std::vector<std::vector<SubsetMask>> subsetsByFirst (n);
+	std::vector<SubsetMask> subsets = getIteratedSubsets(graph);
+	for (unsigned int s = 0; s < subsets.size(); s++) { subsetsByFirst[__builtin_ctz(subsets[s])].push_back(subsets[s]); }
+
+	std::vector<long long> partitionNbs (1u << n,0);
+	partitionNbs[0] = 1;
+	for (SubsetMask subset = 1; subset < partitionNbs.size(); subset++)
 	{
-		Tree *node = treeList->front();
-		treeList->pop_front();
+		std::vector<SubsetMask> &parts = subsetsByFirst[__builtin_ctz(subset)];
+		for (unsigned int p = 0; p < parts.size(); p++)
+			if ((parts[p] & ~subset) == 0) { partitionNbs[subset] += partitionNbs[subset ^ parts[p]]; }
+	}
+	long long partitionNb = (n == 0) ? 0 : partitionNbs.back();
 
-		VerticesSet *set = setList->front();
-		setList->pop_front();
+	if (partitionNb != bruteForceNb)
+	{
+		std::cout << " -> ERROR: " << partitionNb << " PARTITIONS INSTEAD OF " << bruteForceNb << std::endl;
+		return true;
+	}
 
-		for (PartitionsSet::iterator it = node->partitions->begin(); it != node->partitions->end(); ++it)
-		{
-			Partition *p = *it;
-			
-			VerticesSet *nextSet1 = new VerticesSet();
-			VerticesSet *nextSet2 = new VerticesSet();
-			
-			for (VerticesSet::iterator it2 = set->begin(); it2 != set->end(); it2++) {
-				Vertices *V = *it2;
-
-				Vertices *nextV1 = new Vertices();				
-				Vertices *nextV2 = new Vertices();
-						
-				for (Vertices::iterator it3 = V->begin(); it3 != V->end(); it3++)
-				{
-					nextV1->insert(*it3);
-					nextV2->insert(*it3);
-				}
-				
-				nextSet1->insert(nextV1);
-				nextSet2->insert(nextV2);
-			}
-			
-			if (print)
-			{
-				std::cout << "{";
-				p->first->printVertices(false);
-				if (p->second != 0)
-				{
-					std::cout << ",";
-					p->second->printVertices(false);
-					nextStr1 = std::string(",") + p->second->toString() + str;
-				}
-				std::cout << str << "}" << std::endl;
-			}
-			partitionsNb++;
+	std::cout << " -> ALL " << bruteForceNb << " PARTITIONS HAVE BEEN FOUND" << std::endl;
+	return false;
+}
 
-			treeList->push_back(p->first);
-			strList->push_back(nextStr1);
-			
-			if (p->second != 0)
-			{
-				nextStr2 = std::string(",") + p->first->toString() + str;
-				treeList->push_back(p->second);
-				strList->push_back(nextStr2);
-			}
-		}
+
+bool checkOptimalPartition (Graph *graph, ObjectiveFunction *objective, double parameter)
+{
+	std::cout << "CHECK OPTIMAL PARTITION";
+	if (!checkSize(graph)) { return true; }
+
+	int n = graph->size;
+	Graph *exactGraph = new Graph (n);
+	for (int v = 0; v < n; v++) { exactGraph->adjacencySets[v] = graph->adjacencySets[v]; }
+	exactGraph->setApproximation(n);
+	exactGraph->buildDataStructure();
+	exactGraph->setObjectiveFunction(objective);
+	exactGraph->computeObjectiveValues();
+	exactGraph->normalizeObjectiveValues();
+	delete exactGraph->getOptimalPartition(parameter);
+
+	bool exact = true;
+	for (GraphComponentSet::iterator it = exactGraph->graphComponentSet->begin(); it != exactGraph->graphComponentSet->end(); ++it) { exact = exact && (*it)->restrictedExact; }
+
+	// Objective values of all subsets, each one from its first vertex and the rest of the subset
+	double sign = objective->maximize ? 1 : -1;
+	SubsetMask subsetNb = 1u << n;
+	std::vector<ObjectiveValue*> values (subsetNb,0);
+	std::vector<double> scores (subsetNb,0);
+	for (SubsetMask subset = 1; subset < subsetNb; subset++)
+	{
+		int first = __builtin_ctz(subset);
+		SubsetMask rest = subset ^ (1u << first);
+		if (rest == 0) { values[subset] = objective->newObjectiveValue(first); values[subset]->compute(); }
+		else { values[subset] = objective->newObjectiveValue(); values[subset]->compute(values[1u << first],values[rest]); }
+	}
+	for (SubsetMask subset = 1; subset < subsetNb; subset++) { scores[subset] = sign * values[subset]->getValue(parameter); }
+	for (SubsetMask subset = 1; subset < subsetNb; subset++) { delete values[subset]; }
+
+	std::vector<char> connected = getConnectedSubsets(graph);
+	double bestScore;
+	countConnectedPartitions(n, connected, &scores, &bestScore);
+	double bestValue = sign * bestScore;
+	double value = exactGraph->approximateValue;
+	delete exactGraph;
+
+	// The partition read from the datatree of all connected subsets must be a partition into connected parts
+	Graph *treeGraph = new Graph (n);
+	for (int v = 0; v < n; v++) { treeGraph->adjacencySets[v] = graph->adjacencySets[v]; }
+	treeGraph->slyceBuilder = graph->slyceBuilder;
+	treeGraph->buildDataStructure();
+	treeGraph->setObjectiveFunction(objective);
+	treeGraph->computeObjectiveValues();
+	treeGraph->normalizeObjectiveValues();
+	Partition *partition = treeGraph->getOptimalPartition(parameter);
+
+	bool valid = true;
+	double treeValue = 0;
+	SubsetMask covered = 0;
+	for (std::list<Part*>::iterator it = partition->parts->begin(); it != partition->parts->end(); ++it)
+	{
+		SubsetMask part = 0;
+		for (std::list<int>::iterator it2 = (*it)->individuals->begin(); it2 != (*it)->individuals->end(); ++it2) { part |= 1u << *it2; }
+		valid = valid && part != 0 && (part & covered) == 0 && connected[part];
+		covered |= part;
+		treeValue += (*it)->value->getValue(parameter);
+	}
+	valid = valid && covered == subsetNb-1;
+	delete partition;
+	delete treeGraph;
+
+	// The engine can only be worse than brute force if it has not solved all components exactly
+	double precision = 1e-9 * std::max(1.,std::fabs(bestValue));
+	bool error = exact ? std::fabs(value - bestValue) > precision : sign * (value - bestValue) > precision;
+	if (error)
+	{
+		std::cout << " -> ERROR: VALUE " << value << " INSTEAD OF " << bestValue << std::endl;
+		return true;
 	}
 
-	delete treeList;
-	delete strList;
-	if (print) { std::cout << "-> " << partitionsNb << " PARTITIONS\n" << std::endl; }
+	if (!valid || std::fabs(treeValue - bestValue) > precision)
+	{
+		std::cout << " -> ERROR: THE DATATREE GIVES " << (valid ? "VALUE " + std::to_string(treeValue) : "AN INVALID PARTITION") << " INSTEAD OF " << bestValue << std::endl;
+		return true;
+	}
 
-	return partitionsNb;
-}*/
+	std::cout << " -> BEST VALUE " << bestValue << (exact ? " HAS BEEN FOUND" : " IS NOT EXCEEDED") << std::endl;
+	return false;
+}
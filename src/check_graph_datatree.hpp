@@ -38,21 +38,58 @@
 #ifndef INCLUDE_CHECK_GRAPH_DATATREE
 #define INCLUDE_CHECK_GRAPH_DATATREE
 
-#include <set>
-#include "graph.hpp"
+/*!
+ * \file check_graph_datatree.hpp
+ * \brief Brute-force verification of the graph engines: subsets and partitions of the vertices are enumerated exhaustively (as bitmasks and restricted growth strings split across threads) and compared with the optimised enumerators
+ * \author Robin Lamarche-Perrin
+ * \date 06/11/2015
+ */
 
-typedef std::set<int> Vertices;
-typedef std::set<Vertices*> VerticesSet;
-typedef std::set<VerticesSet*> VerticesSetsSet;
+#include <vector>
+#include "graph.hpp"
 
 class Graph;
 
-bool checkOrder (Graph *graph);
+/*!
+ * \brief Maximal number of vertices of the verified graphs (tables over all subsets of vertices are built)
+ */
+const int CHECK_MAX_SIZE = 24;
+
+/*!
+ * \brief Check that the datatree of the graph contains exactly the connected subsets of vertices (each one once)
+ * \return true if an error has been found
+ */
 bool checkParts (Graph *graph);
-void checkPartitions (Graph *graph);
 
-void addRecVertex(PartSet *set, Part *part, int vMin, int vMax);
-VerticesSet *getPartition(int *s, int n);
-int next(int *s, int *m, int n);
+/*!
+ * \brief Check that ConnectedSubsetIterator enumerates exactly the connected subsets of vertices (each one once)
+ * \return true if an error has been found
+ */
+bool checkConnectedSubsets (Graph *graph);
+
+/*!
+ * \brief Check that the number of partitions into connected parts, obtained by enumerating all partitions, equals the one obtained by combining the subsets given by ConnectedSubsetIterator
+ * \return true if an error has been found
+ */
+bool checkPartitions (Graph *graph);
+
+/*!
+ * \brief Check that the best partition into connected parts, obtained by enumerating all partitions, has the same objective value as the ones computed by Graph in approximation mode (with unbounded parts) and in exact mode (from the datatree, whose partition must also be made of disjoint connected parts covering all vertices)
+ * \return true if an error has been found
+ */
+bool checkOptimalPartition (Graph *graph, ObjectiveFunction *objective, double parameter);
+
+/*!
+ * \brief Return, for each subset of vertices (as a bitmask), whether it induces a connected subgraph (the empty set is not connected)
+ */
+std::vector<char> getConnectedSubsets (Graph *graph);
+
+/*!
+ * \brief Enumerate all partitions of the vertices by restricted growth strings, on several threads, without allocation once the prefixes have been dispatched
+ * \param connected : The table returned by getConnectedSubsets
+ * \param scores : If not null, the score of each subset (bitmask), so that the best sum of scores of a partition into connected parts is returned in bestScore
+ * \return the number of partitions into connected parts
+ */
+long long countConnectedPartitions (int size, const std::vector<char> &connected, const std::vector<double> *scores = 0, double *bestScore = 0);
 
 #endif
@@ -43,6 +43,7 @@
 
 #include "csv_tools.hpp"
 #include "dataset.hpp"
+#include "graph_loader.hpp"
 
 Dataset *getDatasetFromCSV (std::string inputFileName, std::string labelsFileName1, std::string labelsFileName2,
 	bool refValues, bool margeValues) {
@@ -165,21 +166,16 @@ void fillDatasetFromCSV (Dataset *data, std::string dataFileName, std::string sp
 	}
 	closeInputCSV(dataFile);
 }
+*/
+
 
 void buildGraphFromCSV (Graph *graph, Dataset *data, std::string graphFileName)
 {
-	CSVLine line;
-
-	std::ifstream graphFile;
-	openInputCSV(graphFile,graphFileName);
-	while (hasCSVLine(graphFile))
-	{
-		getCSVLine(graphFile,line,2);
-		graph->addEdge((*data->spaceIndexes)[line[0]],(*data->spaceIndexes)[line[1]]);
-	}
-	closeInputCSV(graphFile);
+	AdjacencyList *list = loadEdgeList(graphFileName,data->labels1,false);
+	if (list == 0) { return; }
+	list->addToGraph(graph);
+	delete list;
 }
-*/
 
 
 /*
@@ -44,19 +44,13 @@ Dataset::Dataset ()
 	size1 = 0;
 	size2 = 0;
 	
-	indices1 = new std::map<std::string,int>();
-	indices2 = new std::map<std::string,int>();
-	
-	labels1 = new std::map<int,std::string>();
-	labels2 = new std::map<int,std::string>();
+	labels1 = new InternTable();
+	labels2 = new InternTable();
 }
 
 
 Dataset::~Dataset ()
 {
-	delete indices1;
-	delete indices2;
-	
 	delete labels1;
 	delete labels2;
 	
@@ -88,41 +82,39 @@ void Dataset::initRefValues (double v)
 
 void Dataset::addLabel1 (std::string str)
 {
-	labels1->insert(std::pair<int,std::string>(size1,str));
-	indices1->insert(std::pair<std::string,int>(str,size1));
+	labels1->add(str);
 	size1++;
 }
 
 void Dataset::addLabel2 (std::string str)
 {
-	labels2->insert(std::pair<int,std::string>(size2,str));
-	indices2->insert(std::pair<std::string,int>(str,size2));
+	labels2->add(str);
 	size2++;
 }
 
-std::string Dataset::getLabel1 (int i) { return labels1->at(i); }
-std::string Dataset::getLabel2 (int j) { return labels2->at(j); }
+std::string Dataset::getLabel1 (int i) { return labels1->getLabel(i); }
+std::string Dataset::getLabel2 (int j) { return labels2->getLabel(j); }
 
-int Dataset::getIndex1 (std::string s1) { return indices1->at(s1); }
-int Dataset::getIndex2 (std::string s2) { return indices2->at(s2); }
+int Dataset::getIndex1 (std::string s1) { return labels1->at(s1); }
+int Dataset::getIndex2 (std::string s2) { return labels2->at(s2); }
 
 double Dataset::getValue (int i, int j) { return values[i+j*size1]; }
 double Dataset::getRefValue (int i, int j) { return refValues[i+j*size1]; }
 
-double Dataset::getValue (std::string s1, std::string s2) { return values[indices1->at(s1)+indices2->at(s2)*size1]; }
-double Dataset::getRefValue (std::string s1, std::string s2) { return refValues[indices1->at(s1)+indices2->at(s2)*size1]; }
+double Dataset::getValue (std::string s1, std::string s2) { return values[labels1->at(s1)+labels2->at(s2)*size1]; }
+double Dataset::getRefValue (std::string s1, std::string s2) { return refValues[labels1->at(s1)+labels2->at(s2)*size1]; }
 
 void Dataset::setValue (int i, int j, double v) { values[i+j*size1] = v; }
 void Dataset::setRefValue (int i, int j, double v) { refValues[i+j*size1] = v; }
 
-void Dataset::setValue (std::string s1, std::string s2, double v) { values[indices1->at(s1)+indices2->at(s2)*size1] = v; }
-void Dataset::setRefValue (std::string s1, std::string s2, double v) { refValues[indices1->at(s1)+indices2->at(s2)*size1] = v; }
+void Dataset::setValue (std::string s1, std::string s2, double v) { values[labels1->at(s1)+labels2->at(s2)*size1] = v; }
+void Dataset::setRefValue (std::string s1, std::string s2, double v) { refValues[labels1->at(s1)+labels2->at(s2)*size1] = v; }
 
 void Dataset::incrementValue (int i, int j) { values[i+j*size1] = values[i+j*size1] + 1; }
 void Dataset::incrementRefValue (int i, int j) { refValues[i+j*size1] = refValues[i+j*size1] + 1; }
 
-void Dataset::incrementValue (std::string s1, std::string s2) { values[indices1->at(s1)+indices2->at(s2)*size1] = values[indices1->at(s1)+indices2->at(s2)*size1] + 1; }
-void Dataset::incrementRefValue (std::string s1, std::string s2) { refValues[indices1->at(s1)+indices2->at(s2)*size1] = refValues[indices1->at(s1)+indices2->at(s2)*size1] + 1; }
+void Dataset::incrementValue (std::string s1, std::string s2) { values[labels1->at(s1)+labels2->at(s2)*size1] = values[labels1->at(s1)+labels2->at(s2)*size1] + 1; }
+void Dataset::incrementRefValue (std::string s1, std::string s2) { refValues[labels1->at(s1)+labels2->at(s2)*size1] = refValues[labels1->at(s1)+labels2->at(s2)*size1] + 1; }
 
 
 double *Dataset::getValues1 (std::string s2)
@@ -162,8 +154,8 @@ void Dataset::print()
 	std::cout << "SIZE 1 = " << size1 << std::endl;
 	if (size1 > 0)
 	{
-		std::cout << "-> " << (*labels1)[0];
-		for (int i = 1; i < size1; i++) { std::cout << ", " << (*labels1)[i]; }
+		std::cout << "-> " << labels1->getLabel(0);
+		for (int i = 1; i < size1; i++) { std::cout << ", " << labels1->getLabel(i); }
 		std::cout << std::endl;
 	}
 	std::cout << std::endl;
@@ -171,8 +163,8 @@ void Dataset::print()
 	std::cout << "SIZE 2 = " << size2 << std::endl;
 	if (size2 > 0)
 	{
-		std::cout << "-> " << (*labels2)[0];
-		for (int j = 1; j < size2; j++) { std::cout << ", " << (*labels2)[j]; }
+		std::cout << "-> " << labels2->getLabel(0);
+		for (int j = 1; j < size2; j++) { std::cout << ", " << labels2->getLabel(j); }
 		std::cout << std::endl;
 	}
 	std::cout << std::endl;
@@ -39,18 +39,16 @@
 #define INCLUDE_DATASET
 
 #include <string>
-#include <map>
+
+#include "intern_table.hpp"
 
 class Dataset {
 	public:
 		int size1;
 		int size2;
 	
-		std::map<std::string,int> *indices1;
-		std::map<std::string,int> *indices2;
-
-		std::map<int,std::string> *labels1;
-		std::map<int,std::string> *labels2;
+		InternTable *labels1;
+		InternTable *labels2;
 
 		double *values;
 		double *refValues;
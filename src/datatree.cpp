@@ -38,9 +38,13 @@
 
 #include <math.h>
 #include <list>
+#include <vector>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 #include "datatree.hpp"
 
@@ -58,7 +62,16 @@ Datatree::Datatree (int v)
 	bipartitions = new BipartitionsSet();
 	value = 0;
 
-	optimized = false;
+	index = -1;
+	flatSize = 0;
+	optimizedSize = 0;
+	flatNodes = 0;
+	bipartitionOffsets = 0;
+	optimalValues = 0;
+	optimalBipartitions = 0;
+	levelNumber = 0;
+	levelOffsets = 0;
+	spillFile = -1;
 	wholeSet = false;
 }
 
@@ -75,7 +88,16 @@ Datatree::Datatree (Datatree &tree)
 	bipartitions = new BipartitionsSet();
 	value = 0;
 
-	optimized = false;
+	index = -1;
+	flatSize = 0;
+	optimizedSize = 0;
+	flatNodes = 0;
+	bipartitionOffsets = 0;
+	optimalValues = 0;
+	optimalBipartitions = 0;
+	levelNumber = 0;
+	levelOffsets = 0;
+	spillFile = -1;
 	wholeSet = false;
 	
 	for (TreesSet::iterator it = tree.children->begin(); it != tree.children->end(); ++it)
@@ -88,7 +110,7 @@ Datatree::Datatree (Datatree &tree)
 
 Datatree::~Datatree()
 {
-	if (optimized) delete optimalBipartition;
+	clearCompilation();
 	
 	for (TreesSet::iterator it = children->begin(); it != children->end(); ++it) { delete *it; }
 	delete children;
@@ -301,21 +323,8 @@ void Datatree::computeObjectiveValues ()
 
 void Datatree::normalizeObjectiveValues (ObjectiveValue *maxObjectiveValue)
 {
-	ObjectiveValue *maxQual = maxObjectiveValue; 
-	if (maxQual == 0) { maxQual = parent->value; }
-
-	std::list<Datatree*> *list = new std::list<Datatree*>();
-	list->push_back(this);
-	
-	while (!list->empty())
-	{
-		Datatree *node = list->front();
-		list->pop_front();
-
-		if (node->vertex != -1) { node->value->normalize(maxQual); }
-
-		for (TreesSet::iterator it = node->children->begin(); it != node->children->end(); ++it) { list->push_back(*it); }
-	}
+	if (maxObjectiveValue == 0) { maxObjectiveValue = parent->value; }
+	objective->normalizeObjectiveValues(maxObjectiveValue);
 }
 
 
@@ -342,79 +351,262 @@ void Datatree::printObjectiveValues ()
 }
 
 
+void Datatree::clearCompilation ()
+{
+	for (int k = 0; k < flatSize; k++) { flatNodes[k]->index = -1; }
+
+	delete [] flatNodes;
+	delete [] bipartitionOffsets;
+	std::vector<int>().swap(bipartitionTable);
+	delete [] optimalValues;
+	delete [] optimalBipartitions;
+	delete [] levelOffsets;
+	if (spillFile != -1) { close(spillFile); }
+
+	flatSize = 0;
+	optimizedSize = 0;
+	flatNodes = 0;
+	bipartitionOffsets = 0;
+	optimalValues = 0;
+	optimalBipartitions = 0;
+	levelNumber = 0;
+	levelOffsets = 0;
+	spillFile = -1;
+}
+
+
+void Datatree::setSpillDirectory (std::string directory)
+{
+	if (spillFile != -1) { std::cout << "ERROR: the bipartition table has already been spilled!" << std::endl; return; }
+	spillDirectory = directory;
+	clearCompilation();
+}
+
+
+void Datatree::compile ()
+{
+	if (spillFile != -1) { return; }
+	clearCompilation();
+
+	std::vector<Datatree*> nodes;
+	std::vector<int> levels;
+
+	// Optimized nodes in BFS order from the root, so that the smaller subsets a bipartition refers to are optimized first
+	std::vector<int> depths;
+	for (TreesSet::iterator it = children->begin(); it != children->end(); ++it)
+	{
+		(*it)->index = nodes.size();
+		nodes.push_back(*it);
+		depths.push_back(0);
+	}
+	for (unsigned int k = 0; k < nodes.size(); k++)
+	{
+		Datatree *node = nodes[k];
+		if (k == 0 || depths[k] != depths[k-1]) { levels.push_back(k); }
+		for (TreesSet::iterator it = node->children->begin(); it != node->children->end(); ++it)
+		{
+			(*it)->index = nodes.size();
+			nodes.push_back(*it);
+			depths.push_back(depths[k]+1);
+		}
+	}
+	optimizedSize = nodes.size();
+
+	levelNumber = levels.size();
+	levelOffsets = new int [levelNumber+1];
+	for (int l = 0; l < levelNumber; l++) { levelOffsets[l] = levels[l]; }
+	levelOffsets[levelNumber] = optimizedSize;
+
+	if (!spillDirectory.empty())
+	{
+		std::string path = spillDirectory + "/datatree.XXXXXX";
+		std::vector<char> buffer (path.begin(), path.end());
+		buffer.push_back(0);
+		spillFile = mkstemp(&buffer[0]);
+		if (spillFile == -1) { std::cout << "ERROR: cannot create a spill file in " << spillDirectory << ", keeping the bipartition table in memory!" << std::endl; }
+		else { unlink(&buffer[0]); }
+	}
+
+	// Bipartition table, appending the nodes only referred to by bipartitions
+	std::vector<int> &table = bipartitionTable;
+	bipartitionOffsets = new long [optimizedSize+1];
+
+	long b = 0;
+	for (int l = 0; l < levelNumber; l++)
+	{
+		for (int k = levelOffsets[l]; k < levelOffsets[l+1]; k++)
+		{
+			if (bipartitionBuilder) { bipartitionBuilder(nodes[k]); }
+
+			bipartitionOffsets[k] = b;
+			for (BipartitionsSet::iterator it = nodes[k]->bipartitions->begin(); it != nodes[k]->bipartitions->end(); ++it)
+			{
+				Datatree *sides [2] = {(*it)->first, (*it)->second};
+				for (int i = 0; i < 2; i++)
+				{
+					Datatree *n = sides[i];
+					if (n != 0 && n->index == -1) { n->index = nodes.size(); nodes.push_back(n); }
+					table.push_back((n == 0) ? -1 : n->index);
+				}
+				b++;
+			}
+
+			// Bipartitions are released once in the table if they are spilled or can be generated again
+			if (spillFile != -1 || bipartitionBuilder)
+			{
+				for (BipartitionsSet::iterator it = nodes[k]->bipartitions->begin(); it != nodes[k]->bipartitions->end(); ++it) { delete *it; }
+				nodes[k]->bipartitions->clear();
+			}
+		}
+
+		// Levels are written one after the other
+		if (spillFile != -1) { spillLevel(table); }
+	}
+	bipartitionOffsets[optimizedSize] = b;
+	if (spillFile != -1) { std::vector<int>().swap(table); }
+	if (bipartitionBuilder) { bipartitionBuilder(0); }
+
+	flatSize = nodes.size();
+	flatNodes = new Datatree* [flatSize];
+	for (int k = 0; k < flatSize; k++) { flatNodes[k] = nodes[k]; }
+
+	optimalValues = new double [flatSize];
+	optimalBipartitions = new long [optimizedSize];
+}
+
+
+void Datatree::spillLevel (std::vector<int> &table)
+{
+	const char *data = (const char *) table.data();
+	size_t length = table.size() * sizeof(int);
+
+	while (length > 0)
+	{
+		ssize_t written = write(spillFile,data,length);
+		if (written <= 0) { std::cout << "ERROR: cannot write the spill file!" << std::endl; break; }
+		data += written;
+		length -= written;
+	}
+
+	table.clear();
+}
+
+
 void Datatree::computeOptimalPartition (double parameter)
 {
 	if (VERBOSE) { std::cout << "parameter = " << std::setprecision(10) << parameter << std::endl; }
 
-	std::list<Datatree*> *list = new std::list<Datatree*>();
-	list->push_back(findChild(0)->findChild(1));
-	
-	while (!list->empty())
+	if (flatNodes == 0) { compile(); }
+
+	for (int k = 0; k < flatSize; k++) { optimalValues[k] = flatNodes[k]->value->getValue(parameter); }
+
+	bool maximize = objective->maximize;
+	if (spillFile == -1) { optimizeNodes(0,optimizedSize,bipartitionTable.data(),0,maximize); return; }
+
+	// Each level only refers to smaller subsets: map its part of the table, optimize it, and unmap it
+	long pageSize = sysconf(_SC_PAGESIZE);
+	for (int l = 0; l < levelNumber; l++)
 	{
-		Datatree *node = list->front();
-		list->pop_front();
+		long firstBipartition = bipartitionOffsets[levelOffsets[l]];
+		long lastBipartition = bipartitionOffsets[levelOffsets[l+1]];
 
-		node->optimalBipartition = new Bipartition();
-		node->optimalBipartition->first = this;
-		node->optimalBipartition->second = node;
-		
-		node->optimalValue = node->value->getValue(parameter);
+		off_t begin = (off_t) 2 * sizeof(int) * firstBipartition;
+		off_t end = (off_t) 2 * sizeof(int) * lastBipartition;
+		off_t alignedBegin = begin - begin % pageSize;
 
-		for (BipartitionsSet::iterator it = node->bipartitions->begin(); it != node->bipartitions->end(); ++it)
+		void *map = 0;
+		const int *table = 0;
+		if (end > begin)
 		{
-			Bipartition *p = *it;
-			Datatree *n1 = p->first;
-			Datatree *n2 = p->second;
-			
-			double value = 0;
+			map = mmap(0,end-alignedBegin,PROT_READ,MAP_PRIVATE,spillFile,alignedBegin);
+			if (map == MAP_FAILED) { std::cout << "ERROR: cannot map the spill file!" << std::endl; return; }
+			madvise(map,end-alignedBegin,MADV_SEQUENTIAL);
+			table = (const int *) ((const char *) map + (begin - alignedBegin));
+		}
 
-			if (n1->optimized) { value += n1->optimalValue; }
-			else { value += n1->value->getValue(parameter); }
+		optimizeNodes(levelOffsets[l],levelOffsets[l+1],table,firstBipartition,maximize);
 
-			if (n2->optimized) { value += n2->optimalValue; }
-			else { value += n2->value->getValue(parameter); }
-			
-			if ((objective->maximize && value > node->optimalValue) || (!objective->maximize && value < node->optimalValue))
+		if (map != 0) { munmap(map,end-alignedBegin); }
+	}
+}
+
+
+void Datatree::optimizeNodes (int firstNode, int lastNode, const int *table, long firstBipartition, bool maximize)
+{
+	for (int k = firstNode; k < lastNode; k++)
+	{
+		double optimalValue = optimalValues[k];
+		long optimalBipartition = -1;
+
+		for (long b = bipartitionOffsets[k]; b < bipartitionOffsets[k+1]; b++)
+		{
+			int n1 = table[2*(b-firstBipartition)];
+			int n2 = table[2*(b-firstBipartition)+1];
+
+			double value = 0;
+			if (n1 != -1) { value += optimalValues[n1]; }
+			if (n2 != -1) { value += optimalValues[n2]; }
+
+			if ((maximize && value > optimalValue) || (!maximize && value < optimalValue))
 			{
-				node->optimalBipartition->first = n1;
-				node->optimalBipartition->second = n2;
-				node->optimalValue = value;
+				optimalBipartition = b;
+				optimalValue = value;
 			}
 		}
 
-		node->optimized = true;
-		
-		for (TreesSet::iterator it = node->children->begin(); it != node->children->end(); ++it) { list->push_back(*it); }
+		optimalValues[k] = optimalValue;
+		optimalBipartitions[k] = optimalBipartition;
 	}
 }
 
 
-void Datatree::printOptimalPartition (double parameter)
+void Datatree::getBipartition (long b, int &n1, int &n2)
 {
-	computeOptimalPartition(parameter);
+	if (spillFile == -1) { n1 = bipartitionTable[2*b]; n2 = bipartitionTable[2*b+1]; return; }
 
-	std::list<Datatree*> *optimalPartition = new std::list<Datatree*>();
+	int pair [2] = {-1,-1};
+	if (pread(spillFile,pair,sizeof(pair),(off_t) 2 * sizeof(int) * b) != sizeof(pair)) { std::cout << "ERROR: cannot read the spill file!" << std::endl; }
+	n1 = pair[0];
+	n2 = pair[1];
+}
 
-	Datatree *node = parent;
-	
-	while (node != 0)
+
+long Datatree::getOptimalBipartition (Datatree *node)
+{
+	if (node->index == -1 || node->index >= optimizedSize) { return -1; }
+	return optimalBipartitions[node->index];
+}
+
+
+void Datatree::getOptimalParts (std::list<Datatree*> &parts)
+{
+	// Both sides of an optimal bipartition are themselves split according to their own optimal bipartitions
+	std::list<Datatree*> nodeList;
+	if (parent != 0) { nodeList.push_back(parent); }
+
+	while (!nodeList.empty())
 	{
-		Bipartition *p = node->optimalBipartition;
-		Datatree *n1 = p->first;
-		Datatree *n2 = p->second;
-		
-		Datatree *nextNode = 0;
+		Datatree *node = nodeList.front();
+		nodeList.pop_front();
 
-		if (n1->optimized && n1 != node) { nextNode = n1; }
-		else if (n1->vertex != -1) { optimalPartition->push_front(n1); }
-		
-		if (n2->optimized && n2 != node) { nextNode = n2; }
-		else if (n2->vertex != -1) { optimalPartition->push_front(n2); }
+		long b = getOptimalBipartition(node);
+		if (b == -1) { if (node->vertex != -1) { parts.push_front(node); } continue; }
 
-		node = nextNode;
+		int sides [2];
+		getBipartition(b,sides[0],sides[1]);
+		for (int i = 0; i < 2; i++) { if (sides[i] != -1) { nodeList.push_back(flatNodes[sides[i]]); } }
 	}
+}
+
+
+void Datatree::printOptimalPartition (double parameter)
+{
+	computeOptimalPartition(parameter);
+
+	std::list<Datatree*> optimalPartition;
+	getOptimalParts(optimalPartition);
 	
-	for (std::list<Datatree*>::iterator it = optimalPartition->begin(); it != optimalPartition->end(); ++it)
+	for (std::list<Datatree*>::iterator it = optimalPartition.begin(); it != optimalPartition.end(); ++it)
 	{
 		(*it)->printVertices(false);
 	}
@@ -429,59 +621,34 @@ Partition *Datatree::getOptimalPartition (double parameter)
 
 	Partition *partition = new Partition(objective,parameter);
 	
-	Datatree *node = parent;
-	
-	while (node != 0)
-	{
-		Bipartition *p = node->optimalBipartition;
-		Datatree *n1 = p->first;
-		Datatree *n2 = p->second;
-		
-		Datatree *nextNode = 0;
+	std::list<Datatree*> optimalPartition;
+	getOptimalParts(optimalPartition);
 
-		if (n2->optimized && n2 != node) { nextNode = n2; }
-		else if (n2->vertex != -1)
-		{
-			Part *part = new Part(n2->value);
-			Datatree *n = n2;
-			while (n->vertex != -1)
-			{
-				part->addIndividual(n->vertex,true);
-				n = n->parent;
-			}
-			partition->addPart(part,true);
-		}
-
-		if (n1->optimized && n1 != node) { nextNode = n1; }
-		else if (n1->vertex != -1)
+	for (std::list<Datatree*>::iterator it = optimalPartition.begin(); it != optimalPartition.end(); ++it)
+	{
+		Datatree *n = *it;
+		Part *part = new Part(n->value);
+		while (n->vertex != -1)
 		{
-			Part *part = new Part(n1->value);
-			Datatree *n = n1;
-			while (n->vertex != -1)
-			{
-				part->addIndividual(n->vertex,true);
-				n = n->parent;
-			}
-			partition->addPart(part,true);
+			part->addIndividual(n->vertex,true);
+			n = n->parent;
 		}
-		
-		node = nextNode;
+		partition->addPart(part,true);
 	}
 	
 	return partition;
 }
 
 
-
 void Datatree::print (bool verbose)
 {
 	std::cout << "PRINTING DATA TREE:" << std::endl;
-	printRec(0,verbose);
+	printRec(0,verbose,this);
 	std::cout << std::endl;
 }
 
 
-void Datatree::printRec (int p, bool verbose)
+void Datatree::printRec (int p, bool verbose, Datatree *root)
 {
 	for (int i = 0; i < p; i++) { std::cout << "---"; }
 		
@@ -496,11 +663,18 @@ void Datatree::printRec (int p, bool verbose)
 	else { std::cout << " no complement"; }
 		
 		
-	if (optimized)
+	if (index != -1 && index < root->optimizedSize)
 	{
 		std::cout << " opt = ";
-		optimalBipartition->first->printVertices();
-		optimalBipartition->second->printVertices();
+		long b = root->optimalBipartitions[index];
+		if (b == -1) { printVertices(false); }
+		else
+		{
+			int n1, n2;
+			root->getBipartition(b,n1,n2);
+			root->flatNodes[n1]->printVertices(false);
+			if (n2 != -1) { root->flatNodes[n2]->printVertices(false); }
+		}
 	}
 	std::cout << std::endl;
 		
@@ -517,7 +691,7 @@ void Datatree::printRec (int p, bool verbose)
 		}
 	}
 		
-	for (TreesSet::iterator it = children->begin(); it != children->end(); ++it) { (*it)->printRec(p+1,verbose); }
+	for (TreesSet::iterator it = children->begin(); it != children->end(); ++it) { (*it)->printRec(p+1,verbose,root); }
 }
 
 
@@ -976,26 +1150,8 @@ void OrderedDatatree::computeObjectiveValues ()
 
 void OrderedDatatree::normalizeObjectiveValues (ObjectiveValue *maxObjectiveValue)
 {
-	ObjectiveValue *maxQual = maxObjectiveValue; 
-	if (maxQual == 0) { maxQual = parent->qualities[getIndex(0,size2-1)]; }
-
-	std::list<OrderedDatatree*> *list = new std::list<OrderedDatatree*>();
-	list->push_back(this);
-	
-	while (!list->empty())
-	{
-		OrderedDatatree *node = list->front();
-		list->pop_front();
-
-		if (node->vertex != -1)
-		{
-			for (int j = 0; j < size2; j++)
-				for (int i = 0; i < size2-j; i++)
-					node->qualities[getIndex(i,j)]->normalize(maxQual);
-		}
-
-		for (OrderedTreesSet::iterator it = node->children->begin(); it != node->children->end(); ++it) { list->push_back(*it); }
-	}
+	if (maxObjectiveValue == 0) { maxObjectiveValue = parent->qualities[getIndex(0,size2-1)]; }
+	objective->normalizeObjectiveValues(maxObjectiveValue);
 }
 
 
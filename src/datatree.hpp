@@ -40,6 +40,8 @@
 
 #include <set>
 #include <string>
+#include <vector>
+#include <functional>
 
 #include "graph.hpp"
 #include "partition.hpp"
@@ -69,16 +71,28 @@ class Datatree
 		bool wholeSet;
 		ObjectiveFunction *objective;
 		
-		Datatree *parent;
+		Datatree *parent;                /** \brief Parent node (for the root: the node of the whole set, from which the optimal partition is read) */
 		Datatree *complement;
 		TreesList *complementList;
 		TreesSet *children;
 		ObjectiveValue *value;
 		BipartitionsSet *bipartitions;
 
-		double optimalValue;
-		Bipartition *optimalBipartition;
-		bool optimized;
+		int index;                       /** \brief Position of the node in the flat arrays of the compiled root (-1 if not compiled) */
+
+		int flatSize;                    /** \brief Number of compiled nodes (root only) */
+		int optimizedSize;               /** \brief Number of compiled nodes on which the DP is run, stored first in topological order (root only) */
+		Datatree **flatNodes;            /** \brief Compiled nodes in topological order (root only) */
+		long *bipartitionOffsets;        /** \brief Offsets of the bipartitions of each optimized node in the bipartition table (root only) */
+		std::vector<int> bipartitionTable; /** \brief Contiguous (left, right) node indices of all bipartitions, -1 for an empty side, built in place by compile() (root only) */
+		double *optimalValues;           /** \brief Optimal value of each compiled node (root only) */
+		long *optimalBipartitions;       /** \brief Optimal bipartition of each optimized node in the bipartition table, -1 if the node is kept whole (root only) */
+
+		int levelNumber;                 /** \brief Number of levels (subset sizes) among the optimized nodes (root only) */
+		int *levelOffsets;               /** \brief Index of the first optimized node of each level (root only) */
+		std::string spillDirectory;      /** \brief If not empty, the bipartition table is spilled in a file of this directory and memory-mapped level by level (root only) */
+		int spillFile;                   /** \brief Descriptor of the spilled bipartition table, -1 if the table is in memory (root only) */
+		std::function<void (Datatree *node)> bipartitionBuilder; /** \brief If set, called by compile() on each node before its bipartitions are read, these being released once copied in the table, so that they are never all stored in the tree, and finally with a null node once the table is complete (root only) */
 		
 		Datatree (Datatree &tree);
 		Datatree (int vertex = -1);
@@ -98,6 +112,24 @@ class Datatree
 		void normalizeObjectiveValues (ObjectiveValue *maxObjectiveValue = 0);
 		void printObjectiveValues ();
 
+		/*!
+		 * \brief Flattens the nodes of the tree (in BFS order from the root, i.e. by increasing subset size) and their bipartitions into contiguous arrays
+		 *
+		 * Called lazily by computeOptimalPartition, and must be called again if bipartitions are added afterwards.
+		 */
+		void compile ();
+
+		/*!
+		 * \brief Sets the directory in which compile() spills the bipartition table, one level (subset size) after the other
+		 *
+		 * Once spilled, the bipartitions sets of the optimized nodes are released and the tree cannot be recompiled.
+		 * The DP then maps one level of the table at a time, since each level only depends on smaller subsets.
+		 * Only bipartitions are spilled: the nodes (with their children, complement lists and objective values) stay in memory,
+		 * so spilling only pays off when bipartitions outnumber nodes, as for nonconstrained sets and graphs. Unless they are
+		 * generated by bipartitionBuilder, bipartitions are all stored in the tree until compile() is called.
+		 * \param directory Directory of the spill file (empty to keep the table in memory)
+		 */
+		void setSpillDirectory (std::string directory);
 		void computeOptimalPartition (double parameter);
 		void printOptimalPartition (double parameter);
 		Partition *getOptimalPartition (double parameter);
@@ -113,8 +145,14 @@ class Datatree
 		
 	private:
 		std::string toStringRec ();
-		void printRec (int p, bool verbose);
+		void printRec (int p, bool verbose, Datatree *root);
 		void printVerticesRec ();
+		void clearCompilation ();
+		void spillLevel (std::vector<int> &table);
+		void optimizeNodes (int firstNode, int lastNode, const int *table, long firstBipartition, bool maximize);
+		long getOptimalBipartition (Datatree *node);
+		void getOptimalParts (std::list<Datatree*> &parts);
+		void getBipartition (long b, int &n1, int &n2);
 };
 
 
@@ -39,6 +39,7 @@
 #include <fstream>
 #include <getopt.h>
 #include <algorithm>
+#include <map>
 
 #include "geomediatic_aggregation.hpp"
 #include "uni_set.hpp"
@@ -56,6 +57,7 @@ struct globalArgs_t
 	std::string cubeFileName;
 	std::string outputFileName;
 	std::string hierarchyFileName;
+	std::string adjacencyFileName;
 	std::string model;
 	double parameter;
 	double threshold;
@@ -64,13 +66,14 @@ struct globalArgs_t
 } globalArgs;
 
 //static const char *optString = "d:m:o:s:t:l:v?";
-static const char *optString = "d:m:o:h:s:t:l:v?";
+static const char *optString = "d:m:o:h:a:s:t:l:v?";
 
 static const struct option longOpts[] = {
     {"data", required_argument, NULL, 'd'},
     {"model", required_argument, NULL, 'm'},
     {"output", required_argument, NULL, 'o'},
     {"hierarchy", required_argument, NULL, 'h'},
+    {"adjacency", required_argument, NULL, 'a'},
     {"scale", required_argument, NULL, 's'},
     {"threshold", required_argument, NULL, 't'},
     {"optimal-list", required_argument, NULL, 'l'},
@@ -88,6 +91,7 @@ void usage (void)
 		"-m | --model          Data model (expected values) used for the aggregation. If not specified: a uniform model is implied." << std::endl <<
 		"-o | --output         File to which the results should be printed. If not specified: results are displayed in the terminal." << std::endl <<
 		"-h | --hierarchy      File describing a hierarchy for spatial aggregation. If not specified: no constraint will be assumed on spatial dimensions." << std::endl <<
+		"-a | --adjacency      File describing the adjacency of spatial units (one pair of adjacent labels per line), such that spatial aggregates are connected. Not used if a hierarchy is specified." << std::endl <<
 		"-s | --scale          A float between 0 and 1 describing the aggregation scale. If not specified: multiple scales are computed (see --threshold option)." << std::endl <<
 		"-t | --threshold      The minimal distance between two consecutive scales. Not used if a unique scale is specified (see --scale option). If not specified: 0.01." << std::endl <<
 		"-l | --optimal-list   Return the list of the N best aggregates instead of the optimal partition, where N is specified after this option." << std::endl;
@@ -95,6 +99,30 @@ void usage (void)
 }
 
 
+Graph *buildAdjacencyGraph (std::string fileName, int size, std::string *labels)
+{
+	std::map<std::string,int> indexMap;
+	for (int l = 0; l < size; l++) { indexMap.insert(std::make_pair(labels[l],l)); }
+
+	Graph *graph = new Graph (size);
+
+	std::ifstream file;
+	openInputCSV (file, fileName);
+
+	CSVLine line;
+	while (hasCSVLine (file))
+	{
+		getCSVLine (file, line);
+		std::map<std::string,int>::iterator it1 = indexMap.find(line[0]);
+		std::map<std::string,int>::iterator it2 = indexMap.find(line[1]);
+		if (it1 != indexMap.end() && it2 != indexMap.end() && it1->second != it2->second) { graph->addEdge(it1->second,it2->second); }
+	}
+
+	closeInputCSV (file);
+	return graph;
+}
+
+
 int main (int argc, char *argv[])
 {
     srand(time(NULL));
@@ -106,6 +134,7 @@ int main (int argc, char *argv[])
     globalArgs.model = "";
     globalArgs.outputFileName = "";
     globalArgs.hierarchyFileName = "";
+    globalArgs.adjacencyFileName = "";
     globalArgs.parameter = -1;
     globalArgs.threshold = 0.01;
     globalArgs.optimalSubsetNumber = 0;
@@ -121,6 +150,7 @@ int main (int argc, char *argv[])
 		case 'm': globalArgs.model = optarg; break;
 		case 'o': globalArgs.outputFileName = optarg; break;
 		case 'h': globalArgs.hierarchyFileName = optarg; break;
+		case 'a': globalArgs.adjacencyFileName = optarg; break;
 		case 's': globalArgs.parameter = string2double(optarg); break;
 		case 't': globalArgs.threshold = string2double(optarg); break;
 		case 'l': globalArgs.optimalSubsetNumber = string2int(optarg); break;
@@ -185,8 +215,9 @@ int main (int argc, char *argv[])
 		else if (dimArray[d] == "time") { setArray[d] = new OrderedUniSet (sizeArray[d], labels); }
 		else if (dimArray[d] == "space")
 		{
-			if (globalArgs.hierarchyFileName == "") { setArray[d] = new UnconstrainedUniSet (sizeArray[d], labels); }
-			else { setArray[d] = new HierarchicalUniSet (globalArgs.hierarchyFileName, sizeArray[d], labels); }
+			if (globalArgs.hierarchyFileName != "") { setArray[d] = new HierarchicalUniSet (globalArgs.hierarchyFileName, sizeArray[d], labels); }
+			else if (globalArgs.adjacencyFileName != "") { setArray[d] = new GraphBasedUniSet (buildAdjacencyGraph (globalArgs.adjacencyFileName, sizeArray[d], labels), labels); }
+			else { setArray[d] = new UnconstrainedUniSet (sizeArray[d], labels); }
 		}
 
 		setArray[d]->buildDataStructure ();
@@ -286,8 +317,8 @@ int main (int argc, char *argv[])
 					//CriterionObjectiveValue *q = (CriterionObjectiveValue*) multiPart->value;
 					addCSVField (outputFile, q->sumValue);
 					addCSVField (outputFile, q->sumRefValue);
-					addCSVField (outputFile, q->sizeReduction);
-					addCSVField (outputFile, q->divergence, false);
+					addCSVField (outputFile, q->getGain());
+					addCSVField (outputFile, q->getLoss(), false);
 
 					endCSVLine (outputFile);
 				}
@@ -331,8 +362,8 @@ int main (int argc, char *argv[])
 						//CriterionObjectiveValue *q = (CriterionObjectiveValue*) multiPart->value;
 						addCSVField (outputFile, q->sumValue);
 						addCSVField (outputFile, q->sumRefValue);
-						addCSVField (outputFile, q->sizeReduction);
-						addCSVField (outputFile, q->divergence, false);
+						addCSVField (outputFile, q->getGain());
+						addCSVField (outputFile, q->getLoss(), false);
 
 						endCSVLine (outputFile);
 					}
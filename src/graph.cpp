@@ -41,24 +41,31 @@
 #include <map>
 #include <iostream>
 #include <algorithm>
+#include <limits>
 
 #include "graph.hpp"
+#include "parallel_tools.hpp"
 
 
 
 Graph::Graph (int s)
 {
     size = s;
-    adjacencySets = new Vertices *[size];
+    adjacencySets = new VertexSet [size];
     graphComponents = new GraphComponent *[size];
     graphComponentSet = new GraphComponentSet();
 
     value = 0;
+    slyceBuilder = false;
+    maxPartSize = 0;
+    maxPartRadius = -1;
+    approximateValue = 0;
+    approximationBound = 0;
     reachedVertices = new bool [size];
 
     for (int v = 0; v < size; v++)
     {
-		adjacencySets[v] = new Vertices();
+		adjacencySets[v] = VertexSet(size);
 		reachedVertices[v] = false;
     }
 }
@@ -72,7 +79,7 @@ RandomGraph::RandomGraph (int vNum, int eNum) : Graph (vNum)
 		int v2 = rand() % vNum;
 		
 		if (v1 == v2) continue; // NOT A GOOD WAY!
-		if (adjacencySets[v1]->find(v2) != adjacencySets[v1]->end()) continue;
+		if (adjacencySets[v1].contains(v2)) continue;
 		
 		addEdge(v1,v2);
 		i++;
@@ -93,11 +100,15 @@ RingGraph::RingGraph (int vNum) : Graph (vNum)
 }
 
 
+CompleteGraph::CompleteGraph (int vNum) : Graph (vNum)
+{
+    for (int v1 = 0; v1 < vNum; v1++) { for (int v2 = v1+1; v2 < vNum; v2++) { addEdge(v1,v2); } }
+}
+
+
 
 Graph::~Graph ()
 {
-    for (int v = 0; v < size; v++) { delete adjacencySets[v]; }
-
     delete[] adjacencySets;
     delete[] graphComponents;
 	
@@ -118,8 +129,8 @@ void Graph::setRandom ()
 
 void Graph::addEdge (int v1, int v2)
 {
-    adjacencySets[v1]->insert(v2);
-    adjacencySets[v2]->insert(v1);
+    adjacencySets[v1].insert(v2);
+    adjacencySets[v2].insert(v1);
 }
 
 
@@ -134,16 +145,13 @@ void Graph::buildFromBinary (int index)
 }
 
 
-bool Graph::areAdjacent (int v1, int v2)
-{
-    return adjacencySets[v1]->find(v2) != adjacencySets[v1]->end();
-}
+bool Graph::areAdjacent (int v1, int v2) { return adjacencySets[v1].contains(v2); }
 
 
 bool Graph::areAdjacent (int v1, Vertices *v2)
 {
     for (Vertices::iterator it = v2->begin(); it != v2->end(); ++it)
-		if (adjacencySets[v1]->find(*it) != adjacencySets[v1]->end()) return true;
+		if (adjacencySets[v1].contains(*it)) return true;
     return false;
 }
 
@@ -162,7 +170,7 @@ bool Graph::areAdjacent (Vertices *v1, Vertices *v2)
 bool Graph::areAdjacent (int v1, VVertices *v2)
 {
     for (VVertices::iterator it = v2->begin(); it != v2->end(); ++it)
-		if (adjacencySets[v1]->find(*it) != adjacencySets[v1]->end()) return true;
+		if (adjacencySets[v1].contains(*it)) return true;
     return false;
 }
 
@@ -178,17 +186,23 @@ bool Graph::areAdjacent (VVertices *v1, VVertices *v2)
 }
 
 
+bool Graph::areAdjacent (int v1, VertexSet *v2) { return adjacencySets[v1].intersects(*v2); }
+
+
+bool Graph::areAdjacent (VertexSet *v1, VertexSet *v2)
+{
+    for (int v = v1->next(); v != -1; v = v1->next(v+1))
+		if (adjacencySets[v].intersects(*v2)) return true;
+    return false;
+}
+
+
 
 Vertices *Graph::getAdjacentVertices (int v, int vMax)
 {
     if (vMax == -1) { vMax = v; }
     Vertices *adjVertices = new Vertices();
-    Vertices *adjSet = adjacencySets[v];
-    for (Vertices::iterator it = adjSet->begin(); it != adjSet->end(); ++it)
-    {
-		int adjV = *it;
-		if (adjV < vMax) { adjVertices->insert(adjV); }
-    }
+    for (int adjV = adjacencySets[v].next(); adjV != -1 && adjV < vMax; adjV = adjacencySets[v].next(adjV+1)) { adjVertices->insert(adjVertices->end(),adjV); }
     return adjVertices;
 }
 
@@ -216,17 +230,15 @@ void Graph::buildDataStructure ()
 				connectedVertices->push_back(vertex);
 				graphComponents[vertex] = component;
 				
-				Vertices *adjVertices = getAdjacentVertices(vertex,size);
-				for (Vertices::iterator it = adjVertices->begin(); it != adjVertices->end(); ++it)
+				VertexSet *adjVertices = &adjacencySets[vertex];
+				for (int adjVertex = adjVertices->next(); adjVertex != -1; adjVertex = adjVertices->next(adjVertex+1))
 				{
-					int adjVertex = *it;
 					if (!reachedVertices[adjVertex])
 					{
 						nextVertices->push_back(adjVertex);
 						reachedVertices[adjVertex] = true;
 					}
 				}
-				delete adjVertices;
 			}
 			
 			delete nextVertices;
@@ -240,67 +252,55 @@ void Graph::buildDataStructure ()
 		lastReachedVertex++;
     }
 	
-    for (GraphComponentSet::iterator it = graphComponentSet->begin(); it != graphComponentSet->end(); ++it)
-		(*it)->buildDataStructure();
-}
+    // Components are built concurrently, except the largest one whose root subtrees are built concurrently
+    std::vector<GraphComponent*> components (graphComponentSet->begin(), graphComponentSet->end());
+    if (components.empty()) { return; }
 
+    if (isApproximated())
+    {
+		parallelFor(components.size(), [&] (int c) { components[c]->buildRestrictedParts(maxPartSize,maxPartRadius); });
+		return;
+    }
 
+    if (!spillDirectory.empty()) { for (int c = 0; c < (int) components.size(); c++) { components[c]->datatree->setSpillDirectory(spillDirectory); } }
 
+    int largest = 0;
+    for (int c = 1; c < (int) components.size(); c++) { if (components[c]->size > components[largest]->size) { largest = c; } }
+    if (slyceBuilder) { components[largest]->buildDataStructureWithSlyce(true); }
+    else { components[largest]->buildDataStructure(true); }
 
-void Graph::enumerateSubsets (VVertices *R, VVertices *F, int m, int n, VVertices *T, int q = 0, int r = 0)
-{
-    if (q == n)
+    parallelFor(components.size(), [&] (int c)
     {
-		VVertices *newR = new VVertices(*R);
-		newR->insert(newR->end(), T->begin(), T->end());
-		for (VVertices::iterator it = newR->begin(); it != newR->end(); ++it)
-			std::cout << (*it) << "\t";
-		std::cout << std::endl;
-	
-		VVertices *newF = new VVertices();
-		for (int j = *std::min_element(newR->begin(),newR->end())+1; j < size; j++)
-		{
-			if (areAdjacent(T,j) && !areAdjacent(R,j) && std::find(newR->begin(),newR->end(),j) == newR->end()) {newF->push_back(j); }
-		}
-		slyce(newR,newF,m-n);
+		if (c == largest) { return; }
+		if (slyceBuilder) { components[c]->buildDataStructureWithSlyce(false); }
+		else { components[c]->buildDataStructure(false); }
+    }, VERBOSE ? 1 : 0);
+}
 
-		delete newR;
-		delete newF;
-    }
 
-    else
-    {
-        for (int i = r; i < m; i++)
-        {
-            T[q] = F[i];
-            enumerateSubsets(R,F,m,n,T,q+1,i+1);
-        }
-    }
+
+
+void Graph::buildDataStructureWithSlyce ()
+{
+    slyceBuilder = true;
+    buildDataStructure();
 }
 
 
-void Graph::slyce (VVertices *R, VVertices *F, int m)
+void Graph::setApproximation (int maxSize, int maxRadius)
 {
-    if (F->size() > 0 && m > 0)
-    {
-		for (int n = 1; n <= m; n++)
-		{
-			VVertices *T = new VVertices();
-			enumerateSubsets (R,F,m,n,T);
-			delete T;
-		}
-    }
+    maxPartSize = maxSize;
+    maxPartRadius = maxRadius;
 }
 
-	    
-void Graph::buildDataStructureWithSlyce ()
+
+double Graph::getApproximationGap () { return objective->maximize ? approximationBound - approximateValue : approximateValue - approximationBound; }
+
+
+void Graph::setSpillDirectory (std::string directory)
 {
-    for (int i = 0; i < size; i++)
-    {
-		VVertices *R = new VVertices();
-		VVertices *F = new VVertices(); F->push_back(i);
-		slyce(R,F,size);
-    }
+    spillDirectory = directory;
+    for (GraphComponentSet::iterator it = graphComponentSet->begin(); it != graphComponentSet->end(); ++it) { (*it)->datatree->setSpillDirectory(directory); }
 }
 
 
@@ -320,9 +320,8 @@ bool Graph::isConnected ()
 		int currentVertex = nextVertices->front();
 		nextVertices->pop_front();
 
-		Vertices *adjList = adjacencySets[currentVertex];
-		for (Vertices::iterator it = adjList->begin(); it != adjList->end(); ++it) {
-			int adjVertex = *it;
+		VertexSet *adjList = &adjacencySets[currentVertex];
+		for (int adjVertex = adjList->next(); adjVertex != -1; adjVertex = adjList->next(adjVertex+1)) {
 			if (!reachedVertices[adjVertex]) {
 				nextVertices->push_back(adjVertex);
 				reachedVertices[adjVertex] = true;
@@ -339,45 +338,34 @@ bool Graph::isConnected ()
 
 bool Graph::isConnected (Vertices *V)
 {
-    Vertices *nextVertices = new Vertices();
-    int reachedsize = 1;
+    VertexSet set (size);
+    for (Vertices::iterator it = V->begin(); it != V->end(); ++it) { set.insert(*it); }
+    return isConnected(&set);
+}
 
-    bool first = true;
-    for (Vertices::iterator it = V->begin(); it != V->end(); ++it)
-    {
-		int v = *it;
-		if (first)
-		{
-			nextVertices->insert(v);
-			reachedVertices[v] = true;
-			first = false;
-		}
-		else { reachedVertices[v] = false; }
-    }
 
-    while (!nextVertices->empty())
+bool Graph::isConnected (VertexSet *V)
+{
+    int first = V->next();
+    if (first == -1) { return true; }
+
+    VertexSet reached (size);
+    VertexSet frontier (size);
+    VertexSet next (size);
+    reached.insert(first);
+    frontier.insert(first);
+
+    while (!frontier.empty())
     {
-		Vertices::iterator it = nextVertices->end(); --it;
-		int currentVertex = *it;
-		nextVertices->erase(it);
-	
-		Vertices *adjList = adjacencySets[currentVertex];
-		for (Vertices::iterator it = adjList->begin(); it != adjList->end(); ++it) {
-			int adjV = *it;
-			if (V->find(adjV) != V->end())
-			{
-				if (!reachedVertices[adjV]) {
-					reachedVertices[adjV] = true;
-					reachedsize++;
-					nextVertices->insert(adjV);
-				}
-			}
-		}
+		next.clear();
+		for (int v = frontier.next(); v != -1; v = frontier.next(v+1)) { next.unite(adjacencySets[v]); }
+		next.intersect(*V);
+		next.subtract(reached);
+		reached.unite(next);
+		frontier = next;
     }
 	
-    delete nextVertices;
-	
-    return reachedsize == (int) V->size();
+    return reached.includes(*V);
 }
 
 
@@ -388,7 +376,7 @@ void Graph::print ()
     for (int v = 0; v < size; v++)
     {
 		std::cout << "VERTEX " << v << " adj=";
-		printVertices(adjacencySets[v]);
+		adjacencySets[v].print();
 		std::cout << std::endl;
     }
     std::cout << std::endl;
@@ -416,31 +404,36 @@ void Graph::setObjectiveFunction (ObjectiveFunction *m)
     objective = m;
     value = m->newObjectiveValue();
     for (GraphComponentSet::iterator it = graphComponentSet->begin(); it != graphComponentSet->end(); ++it)
-		(*it)->datatree->setObjectiveFunction(m);
+    {
+		if (isApproximated()) { (*it)->setRestrictedObjectiveFunction(m); }
+		else { (*it)->datatree->setObjectiveFunction(m); }
+    }
 }
 
 
 void Graph::computeObjectiveValues ()
 {
 	objective->computeObjectiveValues();
-    for (GraphComponentSet::iterator it = graphComponentSet->begin(); it != graphComponentSet->end(); ++it)
+
+    std::vector<GraphComponent*> components (graphComponentSet->begin(), graphComponentSet->end());
+    if (isApproximated())
     {
-		GraphComponent *component = *it;
-		component->datatree->computeObjectiveValues();
-		value->add(component->datatree->value);
+		for (unsigned int c = 0; c < components.size(); c++) { components[c]->computeRestrictedObjectiveValues(); }
+		for (unsigned int c = 0; c < components.size(); c++) { value->add(components[c]->value); }
+		return;
     }
+
+    parallelFor(components.size(), [&] (int c) { components[c]->datatree->computeObjectiveValues(); });
+    for (unsigned int c = 0; c < components.size(); c++) { value->add(components[c]->datatree->parent->value); }
 }
 
 
-void Graph::normalizeObjectiveValues ()
-{
-    for (GraphComponentSet::iterator it = graphComponentSet->begin(); it != graphComponentSet->end(); ++it)
-		(*it)->datatree->normalizeObjectiveValues(value);
-}
+void Graph::normalizeObjectiveValues () { objective->normalizeObjectiveValues(value); }
 
 
 void Graph::printObjectiveValues ()
 {
+    if (isApproximated()) { value->print(); std::cout << std::endl; return; }
     for (GraphComponentSet::iterator it = graphComponentSet->begin(); it != graphComponentSet->end(); ++it)
 		(*it)->datatree->printObjectiveValues();
 }
@@ -448,24 +441,59 @@ void Graph::printObjectiveValues ()
 
 void Graph::computeOptimalPartition (double parameter)
 {
-    for (GraphComponentSet::iterator it = graphComponentSet->begin(); it != graphComponentSet->end(); ++it)
-		(*it)->datatree->computeOptimalPartition(parameter);
+    std::vector<GraphComponent*> components (graphComponentSet->begin(), graphComponentSet->end());
+    if (isApproximated())
+    {
+		parallelFor(components.size(), [&] (int c) { components[c]->computeRestrictedOptimalPartition(parameter); }, VERBOSE ? 1 : 0);
+
+		approximateValue = 0;
+		approximationBound = 0;
+		for (unsigned int c = 0; c < components.size(); c++)
+		{
+			approximateValue += components[c]->restrictedValue;
+			approximationBound += components[c]->restrictedBound;
+		}
+		return;
+    }
+
+    parallelFor(components.size(), [&] (int c) { components[c]->computeOptimalPartition(parameter); }, VERBOSE ? 1 : 0);
 }
 
 
 void Graph::printOptimalPartition (double parameter)
 {
+    if (isApproximated())
+    {
+		Partition *partition = getOptimalPartition(parameter);
+		partition->print();
+		std::cout << "VALUE = " << approximateValue << " (BOUND = " << approximationBound << ", GAP = " << getApproximationGap() << ")" << std::endl;
+		delete partition;
+		return;
+    }
+
     for (GraphComponentSet::iterator it = graphComponentSet->begin(); it != graphComponentSet->end(); ++it)
-		(*it)->datatree->printOptimalPartition(parameter);
+		(*it)->printOptimalPartition(parameter);
 }
 
 
 Partition *Graph::getOptimalPartition (double parameter)
 {
-    Partition *partition = new Partition();
-    for (GraphComponentSet::iterator it = graphComponentSet->begin(); it != graphComponentSet->end(); ++it)
+    std::vector<GraphComponent*> components (graphComponentSet->begin(), graphComponentSet->end());
+    Partition *partition = new Partition(objective,parameter);
+
+    if (isApproximated())
     {
-		Partition *p = (*it)->datatree->getOptimalPartition(parameter);
+		computeOptimalPartition(parameter);
+		for (unsigned int c = 0; c < components.size(); c++) { components[c]->addRestrictedOptimalParts(partition); }
+		return partition;
+    }
+
+    std::vector<Partition*> partitions (components.size());
+    parallelFor(components.size(), [&] (int c) { partitions[c] = components[c]->getOptimalPartition(parameter); }, VERBOSE ? 1 : 0);
+
+    for (unsigned int c = 0; c < components.size(); c++)
+    {
+		Partition *p = partitions[c];
 		for (std::list<Part*>::iterator it2 = p->parts->begin(); it2 != p->parts->end(); ++it2)
 			partition->addPart(*it2);
     }
@@ -521,6 +549,10 @@ GraphComponent::GraphComponent (Graph *g)
     size = 0;
     vertices = 0;
     order = 0;
+    value = 0;
+    restrictedValue = 0;
+    restrictedBound = 0;
+    restrictedExact = false;
 }
 
 
@@ -549,200 +581,51 @@ GraphComponent::~GraphComponent ()
     delete[] vertices;
     delete order;
     delete datatree;
+
+    for (unsigned int p = 0; p < partValues.size(); p++) { delete partValues[p]; }
+    for (unsigned int i = 0; i < wholeValues.size(); i++) { delete wholeValues[i]; }
 }
 
 
-struct TreeToAdd
+void GraphComponent::buildDataStructure (bool parallel)
 {
-    Datatree *node;
-    Datatree *nodeToAdd;
-    Vertices *vertices;
-    Vertices *adjVertices;
-};
+    // Trees of the connected subsets rooted in each vertex are independent: build them concurrently, then add them in the component order
+    Datatree **trees = new Datatree* [size];
+    parallelFor(size, [&] (int index) { trees[index] = buildRootTree(index); }, (parallel && !VERBOSE) ? 0 : 1);
 
-
-void GraphComponent::buildDataStructure ()
-{
     for (int index = 0; index < size; index++)
     {
-		int firstVertex = vertices[index];
-		Datatree *tree = new Datatree(firstVertex);
-		Vertices *firstVertices = new Vertices();
-		firstVertices->insert(firstVertex);
-	
-		std::list<TreeToAdd> treeToAddList;
-		struct TreeToAdd firstTreeToAdd = {tree,0,firstVertices,0};
-		treeToAddList.push_back(firstTreeToAdd);
-	
-		while (!treeToAddList.empty())
-		{
-			struct TreeToAdd treeToAdd = treeToAddList.front();
-			Datatree *node = treeToAdd.node;
-			Vertices *vertices = treeToAdd.vertices;
-			treeToAddList.pop_front();
-	
-			if (VERBOSE) {
-				for (int i = 0; i < VERBOSE_TAB; i++) { std::cout << "..."; }
-				std::cout << "(" << VERBOSE_TAB << ") CURRENTLY ON NODE ";
-				node->printVertices();
-				VERBOSE_TAB++;
-			}
-			
-			Vertices *adjVertices = graph->getAdjacentVertices(node->vertex,graph->size);
-			for (Vertices::iterator it = adjVertices->begin(); it != adjVertices->end(); ++it)
-			{
-				int childVertex = *it;
-				if (order->at(childVertex) >= order->at(firstVertex) && vertices->find(childVertex) == vertices->end())
-				{
-					vertices->insert(childVertex);
-
-					Datatree *child = node->addChild(childVertex);
-					Vertices *childVertices = new Vertices(*vertices);
-					struct TreeToAdd childTreeToAdd = {child,0,childVertices,0};
-					treeToAddList.push_back(childTreeToAdd);
-										
-					if (node->wholeSet)
-					{
-						datatree->parent = child;
-						child->wholeSet = true;
-						node->wholeSet = false;
-					}
-				}
-			}
-			
-			delete adjVertices;
-			delete vertices;
-			
-			if (VERBOSE) { VERBOSE_TAB--; }
-		}
-		
-		treeToAddList.clear();
-		struct TreeToAdd newTreeToAdd = {datatree,tree,new Vertices (),0};
-		treeToAddList.push_back(newTreeToAdd);
-		
-		while (!treeToAddList.empty())
-		{
-			struct TreeToAdd treeToAdd = treeToAddList.front();
-			Datatree *node = treeToAdd.node;
-			Datatree *nodeToAdd = treeToAdd.nodeToAdd;
-			Vertices *vertices = treeToAdd.vertices;
-//			Vertices *adjVertices = treeToAdd.adjVertices;
-			treeToAddList.pop_front();
-	
-			if (VERBOSE) {
-				for (int i = 0; i < VERBOSE_TAB; i++) { std::cout << "..."; }
-				std::cout << "(" << VERBOSE_TAB << ") ADJUSTING NODE ";
-				node->printVertices(false);
-				std::cout << " WITH ";
-				nodeToAdd->printVertices(false);
-				std::cout << " KNOWING ";
-				graph->printVertices(vertices);
-				std::cout << std::endl;				
-				VERBOSE_TAB++;
-			}
-
-			if (vertices->find(nodeToAdd->vertex) == vertices->end())
-			{
-				node = node->addChild(nodeToAdd->vertex);
-				vertices->insert(nodeToAdd->vertex);
-			}
-			
-			for (TreesSet::iterator it = nodeToAdd->children->begin(); it != nodeToAdd->children->end(); ++it)
-			{
-				Datatree *child = *it;
-				
-				if (vertices->find(child->vertex) == vertices->end())
-				{
-					Vertices *childVertices = new Vertices (*vertices);
-					struct TreeToAdd childToAdd = {node,child,childVertices,0};
-					treeToAddList.push_back(childToAdd);
-					vertices->insert(child->vertex);
-				}
-			}
-			
-			if (nodeToAdd->parent != 0)
-			{
-				Vertices *parentVertices = new Vertices (*vertices);
-				struct TreeToAdd parentToAdd = {node,nodeToAdd->parent,parentVertices,0};
-				treeToAddList.push_back(parentToAdd);
-			}
-			
-			delete vertices;
-			//delete adjVertices;
-	
-			if (VERBOSE) { VERBOSE_TAB--; }
-		}
+		datatree->children->insert(datatree->children->end(),trees[index]);
+		trees[index]->parent = datatree;
     }
-	
-    /*
-    // COMPUTE COMPLEMENTS
-    datatree->complement = datatree;
-	
-    for (int index = 0; index < size; index++)
-    {
-    TreesList *nodeList = new TreesList();
+    delete [] trees;
 
-    // ADD NEW COMPLEMENTS TO COMPLEMENT LISTS
-    nodeList->push_back(datatree);
-    while (!nodeList->empty())
-    {
-    Datatree *node = nodeList->front();
-    nodeList->pop_front();
-			
-    node->complementList->push_front(node->complement);
-    node->complement = 0; // NOT NECESSARY? (TO ERASE)
+    setWholeSet();
+}
 
-    for (TreesSet::iterator it = node->children->begin(); it != node->children->end(); ++it)
-    {
-    if (order->at(child->vertex) < index)
-    {
-    nodeList->push_back(child);
-    }
-    }
-    }
-		
-    // ADD VERTICES WITH INDEX = index
-    nodeList->push_back(datatree);
-    while (!nodeList->empty())
-    {
-    Datatree *node = nodeList->front();
-    nodeList->pop_front();
-			
-    for (TreesSet::iterator it = node->children->begin(); it != node->children->end(); ++it)
-    {
-    Datatree *child = *it;
 
-    if (order->at(child->vertex) < index)
-    {
-    nodeList->push_back(child);
-    }
+Datatree *GraphComponent::buildRootTree (int index)
+{
+    // Each subset extends the last subset enumerated at the previous depth, so that nodes are added without any copy of vertex sets
+    ConnectedSubsetIterator it (this);
+    it.setRoot(index);
 
-    if (order->at(child->vertex) == index)
-    {
-    TreesList::iterator it2 = node->complementList->begin();
-					
-    while (child != 0)
+    Datatree *tree = 0;
+    std::vector<Datatree*> depthNodes (size);
+    while (it.next())
     {
-    child->complement = *it2;
-    child->complement->complement = child;
-					
-    child = 0;
-    //if (child->children->size() > 1) { std::cout << "WARNING: several added branches!" << std::endl; }
-    for (TreesSet::iterator it3 = child->children->begin(); it3 != child->children->end(); ++it3)
-    {
-    Datatree *newChild = *it;
-    if (order->at(newChild->vertex) < index)
-    {
-    newChild->complement = *it2;
-    newChild->complement->complement = newChild;
-    it2++;
-    }
-    }
-    }
-    }
-    }
+		int depth = it.getDepth();
+		if (depth == 0) { tree = new Datatree(it.getLastVertex()); depthNodes[0] = tree; }
+		else { depthNodes[depth] = depthNodes[depth-1]->addChild(it.getLastVertex()); }
+
+		if (VERBOSE) {
+			for (int i = 0; i < VERBOSE_TAB; i++) { std::cout << "..."; }
+			std::cout << "(" << VERBOSE_TAB << ") CURRENTLY ON NODE ";
+			depthNodes[depth]->printVertices();
+		}
     }
-    */
+
+    return tree;
 }
 
 
@@ -1276,6 +1159,83 @@ datatree->addBipartition(datatree->parent,0);
 */
 
 
+void GraphComponent::buildDataStructureWithSlyce (bool parallel)
+{
+    Datatree **trees = new Datatree* [size];
+    parallelFor(size, [&] (int index) { trees[index] = buildRootTreeWithSlyce(index); }, (parallel && !VERBOSE) ? 0 : 1);
+
+    for (int index = 0; index < size; index++)
+    {
+		datatree->children->insert(datatree->children->end(),trees[index]);
+		trees[index]->parent = datatree;
+    }
+    delete [] trees;
+
+    setWholeSet();
+}
+
+
+Datatree *GraphComponent::buildRootTreeWithSlyce (int index)
+{
+    int root = vertices[index];
+    Datatree *tree = new Datatree(root);
+
+    VertexSet allowed (graph->size);
+    for (int i = index+1; i < size; i++) { allowed.insert(vertices[i]); }
+
+    VertexSet subset (graph->size);
+    subset.insert(root);
+
+    VertexSet neighbours (graph->adjacencySets[root]);
+    VertexSet frontier (graph->adjacencySets[root]);
+    frontier.intersect(allowed);
+
+    slyce(tree,&subset,&neighbours,&allowed,&frontier);
+    return tree;
+}
+
+
+void GraphComponent::slyce (Datatree *node, VertexSet *subset, VertexSet *neighbours, VertexSet *allowed, VertexSet *frontier)
+{
+    if (frontier->empty()) { return; }
+    VertexSet layerNeighbours (graph->size);
+    enumerateSubsets(node,neighbours,allowed,frontier,subset,&layerNeighbours,0);
+}
+
+
+void GraphComponent::enumerateSubsets (Datatree *node, VertexSet *neighbours, VertexSet *allowed, VertexSet *frontier,
+	VertexSet *subset, VertexSet *layerNeighbours, int minVertex)
+{
+    VertexSet newSubset (graph->size);
+    VertexSet newLayerNeighbours (graph->size);
+    VertexSet newNeighbours (graph->size);
+    VertexSet newFrontier (graph->size);
+
+    // Each layer is built vertex by vertex, in increasing order, so that every prefix is a (connected) node of the datatree
+    for (int v = frontier->next(minVertex); v != -1; v = frontier->next(v+1))
+    {
+		Datatree *child = node->addChild(v);
+
+		newSubset = *subset;
+		newSubset.insert(v);
+		newLayerNeighbours = *layerNeighbours;
+		newLayerNeighbours.unite(graph->adjacencySets[v]);
+
+		// Next layer: vertices adjacent to the current layer, but neither in the subset nor adjacent to the previous layers
+		newFrontier = newLayerNeighbours;
+		newFrontier.subtract(*neighbours);
+		newFrontier.subtract(newSubset);
+		newFrontier.intersect(*allowed);
+		newNeighbours = *neighbours;
+		newNeighbours.unite(newLayerNeighbours);
+		slyce(child,&newSubset,&newNeighbours,allowed,&newFrontier);
+
+		enumerateSubsets(child,neighbours,allowed,frontier,&newSubset,&newLayerNeighbours,v+1);
+    }
+}
+
+
+
 /*
   void GraphComponent::print ()
   {
@@ -1300,3 +1260,406 @@ void GraphComponent::computeOptimalPartition (double parameter) { datatree->comp
 void GraphComponent::printOptimalPartition (double parameter) { datatree->printOptimalPartition(parameter); }
 Partition *GraphComponent::getOptimalPartition (double parameter) { return datatree->getOptimalPartition(parameter); }
 
+
+void GraphComponent::setWholeSet ()
+{
+    // The whole component is the only node as deep as its number of vertices
+    std::vector<Datatree*> level (1,datatree);
+    std::vector<Datatree*> nextLevel;
+    for (int depth = 0; depth < size; depth++)
+    {
+		nextLevel.clear();
+		for (unsigned int k = 0; k < level.size(); k++) { nextLevel.insert(nextLevel.end(),level[k]->children->begin(),level[k]->children->end()); }
+		level.swap(nextLevel);
+    }
+    datatree->parent = level.empty() ? 0 : level[0];
+    datatree->bipartitionBuilder = [this] (Datatree *node) { addBipartitions(node); };
+}
+
+
+void GraphComponent::addBipartitions (Datatree *node)
+{
+    // The table is complete: the nodes of the subsets are only needed again if the datatree is recompiled
+    if (node == 0) { std::unordered_map<VertexSet,Datatree*,VertexSetHash>().swap(subsetNodes); return; }
+
+    // Node of each connected subset
+    if (subsetNodes.empty())
+    {
+		std::list< std::pair<Datatree*,VertexSet> > nodeList;
+		nodeList.push_back(std::make_pair(datatree,VertexSet(graph->size)));
+		while (!nodeList.empty())
+		{
+			Datatree *parentNode = nodeList.front().first;
+			VertexSet &subset = nodeList.front().second;
+			for (TreesSet::iterator it = parentNode->children->begin(); it != parentNode->children->end(); ++it)
+			{
+				VertexSet childSubset (subset);
+				childSubset.insert((*it)->vertex);
+				subsetNodes[childSubset] = *it;
+				nodeList.push_back(std::make_pair(*it,childSubset));
+			}
+			nodeList.pop_front();
+		}
+    }
+
+    // The subset of a node is made of the vertices on its path from the root
+    VertexSet subset (graph->size);
+    for (Datatree *n = node; n != datatree; n = n->parent) { subset.insert(n->vertex); }
+    if (subset.count() < 2 || !node->bipartitions->empty()) { return; }
+
+    int firstVertex = subset.next();
+    VertexSet first (graph->size);
+    first.insert(firstVertex);
+    VertexSet candidates (graph->adjacencySets[firstVertex]);
+    candidates.intersect(subset);
+    addConnectedBipartitions(node,subset,first,candidates,VertexSet(graph->size));
+}
+
+
+void GraphComponent::addConnectedBipartitions (Datatree *node, const VertexSet &subset, VertexSet &first, VertexSet candidates, VertexSet excluded)
+{
+    VertexSet second (subset);
+    second.subtract(first);
+    if (!second.empty() && graph->isConnected(&second)) { node->addBipartition(subsetNodes.at(first),subsetNodes.at(second)); }
+
+    // Each connected subset containing the first vertex is enumerated once: candidates are added in increasing order, and excluded from the next branches
+    VertexSet newFirst (graph->size);
+    VertexSet newCandidates (graph->size);
+    for (int v = candidates.next(); v != -1; v = candidates.next(v+1))
+    {
+		newFirst = first;
+		newFirst.insert(v);
+		newCandidates = graph->adjacencySets[v];
+		newCandidates.intersect(subset);
+		newCandidates.unite(candidates);
+		newCandidates.subtract(newFirst);
+		newCandidates.subtract(excluded);
+		addConnectedBipartitions(node,subset,newFirst,newCandidates,excluded);
+		excluded.insert(v);
+    }
+}
+
+ConnectedSubsetIterator *GraphComponent::getConnectedSubsets () { return new ConnectedSubsetIterator(this); }
+
+
+
+void GraphComponent::buildRestrictedParts (int maxPartSize, int maxPartRadius)
+{
+    int graphSize = graph->size;
+    localIndices.assign(graphSize,-1);
+    for (int i = 0; i < size; i++) { localIndices[vertices[i]] = i; }
+
+    // Balls of radius maxPartRadius around each vertex, by breadth-first search, and of radius 2*maxPartRadius, that contain all the feasible parts rooted in this vertex
+    std::vector<VertexSet> balls;
+    std::vector<VertexSet> ranges;
+    if (maxPartRadius >= 0)
+    {
+		balls.assign(size,VertexSet(graphSize));
+		ranges.assign(size,VertexSet(graphSize));
+		VertexSet frontier (graphSize);
+		VertexSet nextFrontier (graphSize);
+		for (int i = 0; i < size; i++)
+		{
+			ranges[i].insert(vertices[i]);
+			frontier.clear();
+			frontier.insert(vertices[i]);
+			for (int r = 0; r < 2*maxPartRadius && !frontier.empty(); r++)
+			{
+				if (r == maxPartRadius) { balls[i] = ranges[i]; }
+				nextFrontier.clear();
+				for (int v = frontier.next(); v != -1; v = frontier.next(v+1)) { nextFrontier.unite(graph->adjacencySets[v]); }
+				nextFrontier.subtract(ranges[i]);
+				ranges[i].unite(nextFrontier);
+				frontier = nextFrontier;
+			}
+			if (balls[i].empty()) { balls[i] = ranges[i]; }
+		}
+    }
+
+    partParents.clear();
+    partLastVertices.clear();
+    partSizes.clear();
+    feasibleParts.clear();
+    rootOffsets.clear();
+
+    // Each part is stored as its parent part (at depth-1) plus its last vertex
+    std::vector<int> stack (size);
+    ConnectedSubsetIterator it (this,maxPartSize,ranges.empty() ? 0 : &ranges[0]);
+    while (it.next())
+    {
+		int depth = it.getDepth();
+		if (depth == 0) { rootOffsets.push_back(partParents.size()); }
+
+		stack[depth] = partParents.size();
+		partParents.push_back(depth == 0 ? -1 : stack[depth-1]);
+		partLastVertices.push_back(it.getLastVertex());
+		partSizes.push_back(depth+1);
+
+		bool feasible = true;
+		if (maxPartRadius >= 0)
+		{
+			VertexSet *subset = it.getSubset();
+			feasible = false;
+			for (int v = subset->next(); v != -1 && !feasible; v = subset->next(v+1)) { feasible = balls[localIndices[v]].includes(*subset); }
+		}
+		feasibleParts.push_back(feasible);
+    }
+    rootOffsets.push_back(partParents.size());
+
+    if (VERBOSE) { std::cout << "COMPONENT OF " << size << " VERTICES: " << partParents.size() << " ENUMERATED PARTS" << std::endl; }
+}
+
+
+void GraphComponent::setRestrictedObjectiveFunction (ObjectiveFunction *objective)
+{
+    for (unsigned int p = 0; p < partValues.size(); p++) { delete partValues[p]; }
+    for (unsigned int i = 0; i < wholeValues.size(); i++) { delete wholeValues[i]; }
+
+    partValues.resize(partParents.size());
+    for (unsigned int p = 0; p < partValues.size(); p++)
+    {
+		if (partParents[p] == -1) { partValues[p] = objective->newObjectiveValue(partLastVertices[p]); }
+		else { partValues[p] = objective->newObjectiveValue(); }
+    }
+
+    wholeValues.resize(size-1);
+    for (int i = 0; i < size-1; i++) { wholeValues[i] = objective->newObjectiveValue(); }
+    value = (size == 1) ? partValues[rootOffsets[0]] : wholeValues[size-2];
+}
+
+
+void GraphComponent::computeRestrictedObjectiveValues ()
+{
+    // Singletons first, since every other part is computed from its parent part and the singleton of its last vertex
+    parallelFor(size, [&] (int i) { partValues[rootOffsets[i]]->compute(); });
+    parallelFor(size, [&] (int i)
+    {
+		for (int p = rootOffsets[i]+1; p < rootOffsets[i+1]; p++)
+		{
+			ObjectiveValue *q1 = partValues[rootOffsets[localIndices[partLastVertices[p]]]];
+			ObjectiveValue *q2 = partValues[partParents[p]];
+			partValues[p]->compute(q1,q2);
+		}
+    });
+
+    ObjectiveValue *previous = partValues[rootOffsets[0]];
+    for (int i = 1; i < size; i++)
+    {
+		wholeValues[i-1]->compute(partValues[rootOffsets[i]],previous);
+		previous = wholeValues[i-1];
+    }
+}
+
+
+void GraphComponent::computeRestrictedOptimalPartition (double parameter)
+{
+    // Objective values are multiplied by sign, so that the problem is always a maximisation
+    double sign = graph->objective->maximize ? 1 : -1;
+    int partNumber = partParents.size();
+
+    std::vector<double> scores (partNumber);
+    for (int p = 0; p < partNumber; p++) { if (feasibleParts[p]) { scores[p] = sign * partValues[p]->getValue(parameter); } }
+
+    // Bound: each vertex contributes at most the best score per vertex of the parts containing it
+    std::vector<double> bestScores (size,-std::numeric_limits<double>::infinity());
+    for (int p = 0; p < partNumber; p++)
+    {
+		if (!feasibleParts[p]) { continue; }
+		double score = scores[p] / partSizes[p];
+		for (int q = p; q != -1; q = partParents[q])
+		{
+			int i = localIndices[partLastVertices[q]];
+			if (score > bestScores[i]) { bestScores[i] = score; }
+		}
+    }
+
+    double bound = 0;
+    for (int i = 0; i < size; i++) { bound += bestScores[i]; }
+
+    // The exact program visits, for each subset, the parts rooted in its first vertex
+    double cost = 0;
+    if (size <= 22) { for (int i = 0; i < size; i++) { cost += (double) (rootOffsets[i+1] - rootOffsets[i]) * (1 << (size-1-i)); } }
+    restrictedExact = (size <= 22 && cost <= 1e8);
+
+    optimalParts.clear();
+    double score = 0;
+
+    if (restrictedExact)
+    {
+		std::vector<unsigned int> masks (partNumber);
+		for (int p = 0; p < partNumber; p++)
+		{
+			unsigned int mask = 1u << localIndices[partLastVertices[p]];
+			masks[p] = (partParents[p] == -1) ? mask : masks[partParents[p]] | mask;
+		}
+
+		unsigned int full = (1u << size) - 1;
+		std::vector<double> optimalScores (full+1);
+		std::vector<int> optimalChoices (full+1);
+		optimalScores[0] = 0;
+
+		for (unsigned int mask = 1; mask <= full; mask++)
+		{
+			int i = __builtin_ctz(mask);
+			double best = -std::numeric_limits<double>::infinity();
+			int choice = -1;
+			for (int p = rootOffsets[i]; p < rootOffsets[i+1]; p++)
+			{
+				if (!feasibleParts[p] || (masks[p] & ~mask) != 0) { continue; }
+				double s = scores[p] + optimalScores[mask ^ masks[p]];
+				if (s > best) { best = s; choice = p; }
+			}
+			optimalScores[mask] = best;
+			optimalChoices[mask] = choice;
+		}
+
+		for (unsigned int mask = full; mask != 0; mask ^= masks[optimalChoices[mask]]) { optimalParts.push_back(optimalChoices[mask]); }
+		score = optimalScores[full];
+		bound = score;
+    }
+
+    else
+    {
+		// Greedy packing of the parts that improve on their singletons, by decreasing gain
+		std::vector<std::pair<double,int>> gains;
+		for (int p = 0; p < partNumber; p++)
+		{
+			if (!feasibleParts[p] || partSizes[p] == 1) { continue; }
+			double gain = scores[p];
+			for (int q = p; q != -1; q = partParents[q]) { gain -= scores[rootOffsets[localIndices[partLastVertices[q]]]]; }
+			if (gain > 0) { gains.push_back(std::make_pair(-gain,p)); }
+		}
+		std::sort(gains.begin(),gains.end());
+
+		std::vector<bool> covered (size,false);
+		for (unsigned int g = 0; g < gains.size(); g++)
+		{
+			int p = gains[g].second;
+			bool free = true;
+			for (int q = p; q != -1 && free; q = partParents[q]) { free = !covered[localIndices[partLastVertices[q]]]; }
+			if (!free) { continue; }
+
+			for (int q = p; q != -1; q = partParents[q]) { covered[localIndices[partLastVertices[q]]] = true; }
+			optimalParts.push_back(p);
+			score += scores[p];
+		}
+
+		for (int i = 0; i < size; i++)
+		{
+			if (covered[i]) { continue; }
+			optimalParts.push_back(rootOffsets[i]);
+			score += scores[rootOffsets[i]];
+		}
+    }
+
+    restrictedValue = sign * score;
+    restrictedBound = sign * bound;
+}
+
+
+void GraphComponent::addRestrictedOptimalParts (Partition *partition)
+{
+    for (unsigned int k = 0; k < optimalParts.size(); k++)
+    {
+		Part *part = new Part(partValues[optimalParts[k]]);
+		for (int q = optimalParts[k]; q != -1; q = partParents[q]) { part->addIndividual(partLastVertices[q],true); }
+		partition->addPart(part);
+    }
+}
+
+
+
+ConnectedSubsetIterator::ConnectedSubsetIterator (GraphComponent *c, int maxSize, const VertexSet *ranges) : rootExcluded (c->graph->size)
+{
+    component = c;
+    rootRanges = ranges;
+    maxDepth = (maxSize > 0 && maxSize < component->size) ? maxSize-1 : component->size-1;
+    adjacencySets = component->graph->adjacencySets;
+
+    int graphSize = component->graph->size;
+    subsets = new VertexSet [component->size];
+    extensions = new VertexSet [component->size];
+    excluded = new VertexSet [component->size];
+    for (int d = 0; d < component->size; d++)
+    {
+		subsets[d] = VertexSet(graphSize);
+		extensions[d] = VertexSet(graphSize);
+		excluded[d] = VertexSet(graphSize);
+    }
+
+    for (int v = 0; v < graphSize; v++) { rootExcluded.insert(v); }
+    for (int i = 0; i < component->size; i++) { rootExcluded.erase(component->vertices[i]); }
+
+    rootIndex = -1;
+    lastRootIndex = component->size-1;
+    depth = -1;
+    lastVertex = -1;
+}
+
+
+void ConnectedSubsetIterator::setRoot (int index)
+{
+    rootExcluded.clear();
+    for (int v = 0; v < component->graph->size; v++) { rootExcluded.insert(v); }
+    for (int i = index; i < component->size; i++) { rootExcluded.erase(component->vertices[i]); }
+
+    rootIndex = index-1;
+    lastRootIndex = index;
+    depth = -1;
+    lastVertex = -1;
+}
+
+
+ConnectedSubsetIterator::~ConnectedSubsetIterator ()
+{
+    delete [] subsets;
+    delete [] extensions;
+    delete [] excluded;
+}
+
+
+bool ConnectedSubsetIterator::next ()
+{
+    while (depth >= 0)
+    {
+		if (depth == maxDepth) { depth--; continue; }
+
+		int vertex = extensions[depth].next();
+		if (vertex == -1) { depth--; continue; }
+
+		// Branch on the subset including vertex, then exclude vertex from the following branches
+		extensions[depth].erase(vertex);
+
+		subsets[depth+1] = subsets[depth];
+		subsets[depth+1].insert(vertex);
+
+		extensions[depth+1] = adjacencySets[vertex];
+		extensions[depth+1].unite(extensions[depth]);
+		extensions[depth+1].subtract(subsets[depth+1]);
+		extensions[depth+1].subtract(excluded[depth]);
+		if (rootRanges != 0) { extensions[depth+1].intersect(rootRanges[rootIndex]); }
+
+		excluded[depth+1] = excluded[depth];
+		excluded[depth].insert(vertex);
+
+		depth++;
+		lastVertex = vertex;
+		return true;
+    }
+
+    if (rootIndex == lastRootIndex) { return false; }
+
+    int root = component->vertices[++rootIndex];
+    rootExcluded.insert(root);
+
+    depth = 0;
+    lastVertex = root;
+    subsets[0].clear();
+    subsets[0].insert(root);
+    excluded[0] = rootExcluded;
+    extensions[0] = adjacencySets[root];
+    extensions[0].subtract(excluded[0]);
+    if (rootRanges != 0) { extensions[0].intersect(rootRanges[rootIndex]); }
+    return true;
+}
+
@@ -40,10 +40,12 @@
 
 #include <map>
 #include <vector>
+#include <unordered_map>
 
 #include "abstract_set.hpp"
 #include "partition.hpp"
 #include "datatree.hpp"
+#include "vertex_set.hpp"
 
 extern bool VERBOSE;
 extern int VERBOSE_TAB;
@@ -58,6 +60,7 @@ class Datatree;
 class Partition;
 
 class GraphComponent;
+class ConnectedSubsetIterator;
 typedef std::set<GraphComponent*> GraphComponentSet;
 
 
@@ -65,12 +68,19 @@ class Graph: public AbstractSet
 {
 public:
     int size;
-    Vertices **adjacencySets;
+    VertexSet *adjacencySets;
     GraphComponent **graphComponents;
     GraphComponentSet *graphComponentSet;
 
     bool *reachedVertices;
     ObjectiveValue *value;
+    bool slyceBuilder; /** \brief If true, buildDataStructure() enumerates connected subsets by layers (see GraphComponent::buildDataStructureWithSlyce) instead of extending them vertex by vertex with ConnectedSubsetIterator */
+    std::string spillDirectory; /** \brief If not empty, the datatree of each component spills its bipartition table in this directory (see Datatree::setSpillDirectory: nodes stay in memory, only bipartitions are spilled) */
+
+    int maxPartSize; /** \brief If positive, approximation mode: feasible parts are the connected subsets of at most maxPartSize vertices (see setApproximation) */
+    int maxPartRadius; /** \brief If non-negative, approximation mode: feasible parts are the connected subsets included in the ball of this radius around one of their vertices */
+    double approximateValue; /** \brief In approximation mode, objective value (at the last parameter) of the partition returned by getOptimalPartition */
+    double approximationBound; /** \brief In approximation mode, bound on the objective value of any partition into feasible parts (equal to approximateValue when all components are solved exactly) */
 	
     Graph (int size);
     ~Graph ();
@@ -89,12 +99,15 @@ public:
     bool areAdjacent (int v1, VVertices *v2);
     bool areAdjacent (VVertices *v1, int v2);
     bool areAdjacent (VVertices *v1, VVertices *v2);
+    bool areAdjacent (int v1, VertexSet *v2);
+    bool areAdjacent (VertexSet *v1, VertexSet *v2);
 
     Vertices *getAdjacentVertices (int v, int vMax = -1);
     void printVertices (Vertices *V);
 
     bool isConnected ();
     bool isConnected (Vertices *V);
+    bool isConnected (VertexSet *V);
 		
     void printDataStructure (bool verbose = true);
 
@@ -108,8 +121,20 @@ public:
     void printObjectiveValues ();
 
     void buildDataStructureWithSlyce ();
-    void slyce (VVertices *R, VVertices *F, int m);
-    void enumerateSubsets (VVertices *R, VVertices *F, int m, int n, VVertices *T, int q, int r);
+    void setSpillDirectory (std::string directory);
+
+    /*!
+     * \brief Switch to approximation mode (to be called before buildDataStructure): instead of the datatree of all connected subsets, only the connected subsets of bounded size or radius are enumerated, and the optimal partition into such parts is computed by an exact dynamic program on small components and by a greedy packing on large ones
+     * \param maxPartSize : The maximal number of vertices of a part (0 for no bound)
+     * \param maxPartRadius : The maximal distance from one vertex of a part to all its other vertices (-1 for no bound)
+     */
+    void setApproximation (int maxPartSize, int maxPartRadius = -1);
+    bool isApproximated () { return maxPartSize > 0 || maxPartRadius >= 0; }
+
+    /*!
+     * \brief Return the gap between approximationBound and approximateValue (null when the restricted problem has been solved exactly)
+     */
+    double getApproximationGap ();
     
     void computeOptimalPartition (double parameter);
     void printOptimalPartition (double parameter);		
@@ -126,6 +151,11 @@ public:
 		
     Graph *graph;
     Datatree *datatree;
+
+    ObjectiveValue *value; /** \brief Approximation mode: objective value of the whole component */
+    double restrictedValue; /** \brief Approximation mode: objective value of the last computed partition */
+    double restrictedBound; /** \brief Approximation mode: bound on the objective value of any partition into feasible parts (sum over vertices of the best value per vertex of the parts containing them) */
+    bool restrictedExact; /** \brief Approximation mode: true if the last partition has been computed by the exact dynamic program */
 	
     GraphComponent (Graph *graph);
     ~GraphComponent ();
@@ -133,15 +163,127 @@ public:
     void setVertices (std::list<int> *vertexList);
 		
     void printDataStructure (bool verbose = true);
-		
-    void buildDataStructure ();
+
+    /*!
+     * \brief Build the datatree of the connected subsets of the component
+     * \param parallel : If true, the subtrees rooted in each vertex are built concurrently before being added (in a deterministic order)
+     */
+    void buildDataStructure (bool parallel = true);
+
+    /*!
+     * \brief Build the subtree of the connected subsets rooted in a vertex (see ConnectedSubsetIterator::setRoot), each node being the child of the subset it extends
+     * \param index : The index of the root in the component order
+     */
+    Datatree *buildRootTree (int index);
+
+    /*!
+     * \brief Build the same datatree as buildDataStructure, by enumerating the connected subsets of each root by breadth-first layers (each new layer being a non-empty subset of the vertices adjacent to the previous layer and to no earlier one)
+     * \param parallel : If true, the subtrees rooted in each vertex are built concurrently
+     */
+    void buildDataStructureWithSlyce (bool parallel = true);
+    Datatree *buildRootTreeWithSlyce (int index);
+    void slyce (Datatree *node, VertexSet *subset, VertexSet *neighbours, VertexSet *allowed, VertexSet *frontier);
+    void enumerateSubsets (Datatree *node, VertexSet *neighbours, VertexSet *allowed, VertexSet *frontier, VertexSet *subset, VertexSet *layerNeighbours, int minVertex);
+
     void computeObjectiveValues ();
     void normalizeObjectiveValues ();
     void printObjectiveValues ();
+
+    /*!
+     * \brief Add to a node of the datatree its bipartitions into two connected subsets, the first one containing the smallest vertex of the node (called by Datatree::compile() through bipartitionBuilder, as bipartitions are much more numerous than nodes, and with a null node once compile() is done, to release the node of each subset)
+     */
+    void addBipartitions (Datatree *node);
 				
     void computeOptimalPartition (double parameter);
     void printOptimalPartition (double parameter);		
     Partition *getOptimalPartition (double parameter);
+
+    ConnectedSubsetIterator *getConnectedSubsets ();
+
+    /*!
+     * \brief Approximation mode: enumerate the feasible parts of the component (see Graph::setApproximation) without building its datatree
+     */
+    void buildRestrictedParts (int maxPartSize, int maxPartRadius);
+    void setRestrictedObjectiveFunction (ObjectiveFunction *objective);
+    void computeRestrictedObjectiveValues ();
+
+    /*!
+     * \brief Approximation mode: compute the best partition into feasible parts, exactly (dynamic program on the subsets of the component) if its cost is low enough, or else greedily (by decreasing gain with respect to the atomic partition)
+     */
+    void computeRestrictedOptimalPartition (double parameter);
+    void addRestrictedOptimalParts (Partition *partition);
+
+private:
+    std::unordered_map<VertexSet,Datatree*,VertexSetHash> subsetNodes; /** \brief Node of each connected subset, built by the first call to addBipartitions() and released at the end of the compilation */
+
+    void setWholeSet ();
+    void addConnectedBipartitions (Datatree *node, const VertexSet &subset, VertexSet &first, VertexSet candidates, VertexSet excluded);
+
+    std::vector<int> localIndices; /** \brief Index in the component order of each vertex of the graph (-1 for vertices of other components) */
+    std::vector<int> partParents; /** \brief Feasible and intermediary parts, stored as the index of the part minus its last vertex (-1 for singletons) */
+    std::vector<int> partLastVertices; /** \brief Last vertex of each part */
+    std::vector<int> partSizes; /** \brief Number of vertices of each part */
+    std::vector<bool> feasibleParts; /** \brief False for parts enumerated only as prefixes of feasible ones (when maxPartRadius is set) */
+    std::vector<int> rootOffsets; /** \brief Parts rooted in the i-th vertex of the component are stored from rootOffsets[i] to rootOffsets[i+1]-1 (the first one being the singleton) */
+    std::vector<ObjectiveValue*> partValues;
+    std::vector<ObjectiveValue*> wholeValues; /** \brief Values of the growing prefixes of the component order, the last one being the whole component */
+    std::vector<int> optimalParts; /** \brief Parts of the last computed partition */
+};
+
+
+/*!
+ * \class ConnectedSubsetIterator
+ * \brief Enumerate the connected subsets of vertices of a graph component, without any allocation once constructed
+ *
+ * Subsets are emitted in canonical order: by increasing root (the first vertex of the subset in the component order),
+ * then depth-first, each subset being its parent subset (at depth-1) plus one adjacent vertex. Objective values can hence
+ * be computed on the fly from the value at depth-1 and the value of getLastVertex(). Usage:
+ * `while (it->next()) { VertexSet *subset = it->getSubset(); ... }`
+ */
+class ConnectedSubsetIterator
+{
+public:
+    /*!
+     * \brief Constructor
+     * \param component : The component whose subsets are enumerated
+     * \param maxSize : If positive, only the subsets of at most maxSize vertices are enumerated (branches are cut at this depth)
+     * \param rootRanges : If not null, the subsets rooted in the i-th vertex of the component only contain vertices of rootRanges[i]
+     */
+    ConnectedSubsetIterator (GraphComponent *component, int maxSize = 0, const VertexSet *rootRanges = 0);
+    ~ConnectedSubsetIterator ();
+
+    /*!
+     * \brief Move to the next connected subset
+     * \return false if all subsets have been enumerated
+     */
+    bool next ();
+
+    VertexSet *getSubset () { return &subsets[depth]; }
+    int getDepth () { return depth; }
+    int getRoot () { return component->vertices[rootIndex]; }
+    int getLastVertex () { return lastVertex; }
+
+    /*!
+     * \brief Restrict the enumeration to the subsets rooted in one vertex (to be called before next), so that roots can be enumerated concurrently
+     * \param index : The index of the root in the component order
+     */
+    void setRoot (int index);
+
+private:
+    GraphComponent *component;
+    VertexSet *adjacencySets;
+
+    int rootIndex; /** \brief Index (in the component order) of the root of the current subset */
+    int lastRootIndex; /** \brief Index of the last root to enumerate */
+    int depth; /** \brief Number of vertices of the current subset minus one (-1 before the first subset of a root) */
+    int lastVertex; /** \brief Last vertex added to the current subset */
+    int maxDepth; /** \brief Subsets at this depth are not extended anymore */
+    const VertexSet *rootRanges;
+
+    VertexSet rootExcluded; /** \brief Vertices that cannot be added to subsets of the current root (outside the component or before the root) */
+    VertexSet *subsets; /** \brief Stack of the subsets from the root to the current one */
+    VertexSet *extensions; /** \brief Stack of the vertices that can still be added to each subset of the stack */
+    VertexSet *excluded; /** \brief Stack of the vertices that cannot be added anymore to each subset of the stack */
 };
 
 
@@ -222,8 +222,8 @@ int main (int argc, char *argv[])
 			RelativeObjectiveValue *q = (RelativeObjectiveValue*) multiPart->value;
 			addCSVField (outputFile, q->sumValue);
 			//addCSVField (outputFile, q->sumRefValue);
-			addCSVField (outputFile, q->divergence);
-			addCSVField (outputFile, q->sizeReduction, false);
+			addCSVField (outputFile, q->getLoss());
+			addCSVField (outputFile, q->getGain(), false);
 
 			endCSVLine (outputFile);
 		}
@@ -0,0 +1,314 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "graph_loader.hpp"
+#include "graph.hpp"
+
+
+/*!
+ * \brief Content of a file, either memory-mapped or read into a buffer
+ */
+struct FileContent
+{
+	const char *data;
+	size_t length;
+	void *map;
+	std::vector<char> buffer;
+
+	FileContent () : data (0), length (0), map (0) {}
+	~FileContent () { if (map != 0) { munmap(map,length); } }
+
+	bool open (std::string fileName, bool useMap)
+	{
+		int file = ::open(fileName.c_str(),O_RDONLY);
+		if (file == -1) { return false; }
+
+		struct stat status;
+		if (fstat(file,&status) == -1) { close(file); return false; }
+		length = status.st_size;
+
+		if (length > 0 && useMap)
+		{
+			map = mmap(0,length,PROT_READ,MAP_PRIVATE,file,0);
+			if (map == MAP_FAILED) { map = 0; }
+			else { madvise(map,length,MADV_SEQUENTIAL); data = (const char *) map; }
+		}
+
+		if (map == 0)
+		{
+			buffer.resize(length);
+			size_t done = 0;
+			while (done < length)
+			{
+				ssize_t r = read(file,&buffer[done],length-done);
+				if (r <= 0) { close(file); return false; }
+				done += r;
+			}
+			data = buffer.data();
+		}
+
+		close(file);
+		return true;
+	}
+};
+
+
+AdjacencyList::AdjacencyList (int n) : vertexNumber (n), offsets (n+1,0) {}
+
+
+AdjacencyList::AdjacencyList (int n, std::vector<unsigned long> &edges) : vertexNumber (n), offsets (n+1,0), neighbours (2*edges.size())
+{
+	for (unsigned long e = 0; e < edges.size(); e++)
+	{
+		offsets[(edges[e] >> 32) + 1]++;
+		offsets[(edges[e] & 0xffffffffUL) + 1]++;
+	}
+	for (int v = 0; v < vertexNumber; v++) { offsets[v+1] += offsets[v]; }
+
+	// Edges being sorted, smaller neighbours are written first, then greater ones, each in increasing order
+	std::vector<long> cursors (offsets.begin(), offsets.end()-1);
+	for (unsigned long e = 0; e < edges.size(); e++)
+	{
+		int v1 = edges[e] >> 32;
+		int v2 = edges[e] & 0xffffffffUL;
+		neighbours[cursors[v1]++] = v2;
+		neighbours[cursors[v2]++] = v1;
+	}
+}
+
+
+Graph *AdjacencyList::buildGraph (int size)
+{
+	if (size < vertexNumber) { size = vertexNumber; }
+	if (size > MAX_GRAPH_VERTICES) { std::cout << "ERROR: a graph of " << size << " vertices exceeds the limit of " << MAX_GRAPH_VERTICES << " vertices, keep its adjacency list instead!" << std::endl; return 0; }
+
+	Graph *graph = new Graph (size);
+	addToGraph(graph);
+	return graph;
+}
+
+
+void AdjacencyList::addToGraph (Graph *graph)
+{
+	int size = std::min(vertexNumber,graph->size);
+	for (int v = 0; v < size; v++)
+	{
+		VertexSet &adjacencySet = graph->adjacencySets[v];
+		for (long i = offsets[v]; i < offsets[v+1] && neighbours[i] < graph->size; i++) { adjacencySet.insert(neighbours[i]); }
+	}
+}
+
+
+void normalizeEdges (std::vector<unsigned long> &edges)
+{
+	edges.erase(std::remove_if(edges.begin(), edges.end(), [] (unsigned long e) { return (e >> 32) == (e & 0xffffffffUL); }), edges.end());
+	std::sort(edges.begin(), edges.end());
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+}
+
+
+/*!
+ * \brief Return true iff c separates the fields of an edge-list line, the separators being guessed from the first line (';' as in CSV files, else ',', else blanks)
+ */
+static inline bool isSeparator (char c, char separator)
+{
+	if (separator == ' ') { return c == ' ' || c == '\t'; }
+	return c == separator;
+}
+
+
+/*!
+ * \brief Parse a non-negative vertex index, returning -1 if the field is not a number or exceeds INT_MAX (edges are packed as two 32-bit indices)
+ */
+static inline long parseIndex (const char *begin, const char *end)
+{
+	if (begin == end) { return -1; }
+	long index = 0;
+	for (const char *c = begin; c != end; c++)
+	{
+		if (*c < '0' || *c > '9') { return -1; }
+		index = index * 10 + (*c - '0');
+		if (index > INT_MAX) { return -1; }
+	}
+	return index;
+}
+
+
+AdjacencyList *loadEdgeList (std::string fileName, InternTable *labels, bool addLabels, bool map)
+{
+	FileContent content;
+	if (!content.open(fileName,map)) { std::cout << "ERROR: cannot read " << fileName << "!" << std::endl; return 0; }
+
+	const char *p = content.data;
+	const char *end = content.data + content.length;
+
+	char separator = ' ';
+	const char *lineEnd = (const char *) memchr(p,'\n',end-p);
+	if (lineEnd == 0) { lineEnd = end; }
+	if (memchr(p,';',lineEnd-p) != 0) { separator = ';'; }
+	else if (memchr(p,',',lineEnd-p) != 0) { separator = ','; }
+
+	std::vector<unsigned long> edges;
+	edges.reserve(content.length / 8);
+	long maxIndex = -1;
+	if (labels != 0 && addLabels) { labels->reserve(labels->size() + content.length / 32); }
+
+	while (p < end)
+	{
+		lineEnd = (const char *) memchr(p,'\n',end-p);
+		if (lineEnd == 0) { lineEnd = end; }
+		const char *last = lineEnd;
+		if (last > p && last[-1] == '\r') { last--; }
+
+		if (p < last && *p != '#' && *p != '%')
+		{
+			// Two first fields of the line
+			const char *fields [4];
+			int f = 0;
+			const char *c = p;
+			while (f < 4 && c < last)
+			{
+				if (separator == ' ') { while (c < last && isSeparator(*c,separator)) { c++; } }
+				fields[f++] = c;
+				while (c < last && !isSeparator(*c,separator)) { c++; }
+				fields[f++] = c;
+				if (c < last) { c++; }
+			}
+
+			if (f == 4 && fields[0] < fields[1] && fields[2] < fields[3])
+			{
+				long v1, v2;
+				if (labels == 0)
+				{
+					v1 = parseIndex(fields[0],fields[1]);
+					v2 = parseIndex(fields[2],fields[3]);
+				}
+				else if (addLabels)
+				{
+					v1 = labels->intern(std::string_view (fields[0],fields[1]-fields[0]));
+					v2 = labels->intern(std::string_view (fields[2],fields[3]-fields[2]));
+				}
+				else
+				{
+					v1 = labels->find(std::string_view (fields[0],fields[1]-fields[0]));
+					v2 = labels->find(std::string_view (fields[2],fields[3]-fields[2]));
+				}
+
+				if (v1 >= 0 && v2 >= 0)
+				{
+					edges.push_back(packEdge(v1,v2));
+					maxIndex = std::max(maxIndex,std::max(v1,v2));
+				}
+			}
+		}
+
+		p = lineEnd + 1;
+	}
+
+	normalizeEdges(edges);
+	int vertexNumber = (labels != 0) ? labels->size() : maxIndex + 1;
+	return new AdjacencyList (vertexNumber, edges);
+}
+
+
+static const char CSR_MAGIC [4] = {'C','S','R','G'};
+
+
+AdjacencyList *loadCSR (std::string fileName, bool map)
+{
+	FileContent content;
+	if (!content.open(fileName,map)) { std::cout << "ERROR: cannot read " << fileName << "!" << std::endl; return 0; }
+
+	int vertexNumber;
+	long entryNumber;
+	size_t headerLength = sizeof(CSR_MAGIC) + sizeof(vertexNumber) + sizeof(entryNumber);
+
+	if (content.length < headerLength || memcmp(content.data,CSR_MAGIC,sizeof(CSR_MAGIC)) != 0)
+	{ std::cout << "ERROR: " << fileName << " is not a CSR graph file!" << std::endl; return 0; }
+
+	const char *p = content.data + sizeof(CSR_MAGIC);
+	memcpy(&vertexNumber,p,sizeof(vertexNumber)); p += sizeof(vertexNumber);
+	memcpy(&entryNumber,p,sizeof(entryNumber)); p += sizeof(entryNumber);
+
+	if (vertexNumber < 0 || entryNumber < 0 || content.length != headerLength + (vertexNumber+1) * sizeof(long) + entryNumber * sizeof(int))
+	{ std::cout << "ERROR: " << fileName << " is a truncated CSR graph file!" << std::endl; return 0; }
+
+	AdjacencyList *list = new AdjacencyList (vertexNumber);
+	list->neighbours.resize(entryNumber);
+	memcpy(list->offsets.data(),p,(vertexNumber+1) * sizeof(long)); p += (vertexNumber+1) * sizeof(long);
+	memcpy(list->neighbours.data(),p,entryNumber * sizeof(int));
+
+	bool consistent = (list->offsets[0] == 0 && list->offsets[vertexNumber] == entryNumber);
+	for (int v = 0; consistent && v < vertexNumber; v++) { consistent = (list->offsets[v] <= list->offsets[v+1]); }
+	if (!consistent)
+	{ std::cout << "ERROR: " << fileName << " has inconsistent offsets!" << std::endl; delete list; return 0; }
+
+	for (long e = 0; e < entryNumber; e++)
+	{
+		if (list->neighbours[e] < 0 || list->neighbours[e] >= vertexNumber)
+		{ std::cout << "ERROR: " << fileName << " has a neighbour out of range!" << std::endl; delete list; return 0; }
+	}
+
+	return list;
+}
+
+
+bool saveCSR (AdjacencyList *list, std::string fileName)
+{
+	std::ofstream file (fileName.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+	if (!file.good()) { std::cout << "ERROR: cannot write " << fileName << "!" << std::endl; return false; }
+
+	long entryNumber = list->neighbours.size();
+	file.write(CSR_MAGIC,sizeof(CSR_MAGIC));
+	file.write((const char *) &list->vertexNumber,sizeof(list->vertexNumber));
+	file.write((const char *) &entryNumber,sizeof(entryNumber));
+	file.write((const char *) list->offsets.data(),list->offsets.size() * sizeof(long));
+	file.write((const char *) list->neighbours.data(),entryNumber * sizeof(int));
+	file.close();
+
+	return !file.fail();
+}
@@ -0,0 +1,142 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_GRAPH_LOADER
+#define INCLUDE_GRAPH_LOADER
+
+#include <string>
+#include <vector>
+
+#include "intern_table.hpp"
+
+/*!
+ * \file graph_loader.hpp
+ * \brief Loaders of large graphs from edge-list and binary CSR (compressed sparse row) files, building the adjacency in one pass
+ * \author Robin Lamarche-Perrin
+ * \date 06/11/2015
+ */
+
+
+class Graph;
+
+
+/*!
+ * \brief The maximal number of vertices of a Graph built by AdjacencyList::buildGraph (adjacency sets of a Graph are bitsets, so that this bound already takes 512 MB)
+ */
+const int MAX_GRAPH_VERTICES = 65536;
+
+
+/*!
+ * \class AdjacencyList
+ * \brief Undirected simple graph in CSR form: the neighbours of vertex v are neighbours[offsets[v]] to neighbours[offsets[v+1]-1], in increasing order
+ */
+class AdjacencyList
+{
+public:
+	int vertexNumber; /** \brief Number of vertices */
+	std::vector<long> offsets; /** \brief Offset of the neighbours of each vertex (vertexNumber+1 values) */
+	std::vector<int> neighbours; /** \brief Concatenated neighbours of all vertices (each edge appears twice) */
+
+	/*!
+	 * \brief Constructor
+	 * \param vertexNumber : Number of vertices
+	 * \param edges : Edges packed as (min << 32 | max), sorted and without duplicates nor loops (see packEdge)
+	 */
+	AdjacencyList (int vertexNumber, std::vector<unsigned long> &edges);
+
+	/*!
+	 * \brief Constructor of an empty graph
+	 */
+	AdjacencyList (int vertexNumber = 0);
+
+	long getEdgeNumber () { return neighbours.size() / 2; }
+
+	/*!
+	 * \brief Build a Graph with the same adjacency (warning: adjacency sets of a Graph are bitsets, of quadratic size in the number of vertices)
+	 * \param size : Number of vertices of the graph (at least vertexNumber; 0 for vertexNumber)
+	 * \return The graph, or 0 if it would have more than MAX_GRAPH_VERTICES vertices
+	 */
+	Graph *buildGraph (int size = 0);
+
+	/*!
+	 * \brief Add the edges to an existing graph (vertices out of the graph are ignored)
+	 */
+	void addToGraph (Graph *graph);
+};
+
+
+/*!
+ * \brief Pack an undirected edge in a single word, so that a set of edges can be sorted and deduplicated in bulk
+ */
+inline unsigned long packEdge (int v1, int v2)
+{
+	if (v1 > v2) { int v = v1; v1 = v2; v2 = v; }
+	return ((unsigned long) v1 << 32) | (unsigned int) v2;
+}
+
+
+/*!
+ * \brief Sort and deduplicate packed edges, removing loops
+ */
+void normalizeEdges (std::vector<unsigned long> &edges);
+
+/*!
+ * \brief Load a graph from an edge-list file (one edge per line, two fields separated by ';', ',', spaces or tabs, lines starting with '#' or '%' being ignored)
+ * \param fileName : The edge-list file
+ * \param labels : If null, fields are vertex indexes; otherwise, fields are labels mapped to indexes through this table (shared, e.g., with a Dataset)
+ * \param addLabels : If false, edges with a label that is not in the table are ignored
+ * \param map : If true, the file is memory-mapped instead of being read into a buffer
+ * \return The adjacency of the graph, or 0 if the file cannot be read
+ */
+AdjacencyList *loadEdgeList (std::string fileName, InternTable *labels = 0, bool addLabels = true, bool map = true);
+
+/*!
+ * \brief Load a graph from a binary CSR file written by saveCSR
+ * \param fileName : The binary file
+ * \param map : If true, the file is memory-mapped instead of being read into a buffer
+ * \return The adjacency of the graph, or 0 if the file cannot be read
+ */
+AdjacencyList *loadCSR (std::string fileName, bool map = true);
+
+/*!
+ * \brief Save a graph in a binary CSR file: the "CSRG" magic number, the number of vertices (int32) and of neighbour entries (int64), then the offsets (int64) and the neighbours (int32)
+ * \return false if the file cannot be written
+ */
+bool saveCSR (AdjacencyList *list, std::string fileName);
+
+
+#endif
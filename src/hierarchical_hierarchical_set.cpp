@@ -134,7 +134,7 @@ void HierarchicalHierarchicalSet::buildDataStructure ()
 
 void HierarchicalHierarchicalSet::print () { hyperarchy->print(); }
 void HierarchicalHierarchicalSet::computeObjectiveValues () { objective->computeObjectiveValues(); hyperarchy->computeObjectiveValues(); }
-void HierarchicalHierarchicalSet::normalizeObjectiveValues () { hyperarchy->normalizeObjectiveValues(); }
+void HierarchicalHierarchicalSet::normalizeObjectiveValues () { objective->normalizeObjectiveValues(hyperarchy->value); }
 void HierarchicalHierarchicalSet::printObjectiveValues () { hyperarchy->printObjectiveValues(); }
 void HierarchicalHierarchicalSet::computeOptimalPartition (double parameter) { hyperarchy->computeOptimalPartition(parameter); }
 void HierarchicalHierarchicalSet::printOptimalPartition (double parameter) { hyperarchy->printOptimalPartition(parameter); }
@@ -239,19 +239,6 @@ void HHNode::computeObjectiveValues ()
 }
 
 
-void HHNode::normalizeObjectiveValues (ObjectiveValue *maxQual)
-{
-	if (maxQual == 0) { maxQual = value; }
-
-	if (node1->level == 0)
-		for (HHNodeSet::iterator it = children2->begin(); it != children2->end(); ++it) { (*it)->normalizeObjectiveValues(maxQual); }
-	
-	for (HHNodeSet::iterator it = children1->begin(); it != children1->end(); ++it) { (*it)->normalizeObjectiveValues(maxQual); }
-
-	value->normalize(maxQual);
-}
-
-
 void HHNode::printObjectiveValues ()
 {
 	if (node1->level == 0)
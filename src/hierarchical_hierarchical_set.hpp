@@ -95,7 +95,6 @@ class HHNode
 		
 		void buildDataStructure (); // SUPPRESS ?
 		void computeObjectiveValues ();
-		void normalizeObjectiveValues (ObjectiveValue *maxQual = 0);
 		void printObjectiveValues ();
 
 		void computeOptimalPartition (double parameter);
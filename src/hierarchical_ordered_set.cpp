@@ -64,7 +64,7 @@ void HierarchicalOrderedSet::setObjectiveFunction (ObjectiveFunction *m)
 void HierarchicalOrderedSet::buildDataStructure () { hierarchy->buildDataStructure(); }
 void HierarchicalOrderedSet::print () { hierarchy->print(); }
 void HierarchicalOrderedSet::computeObjectiveValues () { objective->computeObjectiveValues(); hierarchy->computeObjectiveValues(); }
-void HierarchicalOrderedSet::normalizeObjectiveValues () { hierarchy->normalizeObjectiveValues(); }
+void HierarchicalOrderedSet::normalizeObjectiveValues () { objective->normalizeObjectiveValues(hierarchy->qualities[hierarchy->getIndex(0,hierarchy->size-1)]); }
 void HierarchicalOrderedSet::printObjectiveValues () { hierarchy->printObjectiveValues(); }
 void HierarchicalOrderedSet::computeOptimalPartition (double parameter) { hierarchy->computeOptimalPartition(parameter); }
 void HierarchicalOrderedSet::printOptimalPartition (double parameter) { hierarchy->printOptimalPartition(parameter); }
@@ -208,18 +208,6 @@ void HONode::computeObjectiveValues ()
 }
 
 
-void HONode::normalizeObjectiveValues (ObjectiveValue *maxQual)
-{
-	if (maxQual == 0) { maxQual = qualities[getIndex(0,size-1)]; }
-
-	for (HONodeSet::iterator it = children->begin(); it != children->end(); ++it) { (*it)->normalizeObjectiveValues(maxQual); }
-
-	for (int j = 0; j < size; j++)
-		for (int i = 0; i < size-j; i++)
-			qualities[getIndex(i,j)]->normalize(maxQual);
-}
-
-
 void HONode::printObjectiveValues ()
 {
 	for (int i = 0; i < level; i++) { std::cout << "..."; }
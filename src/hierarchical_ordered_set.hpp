@@ -93,7 +93,6 @@ class HONode
 		
 		void buildDataStructure (int level = 0);
 		void computeObjectiveValues ();
-		void normalizeObjectiveValues (ObjectiveValue *maxQual = 0);
 		void printObjectiveValues ();
 
 		void computeOptimalPartition (double parameter);
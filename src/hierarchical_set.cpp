@@ -62,7 +62,7 @@ void HierarchicalSet::setObjectiveFunction (ObjectiveFunction *m)
 void HierarchicalSet::buildDataStructure () { hierarchy->buildDataStructure(); }
 void HierarchicalSet::print () { hierarchy->print(); }
 void HierarchicalSet::computeObjectiveValues () { objective->computeObjectiveValues(); hierarchy->computeObjectiveValues(); }
-void HierarchicalSet::normalizeObjectiveValues () { hierarchy->normalizeObjectiveValues(); }
+void HierarchicalSet::normalizeObjectiveValues () { objective->normalizeObjectiveValues(hierarchy->value); }
 void HierarchicalSet::printObjectiveValues () { hierarchy->printObjectiveValues(); }
 void HierarchicalSet::computeOptimalPartition (double parameter) { hierarchy->computeOptimalPartition(parameter); }
 void HierarchicalSet::printOptimalPartition (double parameter) { hierarchy->printOptimalPartition(parameter); }
@@ -176,15 +176,6 @@ void HNode::computeObjectiveValues ()
 }
 
 
-void HNode::normalizeObjectiveValues (ObjectiveValue *maxQual)
-{
-	if (maxQual == 0) { maxQual = value; }
-
-	for (HNodeSet::iterator it = children->begin(); it != children->end(); ++it) { (*it)->normalizeObjectiveValues(maxQual); }
-	value->normalize(maxQual);
-}
-
-
 void HNode::printObjectiveValues ()
 {
 	printIndices();
@@ -95,7 +95,6 @@ class HNode
 		
 		void buildDataStructure (HNode *root = 0, int level = 0, int num = 0);
 		void computeObjectiveValues ();
-		void normalizeObjectiveValues (ObjectiveValue *maxQual = 0);
 		void printObjectiveValues ();
 
 		void computeOptimalPartition (double parameter);
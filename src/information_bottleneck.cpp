@@ -39,34 +39,89 @@
 #include <iostream>
 #include <iomanip>
 #include <math.h>
+#include <algorithm>
 
-#include "bottleneck_objective.hpp"
+#include "information_bottleneck.hpp"
 
 
-InformationBottleneck::InformationBottleneck (MarkovProcess *p)
+InformationBottleneck::InformationBottleneck (MarkovProcess *p, int d, int t)
 {
 	process = p;
+	delay = d;
+	time = t;
 	maximize = false;
+
+	successors = 0;
+	copiedSuccessors = false;
 }
 
 
-InformationBottleneck::~InformationBottleneck () {}
+InformationBottleneck::~InformationBottleneck () { if (copiedSuccessors) { delete successors; } }
 
 
 void InformationBottleneck::setRandom () {}
 
 
-ObjectiveValue *InformationBottleneck::newObjectiveValue (int id)
+ObjectiveValue *InformationBottleneck::newObjectiveValue (int id) { return new BottleneckObjectiveValue(this,id); }
+
+
+void InformationBottleneck::computeObjectiveValues ()
 {
-	BottleneckObjectiveValue *rq;
-	
-	rq = new BottleneckObjectiveValue(this,id);
-	valueSet->insert(rq);
+	// Distributions are computed only once for all objectives using the Markov process, but copied since its cache may release them
+	int nextTime = time + delay;
+	if (time == -1) { nextTime = -1; }
+
+	double *distribution = process->getDistribution(time);
+	currentDistribution.assign(distribution,distribution+process->size);
+	distribution = process->getDistribution(nextTime);
+	nextDistribution.assign(distribution,distribution+process->size);
+
+	// Without a sparse kernel, the successors of each state are extracted once from the dense one
+	if (successors != 0) { return; }
+	if (process->sparseSuccessors != 0) { successors = process->sparseSuccessors; return; }
+
+	int size = process->size;
+	double *transition = process->getTransition(1);
+	std::vector< std::pair<int,double> > entries;
+	successors = new SparseMatrix(size);
+	copiedSuccessors = true;
+	for (int i = 0; i < size; i++)
+	{
+		entries.clear();
+		for (int j = 0; j < size; j++) { if (transition[(long) j*size+i] > 0) { entries.push_back(std::make_pair(j,transition[(long) j*size+i])); } }
+		successors->addRow(entries);
+	}
+}
 
-	return rq;
+
+void InformationBottleneck::getJointDistribution (int k, double pk, SparseDistribution &pkj)
+{
+	// The successors of each reached state are collected, then the probabilities of the same next state are summed
+	pkj.assign(1,std::make_pair(k,pk));
+	SparseDistribution next;
+	for (int d = 0; d < delay; d++)
+	{
+		next.clear();
+		for (SparseDistribution::iterator it = pkj.begin(); it != pkj.end(); ++it)
+			for (long e = successors->offsets[it->first]; e < successors->offsets[it->first+1]; e++)
+				if (successors->values[e] > 0) { next.push_back(std::make_pair(successors->columns[e],it->second * successors->values[e])); }
+
+		std::sort(next.begin(),next.end());
+		pkj.clear();
+		for (SparseDistribution::iterator it = next.begin(); it != next.end(); ++it)
+		{
+			if (!pkj.empty() && pkj.back().first == it->first) { pkj.back().second += it->second; }
+			else { pkj.push_back(*it); }
+		}
+	}
 }
 
 
+void InformationBottleneck::normalizeObjectiveValues (ObjectiveValue *q) {}
+
+void InformationBottleneck::printObjectiveValues (bool v) {}
+
+
 double InformationBottleneck::getParameter (double unit)
 {
 	if (unit < 1) return unit / (1 - unit);
@@ -88,50 +143,40 @@ BottleneckObjectiveValue::BottleneckObjectiveValue (InformationBottleneck *m, in
 	pk = 0;
 	Iki = 0;
 	Ikj = 0;
+}
 
-	int size = ((InformationBottleneck*)objective)->process->size;
-	pkj = new double [size]; pj = new double [size];
-	for (int i = 0; i < size; i++) { pkj[i] = 0; pj[i] = 0; }
+
+BottleneckObjectiveValue::~BottleneckObjectiveValue () {}
+
+
+bool BottleneckObjectiveValue::equal (ObjectiveValue *q, int prec)
+{
+	double factor = pow(10,prec);
+	BottleneckObjectiveValue *value = (BottleneckObjectiveValue *) q;
+	return (round(Iki*factor) == round(value->Iki*factor) && round(Ikj*factor) == round(value->Ikj*factor));
 }
 
 
 void BottleneckObjectiveValue::add (ObjectiveValue *q)
 {
 	BottleneckObjectiveValue *value = (BottleneckObjectiveValue *) q;
-	int size = ((InformationBottleneck*)value->objective)->process->size;
 
 	pk += value->pk;
 	Iki += value->Iki;
 	Ikj += value->Ikj;
-	for (int i = 0; i < size; i++)
-	{
-		pkj[i] += value->pkj[i];
-		pj[i] += value->pj[i];
-	}
-}
-
-
-BottleneckObjectiveValue::~BottleneckObjectiveValue ()
-{
-	delete[] pkj;
-	delete[] pj;
+	merge(pkj,value->pkj);
 }
 
 
 void BottleneckObjectiveValue::compute ()
 {
-	MarkovProcess *process = ((InformationBottleneck*)objective)->process;
-	int size = process->size;
+	InformationBottleneck *m = (InformationBottleneck*) objective;
 
-	for (int j = 0; j < size; j++) { pj[j] = 0; }
-	for (int i = 0; i < size; i++)
-	{
-		double pi = process->distribution[i];
-		for (int j = 0; j < size; j++) { pj[j] += pi * process->transition[j*size+i]; }
-	}
-		
-	pk = process->distribution[index];
-	for (int j = 0; j < size; j++) { pkj[j] = process->distribution[index] * process->transition[j*size+index]; }
+	pk = m->currentDistribution[index];
+	pkj.clear();
+	if (pk > 0) { m->getJointDistribution(index,pk,pkj); }
+
+	computeInformation();
 }
 
 
@@ -140,47 +185,84 @@ void BottleneckObjectiveValue::compute (ObjectiveValue *q1, ObjectiveValue *q2)
 	BottleneckObjectiveValue *rq1 = (BottleneckObjectiveValue *) q1;
 	BottleneckObjectiveValue *rq2 = (BottleneckObjectiveValue *) q2;
 
-	MarkovProcess *process = ((InformationBottleneck*)objective)->process;
-	int size = process->size;
-	
-	for (int j = 0; j < size; j++) { pj[j] = rq1->pj[j]; }
 	pk = rq1->pk + rq2->pk;
-	for (int j = 0; j < size; j++) { pkj[j] = rq1->pkj[j] + rq2->pkj[j]; }
+	pkj = rq1->pkj;
+	merge(pkj,rq2->pkj);
 
-	Iki = 0;
-	if (pk > 0) { Iki = - pk * log2 (pk); }
-			
-	Ikj = Iki;
-	for (int j = 0; j < size; j++)
+	computeInformation();
+}
+
+
+void BottleneckObjectiveValue::compute (ObjectiveValueSet *valueSet)
+{
+	pk = 0;
+	pkj.clear();
+	for (ObjectiveValueSet::iterator it = valueSet->begin(); it != valueSet->end(); ++it)
 	{
-		if (pkj[j] > 0) { Ikj += pkj[j] * log2 (pkj[j]); }
-		if (pj[j] > 0) { Ikj -= pkj[j] * log2 (pj[j]); }
+		BottleneckObjectiveValue *rq = (BottleneckObjectiveValue *) (*it);
+		pk += rq->pk;
+		merge(pkj,rq->pkj);
 	}
+
+	computeInformation();
 }
 
 
-void BottleneckObjectiveValue::compute (ObjectiveValueSet *valueSet)
+void BottleneckObjectiveValue::merge (SparseDistribution &dist1, SparseDistribution &dist2)
 {
+	if (dist2.empty()) { return; }
+	if (dist1.empty()) { dist1 = dist2; return; }
+
+	SparseDistribution dist;
+	dist.reserve(dist1.size() + dist2.size());
+
+	SparseDistribution::iterator it1 = dist1.begin();
+	SparseDistribution::iterator it2 = dist2.begin();
+	while (it1 != dist1.end() && it2 != dist2.end())
+	{
+		if (it1->first < it2->first) { dist.push_back(*it1); ++it1; }
+		else if (it2->first < it1->first) { dist.push_back(*it2); ++it2; }
+		else { dist.push_back(std::make_pair(it1->first,it1->second + it2->second)); ++it1; ++it2; }
+	}
+	dist.insert(dist.end(),it1,dist1.end());
+	dist.insert(dist.end(),it2,dist2.end());
+
+	dist1.swap(dist);
 }
 
 
-void BottleneckObjectiveValue::normalize (ObjectiveValue *q) {}
+void BottleneckObjectiveValue::computeInformation ()
+{
+	std::vector<double> &pj = ((InformationBottleneck*)objective)->nextDistribution;
+
+	Iki = 0;
+	Ikj = 0;
+	if (pk > 0)
+	{
+		Iki = - pk * log2 (pk);
+		for (SparseDistribution::iterator it = pkj.begin(); it != pkj.end(); ++it)
+			if (pj[it->first] > 0) { Ikj += it->second * log2 (it->second / (pk * pj[it->first])); }
+	}
+}
 
 
 void BottleneckObjectiveValue::print (bool v)
 {
 	if (v)
 	{
-		std::cout << "   Iki = " << std::setw(6) << std::setprecision(3) << Iki
+		std::cout << "pk = " << std::setw(6) << std::setprecision(3) << pk
+		<< "   Iki = " << std::setw(6) << std::setprecision(3) << Iki
 		<< "   Ikj = " << std::setw(6) << std::setprecision(3) << Ikj << std::endl;
 	}
-	else { std::cout << std::endl; }
+	else { std::cout << "pk = " << std::setw(6) << std::setprecision(3) << pk; }
 }
 
 
+void BottleneckObjectiveValue::release () { SparseDistribution().swap(pkj); }
+
+
 double BottleneckObjectiveValue::getValue (double param)
 {
 	if (param >= 0) return Iki - param * Ikj;
 	return -Ikj;
 }
-
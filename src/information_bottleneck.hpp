@@ -38,23 +38,48 @@
 #ifndef INCLUDE_INFORMATION_BOTTLENECK
 #define INCLUDE_INFORMATION_BOTTLENECK
 
+#include <vector>
+
 #include "objective_function.hpp"
 #include "markov_process.hpp"
 
+/*!
+ * \brief Sparse representation of the joint probabilities p(k,j) between a subset of current states k and all next states j (pairs of next state and probability, sorted by next state, zero probabilities omitted)
+ */
+typedef std::vector< std::pair<int,double> > SparseDistribution;
+
 class InformationBottleneck: public ObjectiveFunction
 {
 	public:
 		MarkovProcess *process;
+		int delay; /** \brief Delay between the current states and the predicted next states */
+		int time; /** \brief Time of the current state distribution (-1 for the stationary distribution) */
+
+		std::vector<double> currentDistribution; /** \brief Distribution of current states, copied from the Markov process (whose cache may evict it) */
+		std::vector<double> nextDistribution; /** \brief Distribution of next states, copied from the Markov process */
+		SparseMatrix *successors; /** \brief One-step kernel, one row of successors per current state: the sparse kernel of the process, or else a sparse copy of its dense kernel */
+		bool copiedSuccessors; /** \brief True if successors is a copy owned by the objective */
 		
-		InformationBottleneck (MarkovProcess *process);
+		InformationBottleneck (MarkovProcess *process, int delay = 1, int time = 0);
 		~InformationBottleneck ();
 		
 		void setRandom ();
 		ObjectiveValue *newObjectiveValue (int index = -1);
+		void computeObjectiveValues ();
+		void normalizeObjectiveValues (ObjectiveValue *q);
+		void printObjectiveValues (bool verbose = true);
 
 		double getParameter (double unit);
 		double getUnitDistance (double uMin, double uMax);
 		double getIntermediaryUnit (double uMin, double uMax);
+
+		/*!
+		 * \brief Compute the joint probabilities p(k,j) of a current state k and of the next states j, by propagating the sparse one-step kernel delay times from k (the kernel for the given delay is never built)
+		 * \param state : The current state k
+		 * \param probability : The probability p(k) of the current state
+		 * \param pkj : The sparse distribution to fill
+		 */
+		void getJointDistribution (int state, double probability, SparseDistribution &pkj);
 };
 
 
@@ -63,21 +88,25 @@ class BottleneckObjectiveValue: public ObjectiveValue
 	public:
 		int index;
 		double pk;
-		double *pkj;
-		double *pj;
+		SparseDistribution pkj;
 		double Iki;
 		double Ikj;
 
 		BottleneckObjectiveValue (InformationBottleneck *objective, int index = -1);
 		~BottleneckObjectiveValue ();
 		
+		bool equal (ObjectiveValue *value, int prec = 15);
 		void add (ObjectiveValue *value);
 		void compute ();
 		void compute (ObjectiveValue *value1, ObjectiveValue *value2);
 		void compute (ObjectiveValueSet *valueSet);
-		void normalize (ObjectiveValue *q);
 		void print (bool verbose = true);
 		double getValue (double param);
+		void release ();
+
+	private:
+		void merge (SparseDistribution &dist1, SparseDistribution &dist2);
+		void computeInformation ();
 };
 
 
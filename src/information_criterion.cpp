@@ -44,31 +44,7 @@
 #include "information_criterion.hpp"
 
 
-InformationCriterion::InformationCriterion (int s, double *val, double *refVal)
-{
-	size = s;
-	maximize = true;
-	values = new double [size];
-	refValues = new double [size];
-
-	if (val != 0) { for (int i = 0; i < size; i++) { values[i] = val[i]; } }
-	if (refVal != 0 && val != 0) { for (int i = 0; i < size; i++) { refValues[i] = refVal[i]; } }
-	if (refVal == 0 && val != 0) { for (int i = 0; i < size; i++) { refValues[i] = 1; } }
-}
-
-
-InformationCriterion::~InformationCriterion ()
-{
-	delete[] values;
-	delete[] refValues;
-}
-
-
-void InformationCriterion::setRandom ()
-{
-	for (int i = 0; i < size; i++) { values[i] = rand() % 1024; }
-	for (int i = 0; i < size; i++) { refValues[i] = 1; }
-}
+InformationCriterion::InformationCriterion (int s, double *val, double *refVal) : RelativeEntropy (s, val, refVal) {}
 
 
 ObjectiveValue *InformationCriterion::newObjectiveValue (int id)
@@ -82,9 +58,7 @@ ObjectiveValue *InformationCriterion::newObjectiveValue (int id)
 }
 
 
-void InformationCriterion::computeObjectiveValues () {};
-
-void InformationCriterion::printObjectiveValues (bool v) {};
+void InformationCriterion::normalizeObjectiveValues (ObjectiveValue *q) {}
 
 double InformationCriterion::getParameter (double unit)
 {
@@ -92,26 +66,9 @@ double InformationCriterion::getParameter (double unit)
 	else return -1;
 }
 
-double InformationCriterion::getUnitDistance (double uMin, double uMax) { return uMax - uMin; }
 
-double InformationCriterion::getIntermediaryUnit (double uMin, double uMax) { return uMin + (uMax - uMin) / 2; }
 
-
-
-CriterionObjectiveValue::CriterionObjectiveValue (InformationCriterion *m, int id)
-{
-	objective = m;
-	index = id;
-	
-	sumValue = 0;
-	sumRefValue = 0;
-	microInfo = 0;
-	divergence = 0;
-	size = 0;
-}
-
-
-CriterionObjectiveValue::~CriterionObjectiveValue () {}
+CriterionObjectiveValue::CriterionObjectiveValue (InformationCriterion *m, int id) : RelativeObjectiveValue (m, id) {}
 
 
 bool CriterionObjectiveValue::equal (ObjectiveValue *q, int prec)
@@ -122,67 +79,6 @@ bool CriterionObjectiveValue::equal (ObjectiveValue *q, int prec)
 }
 
 
-void CriterionObjectiveValue::add (ObjectiveValue *q)
-{
-	CriterionObjectiveValue *value = (CriterionObjectiveValue *) q;
-	
-	sumValue += value->sumValue;
-	sumRefValue += value->sumRefValue;
-	microInfo += value->microInfo;
-	divergence += value->divergence;
-	size += value->size;
-}
-
-
-void CriterionObjectiveValue::compute ()
-{
-	sumValue = ((InformationCriterion*)objective)->values[index];
-	sumRefValue = ((InformationCriterion*)objective)->refValues[index];
-	if (sumValue > 0) { microInfo = - sumValue * log2(sumValue/sumRefValue); } else { microInfo = 0; }
-	size = 1;
-	divergence = 0;
-}
-
-
-void CriterionObjectiveValue::compute (ObjectiveValue *q1, ObjectiveValue *q2)
-{
-	CriterionObjectiveValue *rq1 = (CriterionObjectiveValue *) q1;
-	CriterionObjectiveValue *rq2 = (CriterionObjectiveValue *) q2;
-
-	sumValue = rq1->sumValue + rq2->sumValue;
-	sumRefValue = rq1->sumRefValue + rq2->sumRefValue;
-	microInfo = rq1->microInfo + rq2->microInfo;
-	size = rq1->size + rq2->size;
-	
-	if (sumValue > 0) { divergence = - microInfo - sumValue * log2(sumValue/sumRefValue); }
-	else { divergence = 0; }
-}
-
-
-void CriterionObjectiveValue::compute (ObjectiveValueSet *valueSet)
-{
-	sumValue = 0;
-	sumRefValue = 0;
-	microInfo = 0;
-	size = 0;
-	for (ObjectiveValueSet::iterator it = valueSet->begin(); it != valueSet->end(); ++it)
-	{
-		CriterionObjectiveValue *rq = (CriterionObjectiveValue *) (*it);
-
-		sumValue += rq->sumValue;
-		sumRefValue += rq->sumRefValue;
-		microInfo += rq->microInfo;
-		size += rq->size;
-	}
-	
-	if (sumValue > 0) { divergence = - microInfo - sumValue * log2(sumValue/sumRefValue); }
-	else { divergence = 0; }
-}
-
-
-void CriterionObjectiveValue::normalize (ObjectiveValue *q) {}
-
-
 void CriterionObjectiveValue::print (bool v)
 {
 	if (v)
@@ -204,4 +100,3 @@ double CriterionObjectiveValue::getValue (double param)
 	if (param >= 0) return (size-1) - param * divergence;
 	return -divergence;
 }
-
@@ -39,48 +39,26 @@
 #define INCLUDE_INFORMATION_CRITERION
 
 
-#include "objective_function.hpp"
+#include "relative_entropy.hpp"
 
-class InformationCriterion: public ObjectiveFunction
+class InformationCriterion: public RelativeEntropy
 {
 public:
-	int size;
-	double *values;
-	double *refValues;
-		
 	InformationCriterion (int size, double *values = 0, double *refValues = 0);
-	~InformationCriterion ();
 		
-	void setRandom ();
 	ObjectiveValue *newObjectiveValue (int index = -1);
-	void computeObjectiveValues ();
-	void printObjectiveValues (bool verbose = true);
+	void normalizeObjectiveValues (ObjectiveValue *q);
 
 	double getParameter (double unit);
-	double getUnitDistance (double uMin, double uMax);
-	double getIntermediaryUnit (double uMin, double uMax);
 };
 
 
-class CriterionObjectiveValue: public ObjectiveValue
+class CriterionObjectiveValue: public RelativeObjectiveValue
 {
 public:
-	int index;
-	double sumValue;
-	double sumRefValue;
-	double microInfo;
-	double divergence;
-	int size;
-		
 	CriterionObjectiveValue (InformationCriterion *objective, int index = -1);
-	~CriterionObjectiveValue ();
 		
 	bool equal (ObjectiveValue *value, int prec = 15);
-	void add (ObjectiveValue *value);
-	void compute ();
-	void compute (ObjectiveValue *value1, ObjectiveValue *value2);
-	void compute (ObjectiveValueSet *valueset);
-	void normalize (ObjectiveValue *q);
 	void print (bool verbose = true);
 	double getValue (double param);
 };
@@ -0,0 +1,122 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdexcept>
+
+#include "intern_table.hpp"
+
+
+InternTable::InternTable () : slots (16, Slot {0,-1}) {}
+
+
+void InternTable::reserve (int size)
+{
+	labels.reserve(size);
+	unsigned long slotNumber = slots.size();
+	while (slotNumber < 2 * (unsigned long) size) { slotNumber *= 2; }
+	if (slotNumber > slots.size()) { grow(slotNumber); }
+}
+
+
+unsigned long InternTable::findSlot (std::string_view label, unsigned int hash) const
+{
+	unsigned long mask = slots.size() - 1;
+	unsigned long s = hash & mask;
+	while (slots[s].index != -1 && (slots[s].hash != hash || labels[slots[s].index] != label)) { s = (s + 1) & mask; }
+	return s;
+}
+
+
+void InternTable::grow (unsigned long slotNumber)
+{
+	std::vector<Slot> oldSlots (slotNumber, Slot {0,-1});
+	oldSlots.swap(slots);
+
+	unsigned long mask = slots.size() - 1;
+	for (unsigned long o = 0; o < oldSlots.size(); o++)
+	{
+		if (oldSlots[o].index == -1) { continue; }
+		unsigned long s = oldSlots[o].hash & mask;
+		while (slots[s].index != -1) { s = (s + 1) & mask; }
+		slots[s] = oldSlots[o];
+	}
+}
+
+
+int InternTable::add (std::string_view label)
+{
+	int index = labels.size();
+	labels.emplace_back(label);
+
+	// As with std::map::insert, a label that is already in the table keeps its first index
+	unsigned int hash = std::hash<std::string_view>() (label);
+	unsigned long s = findSlot(label,hash);
+	if (slots[s].index == -1)
+	{
+		slots[s] = Slot {hash,index};
+		if (2 * labels.size() > slots.size()) { grow(2 * slots.size()); }
+	}
+	return index;
+}
+
+
+int InternTable::intern (std::string_view label)
+{
+	unsigned int hash = std::hash<std::string_view>() (label);
+	unsigned long s = findSlot(label,hash);
+	if (slots[s].index != -1) { return slots[s].index; }
+
+	int index = labels.size();
+	labels.emplace_back(label);
+	slots[s] = Slot {hash,index};
+	if (2 * labels.size() > slots.size()) { grow(2 * slots.size()); }
+	return index;
+}
+
+
+int InternTable::find (std::string_view label) const
+{
+	return slots[findSlot(label,std::hash<std::string_view>() (label))].index;
+}
+
+
+int InternTable::at (std::string_view label) const
+{
+	int index = find(label);
+	if (index == -1) { throw std::out_of_range("InternTable::at"); }
+	return index;
+}
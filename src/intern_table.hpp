@@ -0,0 +1,111 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_INTERN_TABLE
+#define INCLUDE_INTERN_TABLE
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*!
+ * \file intern_table.hpp
+ * \brief Hashed two-way mapping between labels and contiguous indexes, shared by datasets and graph loaders
+ * \author Robin Lamarche-Perrin
+ * \date 06/11/2015
+ */
+
+
+/*!
+ * \class InternTable
+ * \brief Interns labels: each distinct label gets the index {0,...,size-1} in the order it has been added
+ *
+ * Lookups use an open-addressing table of (hash, index) slots, so that probing a label touches one slot and one stored label.
+ */
+class InternTable
+{
+public:
+	InternTable ();
+
+	/*!
+	 * \brief Return the number of labels in the table
+	 */
+	int size () const { return labels.size(); }
+
+	void reserve (int size);
+
+	/*!
+	 * \brief Append a label with the next index (if the label is already in the table, later lookups still return its first index)
+	 * \return The index of the appended label
+	 */
+	int add (std::string_view label);
+
+	/*!
+	 * \brief Return the index of a label, adding it to the table if it is not in it yet
+	 */
+	int intern (std::string_view label);
+
+	/*!
+	 * \brief Return the index of a label, or -1 if it is not in the table
+	 */
+	int find (std::string_view label) const;
+
+	/*!
+	 * \brief Return the index of a label (throws std::out_of_range if it is not in the table)
+	 */
+	int at (std::string_view label) const;
+
+	/*!
+	 * \brief Return the label of an index (throws std::out_of_range if there is no such index)
+	 */
+	const std::string &getLabel (int index) const { return labels.at(index); }
+
+private:
+	struct Slot { unsigned int hash; int index; };
+
+	std::vector<Slot> slots; /** \brief Open-addressing table (linear probing, power-of-two size, at most half full), index -1 for empty slots */
+	std::vector<std::string> labels; /** \brief Label of each index */
+
+	/*!
+	 * \brief Return the slot of a label: the slot holding it, or the empty slot where it should be inserted
+	 */
+	unsigned long findSlot (std::string_view label, unsigned int hash) const;
+	void grow (unsigned long slotNumber);
+};
+
+
+#endif
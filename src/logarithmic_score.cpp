@@ -122,6 +122,9 @@ void LogarithmicScore::computeObjectiveValues ()
 }
 
 
+void LogarithmicScore::normalizeObjectiveValues (ObjectiveValue *q) {}
+
+
 void LogarithmicScore::printObjectiveValues (bool v)
 {
 	if (v)
@@ -260,9 +263,6 @@ void LogarithmicScoreValue::compute (ObjectiveValueSet *valueSet)
 }
 
 
-void LogarithmicScoreValue::normalize (ObjectiveValue *q) {}
-
-
 void LogarithmicScoreValue::print (bool v)
 {
 	if (v)
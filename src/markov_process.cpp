@@ -46,57 +46,115 @@
 #include <stdlib.h>
 #include <map>
 #include <limits>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "markov_process.hpp"
+#include "matrix_tools.hpp"
 #include "csv_tools.hpp"
+#include "parallel_tools.hpp"
 
 
 
 
-MarkovProcess::MarkovProcess (int s)
+MarkovProcess::MarkovProcess (int s, bool dense)
 {
     size = s;
 
     distribution = new double [size];
-    distributions = new std::vector<double*>(1);
-    distributions->at(0) = distribution;
+    distributions = new std::map<int,double*>();
+    (*distributions)[0] = distribution;
     lastTime = 0;
+    stationaryDistribution = 0;
 
-    transition = new double [size*size];
-    transitions = new std::vector<double*>(2);
-    transitions->at(1) = transition;
+    transition = 0;
+    transitions = new std::map<int,double*>();
     lastDelay = 1;
-	
-    double *trivialTransition = new double [size*size];
-    for (int i = 0; i < size; i++)
-		for (int j = 0; j < size; j++)
-			if (i == j) { trivialTransition[j*size+i] = 1; } else { trivialTransition[j*size+i] = 0; }
-    transitions->at(0) = trivialTransition;
+
+    cacheBudget = 0;
+    checkpointInterval = 0;
+    cachedBytes = 0;
+
+    sparseTransition = 0;
+    sparseSuccessors = 0;
+
+    transitionSampler = 0;
+    distributionSampler = 0;
+    samplerTime = -2;
+
+    if (dense) { allocateTransition(); }
+}
+
+
+void MarkovProcess::allocateTransition ()
+{
+    transition = new double [(long) size*size];
+    (*transitions)[1] = transition;
 }
 
 
 MarkovProcess::~MarkovProcess ()
 {
     //delete[] distribution;
-	for (std::vector<double*>::iterator it = distributions->begin(); it != distributions->end(); ++it) { delete [] (*it); }
+	for (std::map<int,double*>::iterator it = distributions->begin(); it != distributions->end(); ++it) { delete [] it->second; }
     distributions->clear();
     delete distributions;
+    delete [] stationaryDistribution;
 
     //delete[] transition;
-	for (std::vector<double*>::iterator it = transitions->begin(); it != transitions->end(); ++it) { delete [] (*it); }
+	for (std::map<int,double*>::iterator it = transitions->begin(); it != transitions->end(); ++it) { delete [] it->second; }
     transitions->clear();
     delete transitions;	
+
+    delete sparseTransition;
+    delete sparseSuccessors;
+
+    clearSamplers();
+}
+
+
+void MarkovProcess::clearSamplers ()
+{
+    delete transitionSampler;
+    delete distributionSampler;
+    transitionSampler = 0;
+    distributionSampler = 0;
+    samplerTime = -2;
+}
+
+
+void MarkovProcess::setSparseTransition (SparseMatrix *successors)
+{
+    clearSamplers();
+    if (successors->getFill() > DENSE_FILL)
+    {
+		if (transition == 0) { allocateTransition(); }
+		SparseMatrix *trans = successors->transpose();
+		trans->toDense(transition);
+		delete trans;
+		delete successors;
+		return;
+    }
+
+    sparseSuccessors = successors;
+    sparseTransition = successors->transpose();
 }
 
 
 void MarkovProcess::setDistribution (double *array)
 {
+    clearSamplers();
     for (int i = 0; i < size; i++) { distribution[i] = array[i]; }
 }
 
 
 void MarkovProcess::setTransition (double *array)
 {
+    clearSamplers();
     for (int j = 0; j < size; j++)
     { 
 		for (int i = 0; i < size; i++) { transition[j*size+i] = array[j*size+i]; }
@@ -106,122 +164,315 @@ void MarkovProcess::setTransition (double *array)
 
 void MarkovProcess::setTransition (int i, double *array)
 {
+    clearSamplers();
     for (int j = 0; j < size; j++) { transition[j*size+i] = array[j]; }
 }
 
 
-double *MarkovProcess::getDistribution (int time)
+void MarkovProcess::setCacheBudget (long budget, int interval)
 {
-    if (time == -1) { return distributions->at(lastTime); }
-	
-    if (lastTime < time)
+    cacheBudget = budget;
+    checkpointInterval = interval;
+
+    // Entries that are still evictable keep their order, the other evictable ones are the least recently used
+    cachedBytes = 0;
+    for (std::list<int>::iterator it = cacheEntries.begin(); it != cacheEntries.end();)
     {
-		distributions->resize(time+1);
-		
-		double *currentDist = getDistribution(lastTime);
-		for (int t = lastTime + 1; t <= time; t++)
+		if (*it > 0 && isCheckpoint(*it)) { cacheEntryPositions.erase(*it); it = cacheEntries.erase(it); }
+		else { ++it; }
+    }
+    for (std::map<int,double*>::iterator it = distributions->begin(); it != distributions->end(); ++it)
+		if (!isCheckpoint(it->first))
 		{
-			if (VERBOSE) { std::cout << "Distribution " << t << std::endl; }
-			double *newDist = new double [size];
-			for (int i = 0; i < size; i++)
-			{
-				newDist[i] = 0;
-				for (int j = 0; j < size; j++) { newDist[i] += currentDist[j] * getNextProbability(i,j,1); }
-			}
-			distributions->at(t) = newDist;
-			currentDist = newDist;
+			cachedBytes += (long) size*sizeof(double);
+			if (cacheEntryPositions.count(it->first) == 0) { cacheEntryPositions[it->first] = cacheEntries.insert(cacheEntries.end(),it->first); }
+		}
+    for (std::map<int,double*>::iterator it = transitions->begin(); it != transitions->end(); ++it)
+		if (it->first > 1) { cachedBytes += (long) size*size*sizeof(double); }
+
+    evictCache();
+}
+
+
+void MarkovProcess::storeDistribution (int time, double *dist)
+{
+    (*distributions)[time] = dist;
+    if (!isCheckpoint(time)) { cachedBytes += (long) size*sizeof(double); touchCacheEntry(time); evictCache(); }
+}
+
+
+void MarkovProcess::storeTransition (int delay, double *trans)
+{
+    (*transitions)[delay] = trans;
+    if (delay > 1) { cachedBytes += (long) size*size*sizeof(double); touchCacheEntry(-delay); evictCache(); }
+}
+
+
+void MarkovProcess::touchCacheEntry (int key)
+{
+    std::unordered_map<int,std::list<int>::iterator>::iterator it = cacheEntryPositions.find(key);
+    if (it == cacheEntryPositions.end()) { cacheEntryPositions[key] = cacheEntries.insert(cacheEntries.begin(),key); }
+    else { cacheEntries.splice(cacheEntries.begin(),cacheEntries,it->second); }
+}
+
+
+void MarkovProcess::evictCache ()
+{
+    // Least recently used entries are at the back of the list, the PINNED_ENTRIES first ones being kept
+    int evictableNumber = (int) cacheEntries.size() - PINNED_ENTRIES;
+    std::list<int>::iterator it = cacheEntries.end();
+    while (cacheBudget > 0 && cachedBytes > cacheBudget && evictableNumber > 0)
+    {
+		--it;
+		evictableNumber--;
+		int key = *it;
+		if (key < 0 && std::find(lockedDelays.begin(),lockedDelays.end(),-key) != lockedDelays.end()) { continue; }
+
+		if (key < 0)
+		{
+			delete [] transitions->at(-key);
+			transitions->erase(-key);
+			cachedBytes -= (long) size*size*sizeof(double);
 		}
-		lastTime = time;
+		else
+		{
+			delete [] distributions->at(key);
+			distributions->erase(key);
+			cachedBytes -= (long) size*sizeof(double);
+		}
+		cacheEntryPositions.erase(key);
+		it = cacheEntries.erase(it);
     }
-	
-    return distributions->at(time);
 }
 
 
-void MarkovProcess::computeStationaryDistribution (double threshold)
+double *MarkovProcess::getDistribution (int time)
 {
-    if (lastTime == 0) { getDistribution(1); }
+    if (time == -1) { return (stationaryDistribution != 0) ? stationaryDistribution : getDistribution(lastTime); }
 	
-    double *dist1 = getDistribution(lastTime-1);
-    double *dist2 = getDistribution(lastTime);
+    if (lastTime < time) { lastTime = time; }
 
-    bool stationary = true;
-    for (int i = 0; i < size && stationary; i++) { stationary = std::abs(dist1[i] - dist2[i]) < threshold; }
-	
-    while (!stationary)
+    std::map<int,double*>::iterator it = distributions->lower_bound(time);
+    if (it != distributions->end() && it->first == time)
     {
-		dist1 = dist2;
-		dist2 = getDistribution(lastTime+1);
-		
-		stationary = true;
-		for (int i = 0; i < size && stationary; i++) { stationary = std::abs(dist1[i] - dist2[i]) < threshold; }
+		if (!isCheckpoint(time)) { touchCacheEntry(time); }
+		return it->second;
+    }
+
+    // Iterate from the closest previous distribution, only storing the checkpoints and the requested one (or all of them if there are no checkpoints)
+    --it;
+    int previousTime = it->first;
+    std::vector<double> buffers [2];
+    double *currentDist = it->second;
+    if (!isCheckpoint(previousTime)) { touchCacheEntry(previousTime); }
+    double *trans = (sparseTransition == 0) ? getTransition(1) : 0;
+    for (int t = previousTime + 1; t <= time; t++)
+    {
+		if (VERBOSE) { std::cout << "Distribution " << t << std::endl; }
+		bool stored = (t == time || checkpointInterval <= 0 || isCheckpoint(t));
+		double *newDist;
+		if (stored) { newDist = new double [size]; }
+		else { buffers[t%2].resize(size); newDist = buffers[t%2].data(); }
+
+		if (sparseTransition != 0) { sparseTransition->multiplyVector(currentDist,newDist); }
+		else { multiplyMatrixVector(trans,currentDist,newDist,size); }
+
+		if (stored) { storeDistribution(t,newDist); }
+		currentDist = newDist;
     }
+	
+    return distributions->at(time);
 }
 
 
-MarkovTrajectory *MarkovProcess::computeTrajectory (int time, int length)
+int MarkovProcess::computeStationaryDistribution (double threshold, StationaryMethod method, int maxIterations)
 {
-    MarkovTrajectory *traj = new MarkovTrajectory(this,time,length);
+    if (stationaryDistribution == 0) { stationaryDistribution = new double [size]; }
+    double *dist = stationaryDistribution;
+    double *previousDist = new double [size];
+    double *lastDist = getDistribution(lastTime);
+    std::copy(lastDist, lastDist + size, dist);
+
+    double *trans = (sparseTransition == 0) ? getTransition(1) : 0;
+    int iteration = 0;
+    bool stationary = false;
 
-    if (length > 0)
+    while (!stationary && (maxIterations <= 0 || iteration < maxIterations))
     {
-		int state = 0;
-		double *dist = getDistribution(time);
-		double currentProb = dist[state];
-		double r = ((double) rand() / (RAND_MAX));
-		while (r > currentProb) {
-			r -= currentProb;
-			state++;
-			currentProb = dist[state];
+		iteration++;
+		std::swap(dist,previousDist);
+
+		if (method == POWER_ITERATION)
+		{
+			if (sparseTransition != 0) { sparseTransition->multiplyVector(previousDist,dist); }
+			else { multiplyMatrixVector(trans,previousDist,dist,size); }
 		}
-		traj->states[0] = state;
 
-		for (int l = 1; l < length; l++)
+		else
 		{
-			int nextState = 0;
-			currentProb = transitions->at(1)[nextState*size+state];
-			r = ((double) rand() / (RAND_MAX));
-			while (r > currentProb) {
-				r -= currentProb;
-				nextState++;
-				currentProb = transitions->at(1)[nextState*size+state];
+			// Solve p = T.p in place, state by state (states whose only predecessor is themselves are left unchanged)
+			std::copy(previousDist, previousDist + size, dist);
+			for (int i = 0; i < size; i++)
+			{
+				double stay = 0;
+				double sum = 0;
+				if (sparseTransition != 0)
+				{
+					for (long e = sparseTransition->offsets[i]; e < sparseTransition->offsets[i+1]; e++)
+					{
+						int j = sparseTransition->columns[e];
+						if (j == i) { stay = sparseTransition->values[e]; } else { sum += sparseTransition->values[e] * dist[j]; }
+					}
+				}
+				else
+				{
+					const double *row = trans + (long) i*size;
+					for (int j = 0; j < size; j++) { sum += row[j] * dist[j]; }
+					stay = row[i];
+					sum -= stay * dist[i];
+				}
+				if (stay < 1) { dist[i] = sum / (1 - stay); }
 			}
-			state = nextState;
-			traj->states[l] = state;
+
+			double total = 0;
+			for (int i = 0; i < size; i++) { total += dist[i]; }
+			for (int i = 0; i < size; i++) { dist[i] /= total; }
 		}
+
+		stationary = true;
+		for (int i = 0; i < size && stationary; i++) { stationary = std::abs(previousDist[i] - dist[i]) < threshold; }
     }
 
-    return traj;
+    // The last iterate should end in the stationaryDistribution buffer
+    if (dist != stationaryDistribution) { std::copy(dist, dist + size, stationaryDistribution); previousDist = dist; }
+    delete [] previousDist;
+
+    if (VERBOSE) { std::cout << "Stationary distribution after " << iteration << " iterations" << std::endl; }
+    return iteration;
 }
 
 
-double *MarkovProcess::getTransition (int delay)
+void MarkovProcess::buildSamplers (int time)
 {
-    if (lastDelay < delay)
+    std::vector< std::pair<int,double> > entries;
+    entries.reserve(size);
+
+    if (transitionSampler == 0)
     {
-		transitions->resize(delay+1);
-		
-		double *currentTrans = getTransition(lastDelay);
-		for (int d = lastDelay + 1; d <= delay; d++)
+		transitionSampler = new AliasTable();
+		double *trans = (sparseSuccessors == 0) ? getTransition(1) : 0;
+		for (int i = 0; i < size; i++)
 		{
-			if (VERBOSE) { std::cout << "Transition " << d << " (size " << size << ")" << std::endl; }
-			double *newTrans = new double [size*size];
-
-			for (int i = 0; i < size; i++)
+			entries.clear();
+			if (sparseSuccessors != 0)
 			{
-				for (int j = 0; j < size; j++)
-				{
-					newTrans[j*size+i] = 0;
-					for (int k = 0; k < size; k++)
-						newTrans[j*size+i] += transition[j*size+k] * currentTrans[k*size+i];
-				}
+				for (long e = sparseSuccessors->offsets[i]; e < sparseSuccessors->offsets[i+1]; e++)
+					entries.push_back(std::make_pair(sparseSuccessors->columns[e],sparseSuccessors->values[e]));
 			}
+			else { for (int j = 0; j < size; j++) { entries.push_back(std::make_pair(j,trans[(long) j*size+i])); } }
+			transitionSampler->addDistribution(entries);
+		}
+    }
+
+    if (distributionSampler == 0 || samplerTime != time)
+    {
+		delete distributionSampler;
+		distributionSampler = new AliasTable();
+		double *dist = getDistribution(time);
+		entries.clear();
+		for (int i = 0; i < size; i++) { entries.push_back(std::make_pair(i,dist[i])); }
+		distributionSampler->addDistribution(entries);
+		samplerTime = time;
+    }
+}
 
-			transitions->at(d) = newTrans;
-			currentTrans = newTrans;
 
+/*!
+ * \brief Sample a trajectory with the alias tables of a process (which should have been built for the given time) into an array of states of any integer type
+ */
+template <typename State>
+static void sampleTrajectory (MarkovProcess *process, int length, RandomGenerator *random, State *states)
+{
+    int state = process->distributionSampler->sample(0,random);
+    states[0] = state;
+    for (int l = 1; l < length; l++)
+    {
+		state = process->transitionSampler->sample(state,random);
+		states[l] = state;
+    }
+}
+
+
+MarkovTrajectory *MarkovProcess::computeTrajectory (int time, int length, RandomGenerator *random)
+{
+    MarkovTrajectory *traj = new MarkovTrajectory(this,time,length);
+    if (length <= 0) { return traj; }
+
+    if (transitionSampler == 0 || distributionSampler == 0 || samplerTime != time) { buildSamplers(time); }
+    if (random == 0) { random = getThreadRandomGenerator(); }
+
+    sampleTrajectory(this,length,random,traj->states);
+    return traj;
+}
+
+
+double *MarkovProcess::getTransition (int delay)
+{
+    if (lastDelay < delay) { lastDelay = delay; }
+
+    std::map<int,double*>::iterator it = transitions->find(delay);
+    if (it != transitions->end())
+    {
+		if (delay > 1) { touchCacheEntry(-delay); }
+		return it->second;
+    }
+
+    double *newTrans = new double [(long) size*size];
+    if (delay == 0)
+    {
+		std::fill(newTrans, newTrans + (long) size*size, 0.);
+		for (int i = 0; i < size; i++) { newTrans[(long) i*size+i] = 1; }
+		storeTransition(0,newTrans);
+		return newTrans;
+    }
+
+    // Dense one-step kernel, only built on demand from the sparse one
+    if (delay == 1)
+    {
+		sparseTransition->toDense(newTrans);
+		transition = newTrans;
+		storeTransition(1,newTrans);
+		return newTrans;
+    }
+    delete [] newTrans;
+
+    // Either step from the closest computed kernel, or split the delay in two halves (exponentiation by squaring), whichever needs less products
+    it = transitions->lower_bound(delay);
+    int previousDelay = (it != transitions->begin() && (--it)->first > 1) ? it->first : 1;
+
+    if (delay - previousDelay <= 2 * std::log2(delay))
+    {
+		for (int d = previousDelay + 1; d <= delay; d++)
+		{
+			if (VERBOSE) { std::cout << "Transition " << d << " (size " << size << ")" << std::endl; }
+			newTrans = new double [(long) size*size];
+			if (sparseTransition != 0) { sparseTransition->multiplyDense(getTransition(d-1),newTrans); }
+			else { multiplyMatrices(transition,getTransition(d-1),newTrans,size); }
+			storeTransition(d,newTrans);
 		}
-		lastDelay = delay;
+    }
+
+    else
+    {
+		// The first half is locked while the second one is computed
+		double *trans1 = getTransition(delay/2);
+		lockedDelays.push_back(delay/2);
+		double *trans2 = getTransition(delay - delay/2);
+		lockedDelays.pop_back();
+		if (VERBOSE) { std::cout << "Transition " << delay << " (size " << size << ")" << std::endl; }
+		newTrans = new double [(long) size*size];
+		multiplyMatrices(trans1,trans2,newTrans,size);
+		storeTransition(delay,newTrans);
     }
 	
     return transitions->at(delay);
@@ -249,6 +500,7 @@ double MarkovProcess::getProbability (Part *part, int time)
 
 double MarkovProcess::getNextProbability (int nextIndividual, int currentIndividual, int delay)
 {
+    if (delay == 1 && sparseTransition != 0) { return sparseTransition->get(nextIndividual,currentIndividual); }
     double *trans = getTransition(delay);
     return trans[nextIndividual*size+currentIndividual];
 }
@@ -287,16 +539,63 @@ double MarkovProcess::getNextProbability (Part *nextPart, Part *currentPart, int
 }
 
 
-double MarkovProcess::getEntropy (Partition *partition, int time)
+int *MarkovProcess::getPartIndices (Partition *partition)
 {
-    double entropy = 0;
-	
-    for (std::list<Part*>::iterator it1 = partition->parts->begin(); it1 != partition->parts->end(); ++it1)
+    int *indices = new int [size];
+    std::fill(indices, indices + size, -1);
+
+    int index = 0;
+    for (std::list<Part*>::iterator it = partition->parts->begin(); it != partition->parts->end(); ++it, index++)
+		for (std::list<int>::iterator it2 = (*it)->individuals->begin(); it2 != (*it)->individuals->end(); ++it2)
+			indices[*it2] = index;
+
+    return indices;
+}
+
+
+void MarkovProcess::lumpTransition (int *nextIndices, int nextNumber, int *currentIndices, int currentNumber, double *currentWeights, int delay, double *lumped)
+{
+    std::fill(lumped, lumped + (long) nextNumber*currentNumber, 0.);
+
+    if (delay == 1 && sparseTransition != 0)
+    {
+		for (int j = 0; j < size; j++)
+		{
+			if (nextIndices[j] < 0) { continue; }
+			double *row = lumped + (long) nextIndices[j]*currentNumber;
+			for (long e = sparseTransition->offsets[j]; e < sparseTransition->offsets[j+1]; e++)
+			{
+				int i = sparseTransition->columns[e];
+				if (currentIndices[i] >= 0) { row[currentIndices[i]] += currentWeights[i] * sparseTransition->values[e]; }
+			}
+		}
+		return;
+    }
+
+    double *trans = getTransition(delay);
+    for (int j = 0; j < size; j++)
     {
-		double prob = getProbability(*it1,time);
-		if (prob > 0) { entropy += - prob * log2(prob); }
+		if (nextIndices[j] < 0) { continue; }
+		double *row = lumped + (long) nextIndices[j]*currentNumber;
+		double *transRow = trans + (long) j*size;
+		for (int i = 0; i < size; i++)
+			if (currentIndices[i] >= 0) { row[currentIndices[i]] += currentWeights[i] * transRow[i]; }
     }
-	
+}
+
+
+double MarkovProcess::getEntropy (Partition *partition, int time)
+{
+    double *dist = getDistribution(time);
+    int *indices = getPartIndices(partition);
+
+    std::vector<double> prob (partition->size, 0);
+    for (int i = 0; i < size; i++) { if (indices[i] >= 0) { prob[indices[i]] += dist[i]; } }
+
+    double entropy = 0;
+    for (int a = 0; a < partition->size; a++) { if (prob[a] > 0) { entropy += - prob[a] * log2(prob[a]); } }
+
+    delete [] indices;
     return entropy;
 }
 
@@ -305,24 +604,36 @@ double MarkovProcess::getMutualInformation (Partition *nextPartition, Partition
 {
     int nextTime = time + delay;
     if (time == -1) { nextTime = -1; }
-	
-    double information = 0;
-	
-    for (std::list<Part*>::iterator it1 = currentPartition->parts->begin(); it1 != currentPartition->parts->end(); ++it1)
+
+    int currentNumber = currentPartition->size;
+    int nextNumber = nextPartition->size;
+    int *currentIndices = getPartIndices(currentPartition);
+    int *nextIndices = getPartIndices(nextPartition);
+
+    double *dist = getDistribution(time);
+    double *nextDist = getDistribution(nextTime);
+    std::vector<double> currentProb (currentNumber, 0);
+    std::vector<double> nextProb (nextNumber, 0);
+    for (int i = 0; i < size; i++)
     {
-		Part *currentPart = *it1;
-		double probCurrentPart = getProbability(currentPart,time);
-		
-		for (std::list<Part*>::iterator it2 = nextPartition->parts->begin(); it2 != nextPartition->parts->end(); ++it2)
+		if (currentIndices[i] >= 0) { currentProb[currentIndices[i]] += dist[i]; }
+		if (nextIndices[i] >= 0) { nextProb[nextIndices[i]] += nextDist[i]; }
+    }
+
+    // joint[b*currentNumber+a] is the probability to be in a and then in b
+    std::vector<double> joint ((long) nextNumber*currentNumber);
+    lumpTransition(nextIndices,nextNumber,currentIndices,currentNumber,dist,delay,joint.data());
+
+    double information = 0;
+    for (int b = 0; b < nextNumber; b++)
+		for (int a = 0; a < currentNumber; a++)
 		{
-			Part *nextPart = *it2;
-			double probNextPart = getProbability(nextPart,nextTime);
-			
-			double condProb = getNextProbability(nextPart,currentPart,delay,time);
-			if (condProb > 0 && probNextPart > 0) { information += probCurrentPart * condProb * log2(condProb / probNextPart); }
+			double prob = joint[(long) b*currentNumber+a];
+			if (prob > 0 && nextProb[b] > 0) { information += prob * log2(prob / (currentProb[a] * nextProb[b])); }
 		}
-    }
-	
+
+    delete [] currentIndices;
+    delete [] nextIndices;
     return information;
 }
 
@@ -331,177 +642,163 @@ double MarkovProcess::getPartMutualInformation (Partition *nextPartition, Part *
 {
     int nextTime = time + delay;
     if (time == -1) { nextTime = -1; }
-	
+
+    int nextNumber = nextPartition->size;
+    int *nextIndices = getPartIndices(nextPartition);
+    int *currentIndices = new int [size];
+    std::fill(currentIndices, currentIndices + size, -1);
+
+    double *dist = getDistribution(time);
+    double currentProb = 0;
+    for (std::list<int>::iterator it = currentPart->individuals->begin(); it != currentPart->individuals->end(); ++it)
+    {
+		currentIndices[*it] = 0;
+		currentProb += dist[*it];
+    }
+
+    double *nextDist = getDistribution(nextTime);
+    std::vector<double> nextProb (nextNumber, 0);
+    for (int i = 0; i < size; i++) { if (nextIndices[i] >= 0) { nextProb[nextIndices[i]] += nextDist[i]; } }
+
+    std::vector<double> joint (nextNumber);
+    lumpTransition(nextIndices,nextNumber,currentIndices,1,dist,delay,joint.data());
+
     double information = 0;
-	
-    for (std::list<Part*>::iterator it2 = nextPartition->parts->begin(); it2 != nextPartition->parts->end(); ++it2)
+    for (int b = 0; b < nextNumber; b++)
     {
-		Part *nextPart = *it2;
-		double probNextPart = getProbability(nextPart,nextTime);
-			
-		double condProb = getNextProbability(nextPart,currentPart,delay,time);
-		if (condProb > 0 && probNextPart > 0) { information += condProb * log2(condProb / probNextPart); }
+		double condProb = joint[b] / currentProb;
+		if (condProb > 0 && nextProb[b] > 0) { information += condProb * log2(condProb / nextProb[b]); }
     }
-	
+
+    delete [] currentIndices;
+    delete [] nextIndices;
     return information;
 }
 
 
 double MarkovProcess::getNextEntropy (Partition *partition, bool micro, int delay, int time)
 {
+    int number = partition->size;
+    int *indices = getPartIndices(partition);
+    double *dist = getDistribution(time);
     double entropy = 0;
-	
+
     if (micro)
     {
-		for (int currentIndividual = 0; currentIndividual < size; currentIndividual++)
-		{
-			for (std::list<Part*>::iterator nextIt = partition->parts->begin(); nextIt != partition->parts->end(); ++nextIt)
+		// cond[b*size+i] is the probability to be in b knowing that the current state is i
+		int *states = new int [size];
+		std::vector<double> ones (size, 1);
+		for (int i = 0; i < size; i++) { states[i] = i; }
+
+		std::vector<double> cond ((long) number*size);
+		lumpTransition(indices,number,states,size,ones.data(),delay,cond.data());
+
+		for (int b = 0; b < number; b++)
+			for (int i = 0; i < size; i++)
 			{
-				Part *nextPart = *nextIt;
-				double nextProbability = getNextProbability(nextPart,currentIndividual,delay);
-				if (nextProbability > 0)
-					entropy += - getProbability(currentIndividual,time) * nextProbability * log2(nextProbability);
+				double nextProbability = cond[(long) b*size+i];
+				if (nextProbability > 0) { entropy += - dist[i] * nextProbability * log2(nextProbability); }
 			}
-		}		
+
+		delete [] states;
     }
-	
+
     else {
-		for (std::list<Part*>::iterator currentIt = partition->parts->begin(); currentIt != partition->parts->end(); ++currentIt)
-		{
-			Part *currentPart = *currentIt;
-			for (std::list<Part*>::iterator nextIt = partition->parts->begin(); nextIt != partition->parts->end(); ++nextIt)
+		std::vector<double> prob (number, 0);
+		for (int i = 0; i < size; i++) { if (indices[i] >= 0) { prob[indices[i]] += dist[i]; } }
+
+		std::vector<double> joint ((long) number*number);
+		lumpTransition(indices,number,indices,number,dist,delay,joint.data());
+
+		for (int b = 0; b < number; b++)
+			for (int a = 0; a < number; a++)
 			{
-				Part *nextPart = *nextIt;
-				double nextProbability = getNextProbability(nextPart,currentPart,delay,time);
-				if (nextProbability > 0)
-					entropy += - getProbability(currentPart,time) * nextProbability * log2(nextProbability);
+				double jointProbability = joint[(long) b*number+a];
+				if (jointProbability > 0) { entropy += - jointProbability * log2(jointProbability / prob[a]); }
 			}
-		}
     }
-	
+
+    delete [] indices;
     return entropy;
 }
 
 
 
-std::set<OrderedPartition*> *MarkovProcess::getOptimalOrderedPartition (Partition *nextPartition, Partition *currentPartition, int delay, int time, double threshold)
+void MarkovProcess::computeOrderedTables (Partition *nextPartition, Partition *currentPartition, int delay, int time, double *macroEntropy, double *macroInformation)
 {
     int nextTime = time + delay;
     if (time == -1) { nextTime = -1; }
 	
     int microSize = currentPartition->size;
-    int macroSize = microSize * microSize;
     int nextSize = nextPartition->size;
 
-    // Compute entropy of pre-measurement
-    double microProb [microSize];	
-    for (int i = 0; i < microSize; i++)
-		microProb[i] = getProbability(currentPartition->getPartFromValue(i),time);
-	
-    double macroProb [macroSize];
-    for (int i = 0; i < microSize; i++)
-		macroProb[i] = microProb[i];
-    for (int j = 1; j < microSize; j++)
-		for (int i = 0; i < microSize - j; i++)
-			macroProb[i+j*microSize] = macroProb[i+(j-1)*microSize] + macroProb[i+j];
-	
-    double macroEntropy [macroSize];
-    for (int j = 0; j < microSize; j++)
-		for (int i = 0; i < microSize - j; i++)
-		{
-			if (macroProb[i+j*microSize] > 0) { macroEntropy[i+j*microSize] = - macroProb[i+j*microSize] * log2(macroProb[i+j*microSize]); }
-			else { macroEntropy[i+j*microSize] = 0; }
-		}
+    int *currentIndices = new int [size];
+    int *nextIndices = new int [size];
+    std::fill(currentIndices, currentIndices + size, -1);
+    std::fill(nextIndices, nextIndices + size, -1);
+    for (std::list<Part*>::iterator it = currentPartition->parts->begin(); it != currentPartition->parts->end(); ++it)
+		for (std::list<int>::iterator it2 = (*it)->individuals->begin(); it2 != (*it)->individuals->end(); ++it2)
+			currentIndices[*it2] = (*it)->num;
+    for (std::list<Part*>::iterator it = nextPartition->parts->begin(); it != nextPartition->parts->end(); ++it)
+		for (std::list<int>::iterator it2 = (*it)->individuals->begin(); it2 != (*it)->individuals->end(); ++it2)
+			nextIndices[*it2] = (*it)->id;
 
-    // Compute mutual information between pre-measurement and post-measurement
-    double microCondProb [microSize*nextSize];
-    for (int i = 0; i < microSize; i++)
-		for (std::list<Part*>::iterator it = nextPartition->parts->begin(); it != nextPartition->parts->end(); ++it)
-			microCondProb[i+(*it)->id*microSize] = getNextProbability(*it,currentPartition->getPartFromValue(i),delay,time);
+    double *dist = getDistribution(time);
+    double *nextDist = getDistribution(nextTime);
+    std::vector<double> microProb (microSize, 0);
+    std::vector<double> nextProb (nextSize, 0);
+    for (int i = 0; i < size; i++)
+    {
+		if (currentIndices[i] >= 0) { microProb[currentIndices[i]] += dist[i]; }
+		if (nextIndices[i] >= 0) { nextProb[nextIndices[i]] += nextDist[i]; }
+    }
 
-    double macroCondProb [macroSize*nextSize];
-    for (std::list<Part*>::iterator it = nextPartition->parts->begin(); it != nextPartition->parts->end(); ++it)
+    // microJoint[v*microSize+i] is the probability to be in the micro part i and then in the next part v, transposed so that the running sums below read it contiguously
+    std::vector<double> microJoint ((long) nextSize*microSize);
+    lumpTransition(nextIndices,nextSize,currentIndices,microSize,dist,delay,microJoint.data());
+    std::vector<double> jointByPart ((long) microSize*nextSize);
+    for (int v = 0; v < nextSize; v++)
 		for (int i = 0; i < microSize; i++)
-			macroCondProb[i+(*it)->id*macroSize] = microCondProb[i+(*it)->id*microSize] * microProb[i];			
-    for (std::list<Part*>::iterator it = nextPartition->parts->begin(); it != nextPartition->parts->end(); ++it)
-		for (int j = 1; j < microSize; j++)
-			for (int i = 0; i < microSize - j; i++)
-				macroCondProb[i+j*microSize+(*it)->id*macroSize] = macroCondProb[i+(j-1)*microSize+(*it)->id*macroSize] + macroCondProb[i+j+(*it)->id*macroSize];
-    for (std::list<Part*>::iterator it = nextPartition->parts->begin(); it != nextPartition->parts->end(); ++it)
-		for (int j = 0; j < microSize; j++)
-			for (int i = 0; i < microSize - j; i++)
-				macroCondProb[i+j*microSize+(*it)->id*macroSize] /= macroProb[i+j*microSize];
+			jointByPart[(long) i*nextSize+v] = microJoint[(long) v*microSize+i];
 
-    double nextProb [nextSize];
-    for (std::list<Part*>::iterator it = nextPartition->parts->begin(); it != nextPartition->parts->end(); ++it)
-		nextProb[(*it)->id] = getProbability(*it,nextTime);
-	
-    double macroInformation [macroSize];
-    for (int j = 0; j < microSize; j++)
-		for (int i = 0; i < microSize - j; i++)
+    delete [] currentIndices;
+    delete [] nextIndices;
+
+    // Each interval start i is handled by one task, which extends the interval one part at a time
+    parallelFor(microSize, [&] (int i)
+    {
+		std::vector<double> macroJoint (nextSize, 0);
+		double macroProb = 0;
+		for (int j = 0; j < microSize - i; j++)
 		{
-			macroInformation[i+j*microSize] = 0;
-			for (std::list<Part*>::iterator it = nextPartition->parts->begin(); it != nextPartition->parts->end(); ++it)
-				if (macroCondProb[i+j*microSize+(*it)->id*macroSize] > 0)
-					macroInformation[i+j*microSize] += macroCondProb[i+j*microSize+(*it)->id*macroSize]
-						* log2(macroCondProb[i+j*microSize+(*it)->id*macroSize] / nextProb[(*it)->id]);
-			macroInformation[i+j*microSize] = macroInformation[i+j*microSize] * macroProb[i+j*microSize];
-		}
+			macroProb += microProb[i+j];
+			const double *joint = &jointByPart[(long) (i+j)*nextSize];
+			for (int v = 0; v < nextSize; v++) { macroJoint[v] += joint[v]; }
 
-/*
-// PRINT RESULTS
-std::cout << "microProb" << std::endl;
-for (int i = 0; i < microSize; i++) std::cout << microProb[i] << "\t";
-std::cout << std::endl;
-	
-std::cout << "macroProb" << std::endl;
-for (int j = 0; j < microSize; j++)
-{
-for (int i = 0; i < microSize - j; i++)
-std::cout << macroProb[i+j*microSize] << "\t";
-std::cout << std::endl;
-}
-std::cout << std::endl;
-	
-std::cout << "macroEntropy" << std::endl;
-for (int j = 0; j < microSize; j++)
-{
-for (int i = 0; i < microSize - j; i++) std::cout << macroEntropy[i+j*microSize] << "\t";
-std::cout << std::endl;
-}
-std::cout << std::endl;
+			long index = i + (long) j*microSize;
+			if (macroProb > 0) { macroEntropy[index] = - macroProb * log2(macroProb); } else { macroEntropy[index] = 0; }
 
-std::cout << "microCondProb" << std::endl;
-for (std::list<Part*>::iterator it = nextPartition->parts->begin(); it != nextPartition->parts->end(); ++it)
-{
-std::cout << "v = " << (*it)->id << " -> ";
-for (int i = 0; i < microSize; i++) std::cout << microCondProb[i+(*it)->id*microSize] << "\t";
-std::cout << std::endl;
+			double information = 0;
+			for (int v = 0; v < nextSize; v++)
+				if (macroJoint[v] > 0) { information += macroJoint[v] * log2(macroJoint[v] / (macroProb * nextProb[v])); }
+			macroInformation[index] = information;
+		}
+    });
 }
-std::cout << std::endl;
 
-std::cout << "macroCondProb" << std::endl;
-for (std::list<Part*>::iterator it = nextPartition->parts->begin(); it != nextPartition->parts->end(); ++it)
-{
-std::cout << "v = " << (*it)->id << " -> ";
-for (int j = 0; j < microSize; j++)
-{
-for (int i = 0; i < microSize - j; i++) std::cout << macroCondProb[i+j*microSize+(*it)->id*macroSize] << "\t";
-std::cout << std::endl;
-}
-std::cout << std::endl;
-}
-std::cout << std::endl;
 
-std::cout << "macroInformation" << std::endl;
-for (int j = 0; j < microSize; j++)
+std::set<OrderedPartition*> *MarkovProcess::getOptimalOrderedPartition (Partition *nextPartition, Partition *currentPartition, int delay, int time, double threshold)
 {
-for (int i = 0; i < microSize - j; i++) std::cout << macroInformation[i+j*microSize] << "\t";
-std::cout << std::endl;
+    int microSize = currentPartition->size;
+    std::vector<double> macroEntropy ((long) microSize*microSize);
+    std::vector<double> macroInformation ((long) microSize*microSize);
+    computeOrderedTables(nextPartition,currentPartition,delay,time,macroEntropy.data(),macroInformation.data());
+    return getOptimalOrderedPartition(microSize,macroEntropy.data(),macroInformation.data(),threshold);
 }
-std::cout << std::endl;
-*/
 
+
+std::set<OrderedPartition*> *MarkovProcess::getOptimalOrderedPartition (int microSize, double *macroEntropy, double *macroInformation, double threshold)
+{
     // Ordered partitioning algorithm
     std::map<double,OrderedPartition*> pMap;
 	
@@ -713,22 +1010,162 @@ void MarkovTrajectory::print (const int binary)
 
 
 
-MarkovDataSet::MarkovDataSet (MarkovProcess *pr, int si, int ti, int le)
+/*!
+ * \brief Header of the files holding the trajectories of a MarkovDataSet (followed by the states)
+ */
+struct MarkovDataSetHeader
+{
+    char magic [8];
+    int processSize;
+    int size;
+    int time;
+    int length;
+    int stateBytes;
+    int padding;
+};
+
+static const char MARKOV_DATASET_MAGIC [8] = {'M','K','V','D','A','T','A','1'};
+
+
+MarkovDataSet::MarkovDataSet (MarkovProcess *pr, int si, int ti, int le, unsigned long long seed, std::string fileName)
 {
     process = pr;
     size = si;
     time = ti;
     length = le;
 
-    trajectories = new MarkovTrajectory *[size];
-    for (int t = 0; t < size; t++) { trajectories[t] = process->computeTrajectory(time,length); }
+    if (process->size <= (1 << 8)) { stateBytes = 1; }
+    else if (process->size <= (1 << 16)) { stateBytes = 2; }
+    else { stateBytes = 4; }
+
+    long stateNumber = (long) size*length;
+    mapping = 0;
+    mappingBytes = 0;
+
+    if (fileName.empty()) { states = new unsigned char [stateNumber*stateBytes]; }
+    else {
+		mappingBytes = sizeof(MarkovDataSetHeader) + stateNumber*stateBytes;
+		int file = open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (file < 0 || ftruncate(file,mappingBytes) != 0)
+		{
+			std::cout << "ERROR: cannot create file " << fileName << std::endl;
+			if (file >= 0) { close(file); }
+			size = 0;
+			states = 0;
+			return;
+		}
+		mapping = (unsigned char *) mmap(0, mappingBytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+		close(file);
+		if (mapping == MAP_FAILED)
+		{
+			std::cout << "ERROR: cannot map file " << fileName << std::endl;
+			mapping = 0;
+			size = 0;
+			states = 0;
+			return;
+		}
+
+		MarkovDataSetHeader header;
+		std::memcpy(header.magic, MARKOV_DATASET_MAGIC, 8);
+		header.processSize = process->size;
+		header.size = size;
+		header.time = time;
+		header.length = length;
+		header.stateBytes = stateBytes;
+		header.padding = 0;
+		std::memcpy(mapping, &header, sizeof(MarkovDataSetHeader));
+		states = mapping + sizeof(MarkovDataSetHeader);
+    }
+
+    if (seed == 0) { seed = getThreadRandomGenerator()->next(); }
+    if (length <= 0) { return; }
+
+    process->buildSamplers(time);
+    parallelFor(size, [&] (int t)
+    {
+		CounterRandomGenerator random (seed,t);
+		long first = (long) t*length;
+		if (stateBytes == 1) { sampleTrajectory(process,length,&random,states + first); }
+		else if (stateBytes == 2) { sampleTrajectory(process,length,&random,(uint16_t*) states + first); }
+		else { sampleTrajectory(process,length,&random,(uint32_t*) states + first); }
+    });
+}
+
+
+MarkovDataSet::MarkovDataSet (MarkovProcess *pr, std::string fileName)
+{
+    process = pr;
+    size = 0;
+    time = 0;
+    length = 0;
+    stateBytes = 1;
+    states = 0;
+    mapping = 0;
+    mappingBytes = 0;
+
+    int file = open(fileName.c_str(), O_RDONLY);
+    struct stat fileStat;
+    if (file < 0 || fstat(file,&fileStat) != 0 || fileStat.st_size < (long) sizeof(MarkovDataSetHeader))
+    {
+		std::cout << "ERROR: cannot open file " << fileName << std::endl;
+		if (file >= 0) { close(file); }
+		return;
+    }
+
+    mappingBytes = fileStat.st_size;
+    mapping = (unsigned char *) mmap(0, mappingBytes, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+    if (mapping == MAP_FAILED) { std::cout << "ERROR: cannot map file " << fileName << std::endl; mapping = 0; return; }
+
+    MarkovDataSetHeader header;
+    std::memcpy(&header, mapping, sizeof(MarkovDataSetHeader));
+    if (std::memcmp(header.magic, MARKOV_DATASET_MAGIC, 8) != 0 || header.processSize != process->size
+		|| mappingBytes != (long) sizeof(MarkovDataSetHeader) + (long) header.size*header.length*header.stateBytes)
+    {
+		std::cout << "ERROR: " << fileName << " is not a dataset of this process!" << std::endl;
+		munmap(mapping,mappingBytes);
+		mapping = 0;
+		return;
+    }
+
+    size = header.size;
+    time = header.time;
+    length = header.length;
+    stateBytes = header.stateBytes;
+    states = mapping + sizeof(MarkovDataSetHeader);
 }
 
 
 MarkovDataSet::~MarkovDataSet ()
 {
-    for (int t = 0; t < size; t++) { delete trajectories[t]; }
-    delete[] trajectories;
+    if (mapping != 0) { munmap(mapping,mappingBytes); }
+    else { delete [] states; }
+}
+
+
+/*!
+ * \brief Count the part-to-part transitions of a trajectory (stored as an array of states of any integer type) from time first to time last-1
+ */
+template <typename State>
+static void countPartTransitions (const State *states, int first, int last, int delay, const int *preIds, const int *postIds, int preSize, double *dist)
+{
+    for (int time = first; time < last; time++) { dist[postIds[states[time+delay]] * preSize + preIds[states[time]]]++; }
+}
+
+
+/*!
+ * \brief Sum the logarithmic scores of the part-to-part transitions of a trajectory from time first to time last-1 (return false if one of them has a null probability)
+ */
+template <typename State>
+static bool scorePartTransitions (const State *states, int first, int last, int delay, const int *preIds, const int *postIds, int preSize, const double *dist, double *score)
+{
+    for (int time = first; time < last; time++)
+    {
+		double prob = dist[postIds[states[time+delay]] * preSize + preIds[states[time]]];
+		if (prob == 0) { return false; }
+		*score += -log(prob);
+    }
+    return true;
 }
 
 
@@ -745,17 +1182,27 @@ double MarkovDataSet::computeScore (Partition *preP, Partition *postP, int delay
 		for (int j = 0; j < postP->size; j++)
 			trainDist[j * preP->size + i] = 0;
 
-    // count occurrences
-    for (int t = 0; t < size; t++)
+    // count occurrences (in a fixed number of chunks of trajectories, each one with its own counts)
+    const int *preIds = preP->getPartIds();
+    const int *postIds = postP->getPartIds();
+    int preSize = preP->size;
+    int chunkNumber = std::min(size,getThreadNumber());
+    std::vector< std::vector<double> > chunkDist (chunkNumber);
+    parallelFor(chunkNumber, [&] (int c)
     {
-		MarkovTrajectory *traj = trajectories[t];
-		for (int time = 0; time < trainingLength; time++)
+		std::vector<double> &dist = chunkDist[c];
+		dist.assign(preSize * postP->size, 0);
+		for (int t = (long) c*size/chunkNumber; t < (long) (c+1)*size/chunkNumber; t++)
 		{
-			Part *prePart = preP->findPart(traj->states[time]);
-			Part *postPart = postP->findPart(traj->states[time+delay]);
-			trainDist[postPart->id * preP->size + prePart->id]++;
+			long first = (long) t*length;
+			if (stateBytes == 1) { countPartTransitions(states + first,0,trainingLength,delay,preIds,postIds,preSize,dist.data()); }
+			else if (stateBytes == 2) { countPartTransitions((const uint16_t*) states + first,0,trainingLength,delay,preIds,postIds,preSize,dist.data()); }
+			else { countPartTransitions((const uint32_t*) states + first,0,trainingLength,delay,preIds,postIds,preSize,dist.data()); }
 		}
-    }
+    });
+    for (int c = 0; c < chunkNumber; c++)
+		for (int k = 0; k < preSize * postP->size; k++)
+			trainDist[k] += chunkDist[c][k];
 
     // normalise
     for (int i = 0; i < preP->size; i++)
@@ -789,23 +1236,24 @@ double MarkovDataSet::computeScore (Partition *preP, Partition *postP, int delay
 	  std::cout << std::endl;
     */
 
-    // compute score
-    int count = 0;
-    double score = 0;
-    for (int t = 0; t < size; t++)
+    // compute score (summing the scores of each trajectory in order, so that the result does not depend on the number of threads)
+    std::vector<double> scores (size, 0);
+    std::vector<char> impossible (size, false);
+    parallelFor(size, [&] (int t)
     {
-		MarkovTrajectory *traj = trajectories[t];
-		for (int time = trainingLength; time < length - delay; time++)
-		{
-			Part *prePart = preP->findPart(traj->states[time]);
-			Part *postPart = postP->findPart(traj->states[time+delay]);
-			double prob = trainDist[postPart->id * preP->size + prePart->id];
-			if (prob == 0) { return -1; }
-
-			score += -log(prob);
-			count++;
-		}
-    }
+		long first = (long) t*length;
+		bool possible;
+		if (stateBytes == 1) { possible = scorePartTransitions(states + first,trainingLength,length-delay,delay,preIds,postIds,preSize,trainDist,&scores[t]); }
+		else if (stateBytes == 2) { possible = scorePartTransitions((const uint16_t*) states + first,trainingLength,length-delay,delay,preIds,postIds,preSize,trainDist,&scores[t]); }
+		else { possible = scorePartTransitions((const uint32_t*) states + first,trainingLength,length-delay,delay,preIds,postIds,preSize,trainDist,&scores[t]); }
+		impossible[t] = !possible;
+    });
+    delete [] trainDist;
+    if (std::find(impossible.begin(), impossible.end(), true) != impossible.end()) { return -1; }
+
+    long count = (long) size * std::max(0,length - delay - trainingLength);
+    double score = 0;
+    for (int t = 0; t < size; t++) { score += scores[t]; }
     if (count > 0) { return score/count; }
     else { return 0; }
 }
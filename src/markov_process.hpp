@@ -46,13 +46,38 @@
  */
 
 #include <vector>
+#include <string>
+#include <cstdint>
+#include <map>
+#include <list>
+#include <unordered_map>
 
 #include "partition.hpp"
+#include "matrix_tools.hpp"
+#include "random_tools.hpp"
 
 long unsigned int nChoosek (int n, int k);
 
 class MarkovTrajectory;
 
+/*!
+ * \brief Sparse one-step kernels filled above this proportion of non-null entries are stored as dense matrices
+ */
+const double DENSE_FILL = 0.25;
+
+/*!
+ * \brief When the cache of a process is bounded, the distributions and kernels among the last PINNED_ENTRIES ones that have been requested are never evicted (so that a returned pointer stays valid until as many others have been requested)
+ */
+const int PINNED_ENTRIES = 4;
+
+/*!
+ * \brief The iterative method used to compute the stationary distribution
+ */
+enum StationaryMethod {
+    POWER_ITERATION,	/*!< The distribution is repeatedly multiplied by the transition kernel*/
+    GAUSS_SEIDEL		/*!< Each probability is updated in place from the current ones of the previous states, then the distribution is normalised (faster, but only for irreducible chains)*/
+};
+
 /*!
  * \class MarkovProcess
  * \brief A finite Markov chain described by a discrete state space, an initial distribution, and a transition kernel
@@ -63,18 +88,31 @@ public:
     int size;						     	/*!< The size of the Markov chain state space*/
 
     double *distribution;					/*!< The initial probability distribution of the system state (time 0)*/
-    std::vector<double*> *distributions;	/*!< A vector of probability distributions through time (from 0 to lastTime)*/
+    std::map<int,double*> *distributions;	/*!< The cached probability distributions, by time (from 0 to lastTime)*/
     int lastTime;							/*!< The time of the furthest computed probability distribution in the distributions vector*/
+    double *stationaryDistribution;			/*!< The stationary distribution, if it has been computed (otherwise, the distribution at lastTime is used as such)*/
 
     double *transition;						/*!< The transition kernel of the Markov chain (1 step)*/
-    std::vector<double*> *transitions;		/*!< A vector of transition kernels for several steps (from 1 to lastDelay)*/
-    int lastDelay;							/*!< The delay of the furthest computed transition kernel in the transitions vector*/
+    std::map<int,double*> *transitions;		/*!< The cached transition kernels, by number of steps (the one-step kernel being null until it is built, for sparse processes)*/
+    int lastDelay;							/*!< The delay of the furthest computed transition kernel*/
+
+    long cacheBudget;						/*!< If positive, the number of bytes above which the least recently used distributions (except checkpoints) and kernels (for more than one step) are evicted*/
+    int checkpointInterval;					/*!< If positive, only the distributions at multiples of this interval (the checkpoints) and the requested ones are stored, the others being recomputed from the closest previous one*/
+    long cachedBytes;						/*!< The number of bytes used by the evictable distributions and kernels*/
+
+    SparseMatrix *sparseTransition;			/*!< If not null, the one-step transition kernel in compressed rows (one row per next state), the dense one being only built on demand*/
+    SparseMatrix *sparseSuccessors;			/*!< If not null, the transpose of sparseTransition (one row per current state), to sample trajectories*/
+
+    AliasTable *transitionSampler;			/*!< Alias tables of the next state knowing each current state, built on demand by buildSamplers (null otherwise)*/
+    AliasTable *distributionSampler;		/*!< Alias table of the state distribution at samplerTime, built on demand by buildSamplers (null otherwise)*/
+    int samplerTime;						/*!< The time of the distribution sampled by distributionSampler*/
 				
     /*!
      * \brief Constructor
      * \param size : The size of the Markov chain state space
+     * \param dense : If false, the dense transition kernel is not allocated, and a sparse one should be given by setSparseTransition
      */
-    MarkovProcess (int size);
+    MarkovProcess (int size, bool dense = true);
 
     /*!
      * \brief Destructor
@@ -105,28 +143,52 @@ public:
      */
     void setTransition (int i, double *array);
 
+    /*!
+     * \brief Set the transition kernel from a sparse matrix (which is then owned by the process), unless it is too filled (see DENSE_FILL), in which case it is copied into the dense kernel
+     * \param successors : A sparse matrix whose row i gives the probabilities of the next states knowing that the current state is i
+     */
+    void setSparseTransition (SparseMatrix *successors);
+
+    /*!
+     * \brief Bound the memory used by the distributions and the transition kernels (by default, all of them are kept)
+     * \param budget : The number of bytes above which the least recently used ones are evicted (0 for no bound), checkpoints not included
+     * \param interval : The interval between two checkpoints (0 to store all computed distributions)
+     * \warning When the cache is bounded, a pointer returned by getDistribution or getTransition is only valid until PINNED_ENTRIES other ones have been requested
+     */
+    void setCacheBudget (long budget, int interval = 0);
+
     /*!
      * \brief Get the state distribution at a given time (-1 for the stationary distribution)
      */
     double *getDistribution (int time);
 
     /*!
-     * \brief Get the transition kernel for a given number of simulation steps (delay)
+     * \brief Get the transition kernel for a given number of simulation steps (delay), computed from the closest smaller kernel or, for large delays, by squaring
      */
     double *getTransition (int delay);
 
     /*!
-     * \brief Compute the stationary distribution of the Markov chain by iterating the transition kernel
+     * \brief Compute the stationary distribution of the Markov chain by iterating the transition kernel from the distribution at lastTime, in two buffers (the iterates are not stored in the distributions vector)
      * \param threshold : Determines stationarity by giving the minimal difference between two probability values in two different but consecutive distributions
-     * \warning Will endlessly loop for periodic Markov chains
+     * \param method : The iterative method
+     * \param maxIterations : If positive, the iteration stops after this number of steps, even if the threshold has not been reached
+     * \return The number of iterations
+     * \warning Will endlessly loop for periodic Markov chains with the power iteration if maxIterations is not set
+     */
+    int computeStationaryDistribution (double threshold, StationaryMethod method = POWER_ITERATION, int maxIterations = 0);
+
+    /*!
+     * \brief Build the alias tables used to sample trajectories starting at a given time (this is done by computeTrajectory if needed, but should be done beforehand when trajectories are computed in parallel)
      */
-    void computeStationaryDistribution (double threshold);
+    void buildSamplers (int time);
 
     /*!
-     * \brief Compute a possible trajectory of the Markov chain
+     * \brief Compute a possible trajectory of the Markov chain, each state being sampled in constant time
+     * \param time : Time of the first state of the trajectory
      * \param length : Length of the trajectory
+     * \param random : The random generator (if null, the one of the calling thread)
      */
-    MarkovTrajectory *computeTrajectory (int time, int length);
+    MarkovTrajectory *computeTrajectory (int time, int length, RandomGenerator *random = 0);
 
     /*!
      * \brief Get the probability to be in a given state at a given time (-1 for the stationary distribution)
@@ -175,8 +237,54 @@ public:
      */
     double getInformationFlow (Partition *partition, int delay, int time);
 
+    /*!
+     * \brief Compute the entropy and the information tables of all the intervals of an ordered current partition (the interval from part i to part i+j being stored at i+j*microSize), by running sums from each interval start, in parallel
+     * \param currentPartition : The ordered partition, each part being identified by its value (from 0 to its size minus one)
+     * \param nextPartition : The partition of the next states, each part being identified by its id (from 0 to its size minus one)
+     * \param macroEntropy, macroInformation : Arrays of size microSize*microSize (where microSize is the size of currentPartition)
+     */
+    void computeOrderedTables (Partition *nextPartition, Partition *currentPartition, int delay, int time, double *macroEntropy, double *macroInformation);
+
     int *getOptimalCut (int microSize, double *macroEntropy, double *macroInformation, double beta);
+
+    /*!
+     * \brief Compute the optimal ordered partitions for all values of beta, by dichotomy on the parameter, from tables given by computeOrderedTables (which can then be reused for several thresholds)
+     */
+    std::set<OrderedPartition*> *getOptimalOrderedPartition (int microSize, double *macroEntropy, double *macroInformation, double threshold);
     std::set<OrderedPartition*> *getOptimalOrderedPartition (Partition *nextPartition, Partition *currentPartition, int delay, int time, double threshold);
+
+private:
+    std::list<int> cacheEntries;			/*!< The evictable distributions (by time) and kernels (by delay, with a minus sign), from the most to the least recently used*/
+    std::unordered_map<int,std::list<int>::iterator> cacheEntryPositions;	/*!< The position of each evictable entry in cacheEntries*/
+    std::vector<int> lockedDelays;			/*!< The delays of the kernels that cannot be evicted while they are used*/
+
+    void allocateTransition ();
+    void clearSamplers ();
+
+    bool isCheckpoint (int time) { return time == 0 || (checkpointInterval > 0 && time % checkpointInterval == 0); }
+    void storeDistribution (int time, double *dist);
+    void storeTransition (int delay, double *trans);
+
+    /*!
+     * \brief Mark an evictable distribution or kernel as the most recently used one (see cacheEntries)
+     */
+    void touchCacheEntry (int key);
+
+    /*!
+     * \brief Evict the least recently used distributions and kernels until the cache fits in its budget (in constant time per evicted entry)
+     */
+    void evictCache ();
+
+    /*!
+     * \brief Return an array giving, for each state, the rank of its part within a partition (-1 if no part contains it)
+     */
+    int *getPartIndices (Partition *partition);
+
+    /*!
+     * \brief Lump the transition kernel for a given delay into a macro matrix, by a single pass over its non-null entries: lumped[b*currentNumber+a] receives the sum, for all states i in a and j in b, of currentWeights[i] times the probability to go from i to j
+     * \param nextIndices, currentIndices : The parts of the next and current states (states with a negative index are ignored)
+     */
+    void lumpTransition (int *nextIndices, int nextNumber, int *currentIndices, int currentNumber, double *currentWeights, int delay, double *lumped);
 };
 
 
@@ -200,15 +308,43 @@ class MarkovDataSet
 public:
     MarkovProcess *process;
 
-    int size;
-    int time;
-    int length;
-    MarkovTrajectory **trajectories;
+    int size;								/*!< The number of trajectories*/
+    int time;								/*!< The time of the first state of each trajectory*/
+    int length;								/*!< The length of each trajectory*/
+    int stateBytes;							/*!< The width of the stored states (1, 2 or 4 bytes, the narrowest one holding all the states of the process)*/
+    unsigned char *states;					/*!< The states of all trajectories in a single array, the l-th state of the t-th trajectory being at index t*length+l (in units of stateBytes)*/
+
+    /*!
+     * \brief Constructor, computing the trajectories in parallel (trajectory t uses the stream t of a counter-based generator, so that the dataset only depends on the seed, not on the number of threads)
+     * \param seed : The seed of the trajectories (if 0, it is drawn from the generator of the calling thread)
+     * \param fileName : If not empty, the trajectories are written in this file through a memory mapping (so that the dataset may exceed the memory, and be loaded again by the other constructor)
+     */
+    MarkovDataSet (MarkovProcess *process, int size, int time, int length, unsigned long long seed = 0, std::string fileName = "");
+
+    /*!
+     * \brief Constructor, mapping (read-only) the trajectories of a file written by the other constructor
+     * \param process : The process that generated the trajectories (only its size is checked)
+     */
+    MarkovDataSet (MarkovProcess *process, std::string fileName);
 
-    MarkovDataSet (MarkovProcess *process, int size, int time, int length);
     ~MarkovDataSet ();
 
+    /*!
+     * \brief Get the l-th state of the t-th trajectory
+     */
+    int getState (int t, int l) const
+    {
+		long index = (long) t*length + l;
+		if (stateBytes == 1) { return states[index]; }
+		if (stateBytes == 2) { return ((const uint16_t*) states)[index]; }
+		return ((const uint32_t*) states)[index];
+    }
+
     double computeScore (Partition *preP, Partition *postP, int delay, int trainingLength);
+
+private:
+    unsigned char *mapping;					/*!< If not null, the memory mapping of the file holding the header and the states*/
+    long mappingBytes;						/*!< The size of the memory mapping*/
 };
 
 
@@ -0,0 +1,201 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+
+#include "matrix_tools.hpp"
+#include "parallel_tools.hpp"
+
+
+// Blocks of BLOCK_ROWS rows of c are computed by independent tasks; within a task, BLOCK_DEPTH rows of b
+// (times BLOCK_COLUMNS columns) are reused from cache for all the rows of the block
+static const int BLOCK_ROWS = 32;
+static const int BLOCK_DEPTH = 128;
+static const int BLOCK_COLUMNS = 512;
+
+// Sparse matrix-vector products only read each row once: their tasks are blocks of SPARSE_BLOCK_ROWS rows, large enough to amortise scheduling
+static const int SPARSE_BLOCK_ROWS = 512;
+
+
+void multiplyMatrices (const double *a, const double *b, double *c, int size, int threadNumber)
+{
+	int blockNumber = (size + BLOCK_ROWS - 1) / BLOCK_ROWS;
+	parallelFor(blockNumber, [=] (int block)
+	{
+		int iMin = block * BLOCK_ROWS;
+		int iMax = std::min(iMin + BLOCK_ROWS, size);
+		std::fill(c + (long) iMin * size, c + (long) iMax * size, 0.);
+
+		for (int jMin = 0; jMin < size; jMin += BLOCK_COLUMNS)
+		{
+			int jMax = std::min(jMin + BLOCK_COLUMNS, size);
+			for (int kMin = 0; kMin < size; kMin += BLOCK_DEPTH)
+			{
+				int kMax = std::min(kMin + BLOCK_DEPTH, size);
+				for (int i = iMin; i < iMax; i++)
+				{
+					double *__restrict__ cRow = c + (long) i * size;
+					const double *aRow = a + (long) i * size;
+					for (int k = kMin; k < kMax; k++)
+					{
+						double aik = aRow[k];
+						if (aik == 0) { continue; }
+
+						// Contiguous inner loop, vectorised by the compiler
+						const double *__restrict__ bRow = b + (long) k * size;
+						for (int j = jMin; j < jMax; j++) { cRow[j] += aik * bRow[j]; }
+					}
+				}
+			}
+		}
+	}, threadNumber);
+}
+
+
+void multiplyMatrixVector (const double *a, const double *x, double *y, int size, int threadNumber)
+{
+	int blockNumber = (size + BLOCK_ROWS - 1) / BLOCK_ROWS;
+	parallelFor(blockNumber, [=] (int block)
+	{
+		int iMax = std::min((block+1) * BLOCK_ROWS, size);
+		for (int i = block * BLOCK_ROWS; i < iMax; i++)
+		{
+			const double *__restrict__ aRow = a + (long) i * size;
+
+			// Four independent partial sums, so that the reduction is not serialised on one register
+			double sums [4] = {0,0,0,0};
+			int j = 0;
+			for ( ; j + 4 <= size; j += 4) { for (int l = 0; l < 4; l++) { sums[l] += aRow[j+l] * x[j+l]; } }
+			for ( ; j < size; j++) { sums[0] += aRow[j] * x[j]; }
+			y[i] = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+		}
+	}, threadNumber);
+}
+
+
+
+SparseMatrix::SparseMatrix (int s)
+{
+	size = s;
+	offsets.reserve(size+1);
+	offsets.push_back(0);
+}
+
+
+void SparseMatrix::addRow (std::vector< std::pair<int,double> > &entries)
+{
+	std::sort(entries.begin(),entries.end());
+	for (unsigned int e = 0; e < entries.size(); e++)
+	{
+		if (e > 0 && entries[e].first == entries[e-1].first) { values.back() += entries[e].second; continue; }
+		columns.push_back(entries[e].first);
+		values.push_back(entries[e].second);
+	}
+	offsets.push_back(columns.size());
+}
+
+
+double SparseMatrix::get (int row, int column) const
+{
+	std::vector<int>::const_iterator first = columns.begin() + offsets[row];
+	std::vector<int>::const_iterator last = columns.begin() + offsets[row+1];
+	std::vector<int>::const_iterator it = std::lower_bound(first,last,column);
+	if (it == last || *it != column) { return 0; }
+	return values[it - columns.begin()];
+}
+
+
+SparseMatrix *SparseMatrix::transpose () const
+{
+	// Counting sort of the entries by column: rows of the transpose are filled in order, hence sorted
+	SparseMatrix *t = new SparseMatrix (size);
+	t->offsets.assign(size+1,0);
+	for (unsigned long e = 0; e < columns.size(); e++) { t->offsets[columns[e]+1]++; }
+	for (int i = 0; i < size; i++) { t->offsets[i+1] += t->offsets[i]; }
+
+	t->columns.resize(columns.size());
+	t->values.resize(values.size());
+	std::vector<long> positions (t->offsets.begin(), t->offsets.end()-1);
+	for (int i = 0; i < size; i++)
+		for (long e = offsets[i]; e < offsets[i+1]; e++)
+		{
+			long position = positions[columns[e]]++;
+			t->columns[position] = i;
+			t->values[position] = values[e];
+		}
+	return t;
+}
+
+
+void SparseMatrix::toDense (double *a) const
+{
+	std::fill(a, a + (long) size * size, 0.);
+	for (int i = 0; i < size; i++)
+		for (long e = offsets[i]; e < offsets[i+1]; e++) { a[(long) i * size + columns[e]] = values[e]; }
+}
+
+
+void SparseMatrix::multiplyVector (const double *x, double *y, int threadNumber) const
+{
+	int blockNumber = (size + SPARSE_BLOCK_ROWS - 1) / SPARSE_BLOCK_ROWS;
+	parallelFor(blockNumber, [=] (int block)
+	{
+		int iMax = std::min((block+1) * SPARSE_BLOCK_ROWS, size);
+		for (int i = block * SPARSE_BLOCK_ROWS; i < iMax; i++)
+		{
+			double sum = 0;
+			for (long e = offsets[i]; e < offsets[i+1]; e++) { sum += values[e] * x[columns[e]]; }
+			y[i] = sum;
+		}
+	}, threadNumber);
+}
+
+
+void SparseMatrix::multiplyDense (const double *b, double *c, int threadNumber) const
+{
+	parallelFor(size, [=] (int i)
+	{
+		double *__restrict__ cRow = c + (long) i * size;
+		std::fill(cRow, cRow + size, 0.);
+		for (long e = offsets[i]; e < offsets[i+1]; e++)
+		{
+			double v = values[e];
+			const double *__restrict__ bRow = b + (long) columns[e] * size;
+			for (int j = 0; j < size; j++) { cRow[j] += v * bRow[j]; }
+		}
+	}, threadNumber);
+}
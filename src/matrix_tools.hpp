@@ -0,0 +1,113 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_MATRIX_TOOLS
+#define INCLUDE_MATRIX_TOOLS
+
+/*!
+ * \file matrix_tools.hpp
+ * \brief Cache-blocked and multithreaded kernels for the dense square matrices of Markov processes (stored row by row), and a compressed sparse row representation for the large sparse ones
+ * \author Robin Lamarche-Perrin
+ * \date 06/11/2015
+ */
+
+#include <vector>
+#include <utility>
+
+
+/*!
+ * \brief Compute the product c = a.b of two square matrices (c should not overlap a or b)
+ * \param size : The number of rows and columns of the matrices
+ * \param threadNumber : The number of threads (if 0, getThreadNumber() is used)
+ */
+void multiplyMatrices (const double *a, const double *b, double *c, int size, int threadNumber = 0);
+
+/*!
+ * \brief Compute the product y = a.x of a square matrix and a vector (y should not overlap x)
+ * \param size : The number of rows and columns of the matrix
+ * \param threadNumber : The number of threads (if 0, getThreadNumber() is used)
+ */
+void multiplyMatrixVector (const double *a, const double *x, double *y, int size, int threadNumber = 0);
+
+
+/*!
+ * \class SparseMatrix
+ * \brief A square matrix in compressed sparse row format (the non-null entries of each row being sorted by column)
+ */
+class SparseMatrix
+{
+public:
+	int size; /** \brief Number of rows and columns */
+	std::vector<long> offsets; /** \brief The entries of row i are stored from offsets[i] to offsets[i+1]-1 */
+	std::vector<int> columns; /** \brief Column of each entry */
+	std::vector<double> values; /** \brief Value of each entry */
+
+	/*!
+	 * \brief Constructor of an empty matrix, whose rows are then added in order by addRow
+	 * \param size : The number of rows and columns
+	 */
+	SparseMatrix (int size);
+
+	/*!
+	 * \brief Add the next row (the entries are sorted by column, and the values of duplicated columns are summed)
+	 */
+	void addRow (std::vector< std::pair<int,double> > &entries);
+
+	long getEntryNumber () const { return columns.size(); }
+	double getFill () const { return (double) columns.size() / size / size; }
+
+	/*!
+	 * \brief Return the entry at a given row and column (by binary search in the row)
+	 */
+	double get (int row, int column) const;
+
+	SparseMatrix *transpose () const;
+	void toDense (double *a) const;
+
+	/*!
+	 * \brief Compute y = m.x (y should not overlap x)
+	 */
+	void multiplyVector (const double *x, double *y, int threadNumber = 0) const;
+
+	/*!
+	 * \brief Compute c = m.b for a dense square matrix b (c should not overlap b)
+	 */
+	void multiplyDense (const double *b, double *c, int threadNumber = 0) const;
+};
+
+
+#endif
@@ -339,11 +339,7 @@ void MultiSet::computeObjectiveValues ()
 }
 
 
-void MultiSet::normalizeObjectiveValues ()
-{
-	initReached();
-	firstMultiSubset->normalizeObjectiveValues();
-}
+void MultiSet::normalizeObjectiveValues () { objective->normalizeObjectiveValues(firstMultiSubset->value); }
 
 
 void MultiSet::printObjectiveValues ()
@@ -674,28 +670,6 @@ void MultiSubset::computeObjectiveValues ()
 }
 
 
-void MultiSubset::normalizeObjectiveValues (ObjectiveValue *maxQual)
-{
-	if (maxQual == 0) { maxQual = value; }
-
-	for (MultiSubsetSetSet::iterator it1 = multiSubsetSetSet->begin(); it1 != multiSubsetSetSet->end(); ++it1)
-	{
-		MultiSubsetSet *multiSubsetSet = *it1;
-		for (MultiSubsetSet::iterator it2 = multiSubsetSet->begin(); it2 != multiSubsetSet->end(); ++it2)
-		{
-			MultiSubset *multiSubset = *it2;
-			if (!multiSubset->reached)
-			{
-				multiSubset->reached = true;
-				multiSubset->normalizeObjectiveValues(maxQual);
-			}
-		}
-	}
-
-	value->normalize(maxQual);
-}
-
-
 void MultiSubset::printObjectiveValues ()
 {
 	printIndexSet();
@@ -750,6 +724,48 @@ void MultiSubset::computeOptimalPartition (double parameter)
 			optimalCut = multiSubsetSet;
 		}
 	}
+
+	// Refinements generated on demand by the uni-dimensional sets, only the best one being kept
+	int *multiNum = new int [dimension];
+	for (int d = 0; d < dimension; d++) { multiNum[d] = uniSubsetArray[d]->num; }
+
+	for (int d = 0; d < dimension; d++)
+	{
+		UniSubsetSetSet refinements;
+		uniSubsetArray[d]->uniSet->getLazyRefinements(uniSubsetArray[d],refinements);
+
+		for (UniSubsetSetSet::iterator it1 = refinements.begin(); it1 != refinements.end(); ++it1)
+		{
+			MultiSubsetSet multiSubsetSet;
+			for (UniSubsetSet::iterator it2 = (*it1)->begin(); it2 != (*it1)->end(); ++it2)
+			{
+				multiNum[d] = (*it2)->num;
+				multiSubsetSet.push_back(multiSet->multiSubsetArray[multiSet->getNum(multiNum)]);
+			}
+			multiNum[d] = uniSubsetArray[d]->num;
+			delete *it1;
+
+			double value = 0;
+			for (MultiSubsetSet::iterator it2 = multiSubsetSet.begin(); it2 != multiSubsetSet.end(); ++it2)
+			{
+				MultiSubset *multiSubset = *it2;
+				if (!multiSubset->reached)
+				{
+					multiSubset->reached = true;
+					multiSubset->computeOptimalPartition(parameter);
+				}
+				value += multiSubset->optimalValue;
+			}
+
+			if ((objective->maximize && value >= optimalValue) || (!objective->maximize && value <= optimalValue))
+			{
+				optimalValue = value;
+				lazyCut.swap(multiSubsetSet);
+				optimalCut = &lazyCut;
+			}
+		}
+	}
+	delete [] multiNum;
 }
 
 
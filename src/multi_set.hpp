@@ -184,6 +184,7 @@ public:
 	ObjectiveValue *value;
 	double optimalValue;
 	MultiSubsetSet *optimalCut;
+	MultiSubsetSet lazyCut;
 
 	MultiSubset (UniSubset **uniSubsetArray, int dimension);
 	~MultiSubset ();
@@ -197,7 +198,6 @@ public:
 
 	void buildDataStructure ();
 	void computeObjectiveValues ();
-	void normalizeObjectiveValues (ObjectiveValue *maxQual = 0);
 	void printObjectiveValues ();
 
 	void computeOptimalPartition (double parameter);
@@ -147,6 +147,7 @@ void NonconstrainedSet::print ()
 }
 
 
+void NonconstrainedSet::setSpillDirectory (std::string directory) { dataTree->setSpillDirectory(directory); }
 void NonconstrainedSet::computeObjectiveValues () { objective->computeObjectiveValues(); dataTree->computeObjectiveValues(); }
 void NonconstrainedSet::normalizeObjectiveValues () { dataTree->normalizeObjectiveValues(); }
 void NonconstrainedSet::printObjectiveValues () { dataTree->printObjectiveValues(); }
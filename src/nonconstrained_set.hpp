@@ -69,6 +69,7 @@ class NonconstrainedSet: public AbstractSet
 		int printPartitions (bool print = true);
 
 		void buildDataStructure ();
+		void setSpillDirectory (std::string directory);
 		void computeObjectiveValues ();
 		void normalizeObjectiveValues ();
 		void printObjectiveValues ();
@@ -53,3 +53,5 @@ ObjectiveFunction::~ObjectiveFunction()
 
 
 ObjectiveValue::~ObjectiveValue() {}
+
+void ObjectiveValue::release () {}
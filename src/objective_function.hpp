@@ -81,6 +81,12 @@ public:
      */
 	virtual void computeObjectiveValues () = 0;
 	
+	/*!
+	 * \brief This method is called by child classes of AbstractSet (do not use directly)
+	 * \param normalizingValue : The objective value of the whole set, from which the normalising factors applied by ObjectiveValue::getValue (double param) are computed (objective values themselves are not modified)
+     */
+	virtual void normalizeObjectiveValues (ObjectiveValue *normalizingValue) = 0;
+	
 	/*!
 	 * \brief This method is called by child classes of AbstractSet (do not use directly)
      */
@@ -110,9 +116,13 @@ public:
 	virtual void compute () = 0;
 	virtual void compute (ObjectiveValue *value1, ObjectiveValue *value2) = 0;
 	virtual void compute (ObjectiveValueSet *valueSet) = 0;
-	virtual void normalize (ObjectiveValue *normalizingValue) = 0;
 	virtual double getValue (double param) = 0;
 
+	/*!
+	 * \brief Release the data that is only needed to compute the values of larger subsets (called by sets that do not need it anymore, the value itself being kept)
+	 */
+	virtual void release ();
+
 	virtual void print (bool verbose = true) = 0;
 };
 
@@ -43,6 +43,7 @@
 #include "programs.hpp"
 #include "prediction_programs.hpp"
 
+#include "random_tools.hpp"
 #include "uni_set.hpp"
 
 
@@ -54,7 +55,9 @@ bool NORMALIZED_OBJECTIVE = true;
 
 int main (int argc, char *argv[])
 {
-    srand(time(NULL));
+    unsigned long long seed = time(NULL);
+    srand(seed);
+    setRandomSeed(seed);
 
 	//testHierarchicalSet();
 	//testOrderedSet();
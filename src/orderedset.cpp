@@ -94,23 +94,23 @@ void OrderedSet::print ()
 
 void OrderedSet::computeObjectiveValues ()
 {
+	objective->computeObjectiveValues();
+
 	for (int i = 0; i < size; i++)
 		qualities[getIndex(i,0)]->compute();
 		
-	for (int j = 1; j < size; j++)
-		for (int i = 0; i < size-j; i++)
+	// Intervals are computed from left to right, each one being released once the next one is computed
+	for (int i = 0; i < size; i++)
+		for (int j = 1; j < size-i; j++)
+		{
 			qualities[getIndex(i,j)]->compute(qualities[getIndex(i,j-1)],qualities[getIndex(i+j,0)]);
+			if (j > 1) { qualities[getIndex(i,j-1)]->release(); }
+			if (j == size-i-1) { qualities[getIndex(i,j)]->release(); }
+		}
 }
 
 
-void OrderedSet::normalizeObjectiveValues ()
-{
-	ObjectiveValue *maxQual = qualities[getIndex(0,size-1)];
-
-	for (int j = 0; j < size; j++)
-		for (int i = 0; i < size-j; i++)
-			qualities[getIndex(i,j)]->normalize(maxQual);
-}
+void OrderedSet::normalizeObjectiveValues () { objective->normalizeObjectiveValues(qualities[getIndex(0,size-1)]); }
 
 
 void OrderedSet::printObjectiveValues ()
@@ -0,0 +1,77 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "parallel_tools.hpp"
+
+
+static int THREAD_NUMBER = 0;
+
+
+int getThreadNumber ()
+{
+	if (THREAD_NUMBER > 0) { return THREAD_NUMBER; }
+	int hardwareThreads = std::thread::hardware_concurrency();
+	if (hardwareThreads > 0) { return hardwareThreads; } else { return 1; }
+}
+
+
+void setThreadNumber (int threadNumber) { THREAD_NUMBER = threadNumber; }
+
+
+void parallelFor (int n, const std::function<void (int)> &f, int threadNumber)
+{
+	if (threadNumber <= 0) { threadNumber = getThreadNumber(); }
+	if (threadNumber > n) { threadNumber = n; }
+
+	if (threadNumber <= 1)
+	{
+		for (int i = 0; i < n; i++) { f(i); }
+		return;
+	}
+
+	std::atomic<int> nextIndex (0);
+	std::function<void ()> worker = [&] () { for (int i = nextIndex++; i < n; i = nextIndex++) { f(i); } };
+
+	std::vector<std::thread> threads;
+	for (int t = 1; t < threadNumber; t++) { threads.push_back(std::thread(worker)); }
+	worker();
+	for (int t = 0; t < threadNumber-1; t++) { threads[t].join(); }
+}
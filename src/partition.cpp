@@ -44,6 +44,18 @@
 #include "datatree.hpp"
 
 
+/*!
+ * \brief Mix the bits of a 64-bit integer (finaliser of SplitMix64), used to build fingerprints of parts and partitions
+ */
+static unsigned long long mixFingerprint (unsigned long long x)
+{
+	x += 0x9e3779b97f4a7c15ULL;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+
 Part::Part (ObjectiveValue *q)
 {
     id = -1;
@@ -52,11 +64,16 @@ Part::Part (ObjectiveValue *q)
 	individuals = new std::list<int>();
 	value = q;
 	name = "";
+	fingerprint = 0;
 }
 
 
 Part::Part (Datatree *node, ObjectiveValue *q)
 {
+	id = -1;
+	size = 0;
+	num = -2;
+	fingerprint = 0;
 	individuals = new std::list<int>();
 	while (node->vertex != -1)
 	{
@@ -70,6 +87,10 @@ Part::Part (Datatree *node, ObjectiveValue *q)
 
 Part::Part (Part *p)
 {
+	id = -1;
+	size = 0;
+	num = -2;
+	fingerprint = 0;
 	value = p->value;
 	name = p->name;
 
@@ -98,6 +119,7 @@ void Part::addIndividual (int i, bool front, int v)
 	
 	if (front) { individuals->push_front(i); }
 	else { individuals->push_back(i); }
+	fingerprint += mixFingerprint(i);
 }
 
 
@@ -138,6 +160,8 @@ bool Part::equal (Part *p)
 }
 
 
+unsigned long long Part::getFingerprint () { return fingerprint; }
+
 
 void Part::print (bool endl)
 {
@@ -192,6 +216,9 @@ bool BiPart::equal (Part *p)
 }
 
 
+unsigned long long BiPart::getFingerprint () { return mixFingerprint(mixFingerprint(firstPart->getFingerprint()) ^ secondPart->getFingerprint()); }
+
+
 void BiPart::print (bool endl)
 {
 	firstPart->print();
@@ -235,6 +262,14 @@ bool MultiPart::equal (Part *p)
 }
 
 
+unsigned long long MultiPart::getFingerprint ()
+{
+	unsigned long long f = dimension;
+	for (int d = 0; d < dimension; d++) { f = mixFingerprint(f ^ partArray[d]->getFingerprint()); }
+	return f;
+}
+
+
 void MultiPart::print (bool endl)
 {
 	std::cout << "{";
@@ -264,6 +299,8 @@ Partition::Partition (ObjectiveFunction *m, double param)
 	parameter = param;
 	parts = new std::list<Part*>();
 	if (m != 0) { value = m->newObjectiveValue(); } else { value = 0; }
+	partIds = 0;
+	partIdNumber = 0;
 }
 
 
@@ -272,6 +309,8 @@ Partition::Partition (Partition *p)
 	size = p->size;
 	parameter = p->parameter;
 	value = p->value;
+	partIds = 0;
+	partIdNumber = 0;
 
 	parts = new std::list<Part*>();
 	for (std::list<Part*>::iterator it = p->parts->begin(); it != p->parts->end(); ++it)
@@ -287,6 +326,7 @@ Partition::~Partition ()
 	for(std::list<Part*>::iterator it = parts->begin(); it != parts->end(); it++) { delete *it; }
 	delete parts;
 	if (value != 0) { delete value; }
+	delete [] partIds;
 }
 
 
@@ -294,6 +334,8 @@ void Partition::addPart (Part *p, bool front)
 {
 	size++;
 	if (front) { parts->push_front(p); } else { parts->push_back(p); }
+	delete [] partIds;
+	partIds = 0;
 	if (p->value != 0) { value->add(p->value); }
 }
 
@@ -309,6 +351,25 @@ Part *Partition::findPart (int i)
 }
 
 
+const int *Partition::getPartIds ()
+{
+	if (partIds != 0) { return partIds; }
+
+	partIdNumber = 0;
+	for (std::list<Part*>::iterator it = parts->begin(); it != parts->end(); ++it)
+		for (std::list<int>::iterator it2 = (*it)->individuals->begin(); it2 != (*it)->individuals->end(); ++it2)
+			partIdNumber = std::max(partIdNumber,*it2+1);
+
+	partIds = new int [partIdNumber];
+	std::fill(partIds, partIds + partIdNumber, -1);
+	for (std::list<Part*>::iterator it = parts->begin(); it != parts->end(); ++it)
+		for (std::list<int>::iterator it2 = (*it)->individuals->begin(); it2 != (*it)->individuals->end(); ++it2)
+			partIds[*it2] = (*it)->id;
+
+	return partIds;
+}
+
+
 Part *Partition::getPartFromValue (int v)
 {
     Part *rp = 0;
@@ -350,6 +411,14 @@ bool Partition::equal (Partition *p)
 }
 
 
+unsigned long long Partition::getFingerprint ()
+{
+	unsigned long long f = 0;
+	for (std::list<Part*>::iterator it = parts->begin(); it != parts->end(); ++it) { f += mixFingerprint((*it)->getFingerprint()); }
+	return f;
+}
+
+
 void Partition::print (bool endl)
 {
 	int printSize = 1;
@@ -75,6 +75,7 @@ public:
 	
 	std::list<int> *individuals;
 	ObjectiveValue *value;
+	unsigned long long fingerprint;
 	
 	Part (ObjectiveValue *value = 0);
 	Part (Part *part);
@@ -85,6 +86,11 @@ public:
 	Vertices *getVertices ();
     bool contains (int i);
 	virtual bool equal (Part *p);
+
+	/*!
+	 * \brief Return a hash of the individuals of this part, independent of the order in which they have been added (two parts are equal iff their fingerprints are equal, up to hash collisions)
+	 */
+	virtual unsigned long long getFingerprint ();
 		
 	virtual void print (bool endl = false);
 	virtual int printSize ();
@@ -106,6 +112,7 @@ public:
 	~BiPart ();
 
 	bool equal (Part *p);
+	unsigned long long getFingerprint ();
 	void print (bool endl = false);
 	int printSize ();
 };
@@ -126,6 +133,7 @@ public:
 	~MultiPart ();
 
 	bool equal (Part *p);
+	unsigned long long getFingerprint ();
 	void print (bool endl = false);
 	int printSize ();
 };
@@ -142,6 +150,9 @@ public:
 	double parameter;
 	std::list<Part*> *parts;
 	ObjectiveValue *value;
+
+	int *partIds; /** \brief If not null, the id of the part containing each individual (-1 if none), built on demand by getPartIds */
+	int partIdNumber; /** \brief The size of the partIds array (the greatest individual plus one) */
 		
 	Partition (ObjectiveFunction *objective = 0, double parameter = 0);
 	Partition (Partition *partition);
@@ -151,7 +162,23 @@ public:
 	Part *findPart (int individual);
     Part *getPartFromValue (int value);
 
+	/*!
+	 * \brief Return the array giving the id of the part containing each individual (-1 if none), built at the first call and rebuilt after a part is added (it should thus be built before being read by several threads)
+	 */
+	const int *getPartIds ();
+
+	/*!
+	 * \brief Return the id of the part containing an individual (-1 if none) in constant time
+	 */
+	int getPartId (int individual) { getPartIds(); return (individual < partIdNumber) ? partIds[individual] : -1; }
+
 	bool equal (Partition *p);
+
+	/*!
+	 * \brief Return a hash of the parts of this partition, independent of their order, so that duplicated partitions can be detected without comparing objective values
+	 */
+	unsigned long long getFingerprint ();
+
 	void print (bool endl = false);
 	void printAsOrderedBiSet (std::string *labelMatrix = 0);
 };
@@ -44,9 +44,12 @@
 #include "prediction_dataset.hpp"
 #include "logarithmic_score.hpp"
 #include "quadratic_score.hpp"
+#include "information_bottleneck.hpp"
+#include "orderedset.hpp"
 
 #include "timer.hpp"
 #include "voter_graph.hpp"
+#include "parallel_tools.hpp"
 
 #include <stdlib.h>
 #include <cmath>
@@ -466,3 +469,928 @@ void minimalExample ()
 	delete PDS;
 	delete partition;
 }
+
+
+
+/*
+ * Test the information bottleneck objective to aggregate the states of a Markov chain
+ * (a lazy random walk on a line) while preserving the information they give about
+ * the next state. The same problem is solved with an OrderedSet and with a MultiSet.
+ */
+void testInformationBottleneck ()
+{
+	int size = 8;
+
+	/*
+	 * Build the Markov process: the walker stays with probability 1/2, and otherwise
+	 * moves to one of its neighbours.
+	 */
+	MarkovProcess *process = new MarkovProcess (size);
+
+	double *distribution = new double [size];
+	for (int i = 0; i < size; i++) { distribution[i] = 1. / size; }
+	process->setDistribution(distribution);
+
+	double *transition = new double [size];
+	for (int i = 0; i < size; i++)
+	{
+		for (int j = 0; j < size; j++) { transition[j] = 0; }
+		transition[i] = 0.5;
+		if (i == 0) { transition[i+1] = 0.5; }
+		else if (i == size-1) { transition[i-1] = 0.5; }
+		else { transition[i-1] = 0.25; transition[i+1] = 0.25; }
+		process->setTransition(i,transition);
+	}
+
+	/*
+	 * Both structures share the same objective, hence the same distributions and
+	 * transition kernel cached in the Markov process.
+	 */
+	InformationBottleneck *objective = new InformationBottleneck (process, 2);
+
+	OrderedSet *orderedSet = new OrderedSet (size);
+	orderedSet->buildDataStructure();
+	orderedSet->setObjectiveFunction(objective);
+	orderedSet->computeObjectiveValues();
+
+	UniSet *uniSet = new OrderedUniSet (size);
+	uniSet->buildDataStructure();
+
+	MultiSet *multiSet = new MultiSet (uniSet);
+	multiSet->buildDataStructure();
+	multiSet->setObjectiveFunction(objective);
+	multiSet->computeObjectiveValues();
+
+	orderedSet->printOptimalPartitionList(0.01);
+	multiSet->printOptimalPartitionList(0.01);
+
+	/*
+	 * Free memory.
+	 */
+	delete orderedSet;
+	delete multiSet;
+	delete uniSet;
+	delete objective;
+	delete process;
+	delete [] distribution;
+	delete [] transition;
+
+	/*
+	 * The same walk on a longer line, with a dense and a sparse kernel: both should give the
+	 * same partitions, the joint distributions being propagated through one step at a time.
+	 */
+	int longSize = 200;
+	int delay = 3;
+	MarkovProcess *denseProcess = new MarkovProcess (longSize);
+	MarkovProcess *sparseProcess = new MarkovProcess (longSize,false);
+	SparseMatrix *successors = new SparseMatrix (longSize);
+	std::vector< std::pair<int,double> > entries;
+	double *column = new double [longSize];
+
+	for (int i = 0; i < longSize; i++)
+	{
+		entries.clear();
+		if (i > 0) { entries.push_back(std::make_pair(i-1,(i == longSize-1) ? 0.5 : 0.25)); }
+		entries.push_back(std::make_pair(i,0.5));
+		if (i < longSize-1) { entries.push_back(std::make_pair(i+1,(i == 0) ? 0.5 : 0.25)); }
+		successors->addRow(entries);
+
+		for (int j = 0; j < longSize; j++) { column[j] = 0; }
+		for (unsigned int e = 0; e < entries.size(); e++) { column[entries[e].first] = entries[e].second; }
+		denseProcess->setTransition(i,column);
+		denseProcess->distribution[i] = 1. / longSize;
+		sparseProcess->distribution[i] = 1. / longSize;
+	}
+	sparseProcess->setSparseTransition(successors);
+
+	InformationBottleneck *denseObjective = new InformationBottleneck (denseProcess, delay);
+	InformationBottleneck *sparseObjective = new InformationBottleneck (sparseProcess, delay);
+	OrderedSet *denseSet = new OrderedSet (longSize);
+	OrderedSet *sparseSet = new OrderedSet (longSize);
+	denseSet->buildDataStructure();
+	sparseSet->buildDataStructure();
+	denseSet->setObjectiveFunction(denseObjective);
+	sparseSet->setObjectiveFunction(sparseObjective);
+	denseSet->computeObjectiveValues();
+	sparseSet->computeObjectiveValues();
+
+	bool error = false;
+	for (double unit = 0; unit < 1; unit += 0.05)
+	{
+		double parameter = denseObjective->getParameter(unit);
+		Partition *p1 = denseSet->getOptimalPartition(parameter);
+		Partition *p2 = sparseSet->getOptimalPartition(parameter);
+		if (p1->getFingerprint() != p2->getFingerprint()) { std::cout << "ERROR: parameter = " << parameter << " -> DIFFERENT PARTITIONS WITH THE DENSE AND THE SPARSE KERNELS" << std::endl; error = true; }
+		delete p1;
+		delete p2;
+	}
+	if (!error) { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	delete denseSet;
+	delete sparseSet;
+	delete denseObjective;
+	delete sparseObjective;
+	delete denseProcess;
+	delete sparseProcess;
+	delete [] column;
+}
+
+
+/*
+ * Markov process with a uniform initial distribution and a random dense transition kernel.
+ */
+static MarkovProcess *getRandomMarkovProcess (int size)
+{
+	MarkovProcess *process = new MarkovProcess (size);
+
+	double *distribution = new double [size];
+	for (int i = 0; i < size; i++) { distribution[i] = 1. / size; }
+	process->setDistribution(distribution);
+
+	double *transition = new double [size];
+	for (int i = 0; i < size; i++)
+	{
+		double sum = 0;
+		for (int j = 0; j < size; j++) { transition[j] = rand() % 100; sum += transition[j]; }
+		for (int j = 0; j < size; j++) { transition[j] /= sum; }
+		process->setTransition(i,transition);
+	}
+
+	delete [] distribution;
+	delete [] transition;
+	return process;
+}
+
+
+/*
+ * Markov process with the same initial distribution and kernel as a sparse one, stored densely.
+ */
+static MarkovProcess *getDenseMarkovProcess (MarkovProcess *sparseProcess)
+{
+	MarkovProcess *denseProcess = new MarkovProcess (sparseProcess->size);
+	denseProcess->setDistribution(sparseProcess->distribution);
+	sparseProcess->sparseTransition->toDense(denseProcess->transition);
+	return denseProcess;
+}
+
+
+/*
+ * Compare the transition kernels and distributions of a random dense Markov process
+ * with the ones computed by naive loops, and time both.
+ */
+void benchmarkMarkovKernels ()
+{
+	int size = 256;
+	int delay = 50;
+
+	MarkovProcess *process = getRandomMarkovProcess(size);
+
+	/*
+	 * Naive kernels: each power of the transition kernel is computed from the previous one.
+	 */
+	double *naiveTrans = new double [size*size];
+	double *currentTrans = new double [size*size];
+	double *naiveDist = new double [size];
+	double *currentDist = new double [size];
+	for (int k = 0; k < size*size; k++) { currentTrans[k] = process->transition[k]; }
+	for (int i = 0; i < size; i++) { currentDist[i] = process->distribution[i]; }
+
+	double start = getWallTime();
+	for (int d = 2; d <= delay; d++)
+	{
+		for (int i = 0; i < size; i++)
+			for (int j = 0; j < size; j++)
+			{
+				naiveTrans[j*size+i] = 0;
+				for (int k = 0; k < size; k++) { naiveTrans[j*size+i] += process->transition[j*size+k] * currentTrans[k*size+i]; }
+			}
+		std::swap(naiveTrans,currentTrans);
+	}
+	for (int t = 1; t <= delay; t++)
+	{
+		for (int i = 0; i < size; i++)
+		{
+			naiveDist[i] = 0;
+			for (int j = 0; j < size; j++) { naiveDist[i] += currentDist[j] * process->transition[i*size+j]; }
+		}
+		std::swap(naiveDist,currentDist);
+	}
+	std::cout << "NAIVE KERNELS: " << (getWallTime() - start) << " sec" << std::endl;
+
+	start = getWallTime();
+	double *trans = process->getTransition(delay);
+	double *dist = process->getDistribution(delay);
+	std::cout << "BLOCKED KERNELS: " << (getWallTime() - start) << " sec" << std::endl;
+
+	double error = 0;
+	for (int k = 0; k < size*size; k++) { error = std::max(error,std::abs(trans[k] - currentTrans[k])); }
+	for (int i = 0; i < size; i++) { error = std::max(error,std::abs(dist[i] - currentDist[i])); }
+	if (error > 1e-12) { std::cout << "ERROR: maximal difference = " << error << std::endl; }
+	else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	delete process;
+	delete [] naiveTrans;
+	delete [] currentTrans;
+	delete [] naiveDist;
+	delete [] currentDist;
+}
+
+
+/*
+ * Compare the sparse Markov process of a voter ring with its dense counterpart, then
+ * time the sparse one on a ring large enough for its dense kernel not to fit in memory.
+ */
+void benchmarkSparseVoterProcess ()
+{
+	int smallSize = 10;
+	int largeSize = 20;
+	int time = 50;
+	double contrarian = 0.1;
+
+	VoterGraph *VG = new ChainVoterGraph (smallSize,contrarian,true);
+	MarkovProcess *sparseProcess = VG->getMarkovProcess();
+	int size = sparseProcess->size;
+
+	MarkovProcess *denseProcess = getDenseMarkovProcess(sparseProcess);
+
+	double error = 0;
+	double *dist1 = sparseProcess->getDistribution(time);
+	double *dist2 = denseProcess->getDistribution(time);
+	for (int i = 0; i < size; i++) { error = std::max(error,std::abs(dist1[i] - dist2[i])); }
+
+	double *trans1 = sparseProcess->getTransition(3);
+	double *trans2 = denseProcess->getTransition(3);
+	for (long k = 0; k < (long) size*size; k++) { error = std::max(error,std::abs(trans1[k] - trans2[k])); }
+
+	for (int i = 0; i < size; i++)
+		for (int j = 0; j < size; j++)
+			error = std::max(error,std::abs(sparseProcess->getNextProbability(j,i,1) - denseProcess->getNextProbability(j,i,1)));
+
+	if (error > 1e-12) { std::cout << "ERROR: maximal difference = " << error << std::endl; }
+	else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	delete sparseProcess;
+	delete denseProcess;
+	delete VG;
+
+	VG = new ChainVoterGraph (largeSize,contrarian,true);
+	double start = getWallTime();
+	MarkovProcess *process = VG->getMarkovProcess();
+	std::cout << "VOTER RING OF " << largeSize << " NODES: " << process->size << " STATES, " << process->sparseTransition->getEntryNumber() << " TRANSITIONS in " << (getWallTime() - start) << " sec" << std::endl;
+
+	start = getWallTime();
+	process->getDistribution(time);
+	std::cout << "DISTRIBUTION AT TIME " << time << " in " << (getWallTime() - start) << " sec" << std::endl;
+
+	start = getWallTime();
+	MarkovTrajectory *trajectory = process->computeTrajectory(time,10000);
+	std::cout << "TRAJECTORY OF " << trajectory->length << " STEPS in " << (getWallTime() - start) << " sec" << std::endl;
+
+	delete trajectory;
+	delete process;
+	delete VG;
+}
+
+
+/*
+ * Compute the stationary distribution of a voter ring with contrarian nodes (an irreducible
+ * chain) by power iteration and by Gauss-Seidel, and check that both are fixed points.
+ */
+void benchmarkStationaryDistribution ()
+{
+	int size = 16;
+	double contrarian = 0.1;
+	double threshold = 1e-12;
+
+	VoterGraph *VG = new ChainVoterGraph (size,contrarian,true);
+	MarkovProcess *process = VG->getMarkovProcess();
+	int stateNumber = process->size;
+	double *nextDist = new double [stateNumber];
+	double *dist [2];
+
+	StationaryMethod methods [2] = {POWER_ITERATION, GAUSS_SEIDEL};
+	std::string names [2] = {"POWER ITERATION", "GAUSS-SEIDEL"};
+	bool error = false;
+
+	for (int m = 0; m < 2; m++)
+	{
+		double start = getWallTime();
+		int iterations = process->computeStationaryDistribution(threshold,methods[m]);
+		float time = (getWallTime() - start);
+
+		dist[m] = new double [stateNumber];
+		for (int i = 0; i < stateNumber; i++) { dist[m][i] = process->getProbability(i,-1); }
+
+		double residual = 0;
+		process->sparseTransition->multiplyVector(dist[m],nextDist);
+		for (int i = 0; i < stateNumber; i++) { residual = std::max(residual,std::abs(nextDist[i] - dist[m][i])); }
+		if (residual > 1e-9) { error = true; }
+
+		std::cout << names[m] << ": " << iterations << " iterations in " << time << " sec (residual = " << residual << ")" << std::endl;
+	}
+
+	double difference = 0;
+	for (int i = 0; i < stateNumber; i++) { difference = std::max(difference,std::abs(dist[0][i] - dist[1][i])); }
+	if (difference > 1e-6) { error = true; }
+
+	if (error) { std::cout << "ERROR: maximal difference = " << difference << std::endl; }
+	else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	delete [] dist[0];
+	delete [] dist[1];
+	delete [] nextDist;
+	delete process;
+	delete VG;
+}
+
+
+/*
+ * Generate the same dataset of voter ring trajectories with one and several threads and check
+ * that they are identical, compare the empirical transition frequencies to the kernel, then time
+ * the alias sampler against a linear scan of a random dense kernel.
+ */
+void benchmarkTrajectorySampler ()
+{
+	int smallSize = 6;
+	int largeSize = 2048;
+	int trajectoryNumber = 200;
+	int length = 1000;
+	double contrarian = 0.1;
+	unsigned long long seed = 42;
+
+	VoterGraph *VG = new ChainVoterGraph (smallSize,contrarian,true);
+	MarkovProcess *process = VG->getMarkovProcess();
+	int size = process->size;
+	double *trans = process->getTransition(1);
+
+	int threadNumber = getThreadNumber();
+	setThreadNumber(1);
+	MarkovDataSet *data1 = new MarkovDataSet (process,trajectoryNumber,0,length,seed);
+	setThreadNumber(4);
+	MarkovDataSet *data2 = new MarkovDataSet (process,trajectoryNumber,0,length,seed);
+	setThreadNumber(threadNumber);
+
+	bool identical = true;
+	for (int t = 0; t < trajectoryNumber; t++)
+		for (int l = 0; l < length; l++)
+			if (data1->getState(t,l) != data2->getState(t,l)) { identical = false; }
+
+	std::vector<double> counts ((long) size*size, 0);
+	std::vector<double> visits (size, 0);
+	for (int t = 0; t < trajectoryNumber; t++)
+		for (int l = 1; l < length; l++)
+		{
+			int i = data1->getState(t,l-1);
+			int j = data1->getState(t,l);
+			counts[(long) j*size+i]++;
+			visits[i]++;
+		}
+
+	// Total variation between the empirical and the theoretical next state distributions, weighted by the visits
+	double variation = 0;
+	double total = 0;
+	for (int i = 0; i < size; i++)
+	{
+		if (visits[i] == 0) { continue; }
+		double v = 0;
+		for (int j = 0; j < size; j++) { v += std::abs(counts[(long) j*size+i] / visits[i] - trans[(long) j*size+i]); }
+		variation += visits[i] * v / 2;
+		total += visits[i];
+	}
+	variation /= total;
+
+	std::cout << "TOTAL VARIATION = " << variation << std::endl;
+	if (!identical) { std::cout << "ERROR: the dataset depends on the number of threads" << std::endl; }
+	else if (variation > 0.05) { std::cout << "ERROR: the empirical transitions do not match the kernel" << std::endl; }
+	else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	delete data1;
+	delete data2;
+	delete process;
+	delete VG;
+
+	size = largeSize;
+	process = getRandomMarkovProcess(size);
+	trans = process->transition;
+	length = 100000;
+
+	double start = getWallTime();
+	int *states = new int [length];
+	int state = 0;
+	states[0] = state;
+	for (int l = 1; l < length; l++)
+	{
+		int nextState = 0;
+		double r = ((double) rand() / (RAND_MAX));
+		while (nextState < size-1 && r > trans[(long) nextState*size+state]) { r -= trans[(long) nextState*size+state]; nextState++; }
+		state = nextState;
+		states[l] = state;
+	}
+	std::cout << "LINEAR SCAN: " << length << " STEPS OVER " << size << " STATES in " << (getWallTime() - start) << " sec" << std::endl;
+
+	start = getWallTime();
+	process->buildSamplers(0);
+	std::cout << "ALIAS TABLES in " << (getWallTime() - start) << " sec" << std::endl;
+
+	start = getWallTime();
+	MarkovTrajectory *trajectory = process->computeTrajectory(0,length);
+	std::cout << "ALIAS SAMPLER: " << trajectory->length << " STEPS in " << (getWallTime() - start) << " sec" << std::endl;
+
+	delete [] states;
+	delete trajectory;
+	delete process;
+}
+
+
+/*
+ * Random partition of the states of a Markov process into a given number of parts (possibly empty).
+ */
+static Partition *getRandomStatePartition (int size, int partNumber)
+{
+	Partition *partition = new Partition ();
+	std::vector<Part*> parts (partNumber);
+	for (int k = 0; k < partNumber; k++) { parts[k] = new Part (); parts[k]->id = k; }
+	for (int i = 0; i < size; i++) { parts[rand() % partNumber]->addIndividual(i); }
+	for (int k = 0; k < partNumber; k++) { partition->addPart(parts[k]); }
+	return partition;
+}
+
+
+/*
+ * Compare the lumped information measures of a voter ring (with sparse and dense kernels) to
+ * their definitions in terms of part-to-part probabilities, then time them on many partitions.
+ */
+void benchmarkLumpedInformation ()
+{
+	int nodeNumber = 8;
+	int partNumber = 12;
+	int partitionNumber = 200;
+	int time = 3;
+	double contrarian = 0.1;
+
+	VoterGraph *VG = new ChainVoterGraph (nodeNumber,contrarian,true);
+	MarkovProcess *sparseProcess = VG->getMarkovProcess();
+	int size = sparseProcess->size;
+	MarkovProcess *denseProcess = getDenseMarkovProcess(sparseProcess);
+
+	Partition *nextPartition = getRandomStatePartition(size,partNumber);
+	Partition *currentPartition = getRandomStatePartition(size,partNumber);
+	double error = 0;
+
+	for (int delay = 1; delay <= 2; delay++)
+	{
+		// Definitions
+		double information = 0;
+		double macroEntropy = 0;
+		double microEntropy = 0;
+		for (std::list<Part*>::iterator it1 = currentPartition->parts->begin(); it1 != currentPartition->parts->end(); ++it1)
+			for (std::list<Part*>::iterator it2 = nextPartition->parts->begin(); it2 != nextPartition->parts->end(); ++it2)
+			{
+				double condProb = denseProcess->getNextProbability(*it2,*it1,delay,time);
+				double nextProb = denseProcess->getProbability(*it2,time+delay);
+				if (condProb > 0 && nextProb > 0) { information += denseProcess->getProbability(*it1,time) * condProb * log2(condProb / nextProb); }
+			}
+		for (std::list<Part*>::iterator it1 = nextPartition->parts->begin(); it1 != nextPartition->parts->end(); ++it1)
+			for (std::list<Part*>::iterator it2 = nextPartition->parts->begin(); it2 != nextPartition->parts->end(); ++it2)
+			{
+				double condProb = denseProcess->getNextProbability(*it2,*it1,delay,time);
+				if (condProb > 0) { macroEntropy += - denseProcess->getProbability(*it1,time) * condProb * log2(condProb); }
+			}
+		for (int i = 0; i < size; i++)
+			for (std::list<Part*>::iterator it = nextPartition->parts->begin(); it != nextPartition->parts->end(); ++it)
+			{
+				double condProb = denseProcess->getNextProbability(*it,i,delay);
+				if (condProb > 0) { microEntropy += - denseProcess->getProbability(i,time) * condProb * log2(condProb); }
+			}
+
+		MarkovProcess *processes [2] = {sparseProcess, denseProcess};
+		for (int p = 0; p < 2; p++)
+		{
+			error = std::max(error,std::abs(processes[p]->getMutualInformation(nextPartition,currentPartition,delay,time) - information));
+			error = std::max(error,std::abs(processes[p]->getNextEntropy(nextPartition,false,delay,time) - macroEntropy));
+			error = std::max(error,std::abs(processes[p]->getNextEntropy(nextPartition,true,delay,time) - microEntropy));
+			error = std::max(error,std::abs(processes[p]->getInformationFlow(nextPartition,delay,time) - (macroEntropy - microEntropy)));
+		}
+	}
+
+	Part *currentPart = currentPartition->parts->front();
+	double partInformation = 0;
+	for (std::list<Part*>::iterator it = nextPartition->parts->begin(); it != nextPartition->parts->end(); ++it)
+	{
+		double condProb = denseProcess->getNextProbability(*it,currentPart,1,time);
+		double nextProb = denseProcess->getProbability(*it,time+1);
+		if (condProb > 0 && nextProb > 0) { partInformation += condProb * log2(condProb / nextProb); }
+	}
+	error = std::max(error,std::abs(sparseProcess->getPartMutualInformation(nextPartition,currentPart,1,time) - partInformation));
+
+	if (error > 1e-10) { std::cout << "ERROR: maximal difference = " << error << std::endl; }
+	else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	delete nextPartition;
+	delete currentPartition;
+
+	std::vector<Partition*> partitions (partitionNumber);
+	for (int k = 0; k < partitionNumber; k++) { partitions[k] = getRandomStatePartition(size,partNumber); }
+
+	double start = getWallTime();
+	double sum = 0;
+	for (int k = 0; k < partitionNumber; k++) { sum += sparseProcess->getMutualInformation(partitions[k],partitions[k],1,time); }
+	std::cout << "MUTUAL INFORMATION OF " << partitionNumber << " PARTITIONS OF " << size << " STATES in " << (getWallTime() - start) << " sec (mean = " << sum / partitionNumber << ")" << std::endl;
+
+	for (int k = 0; k < partitionNumber; k++) { delete partitions[k]; }
+	delete sparseProcess;
+	delete denseProcess;
+	delete VG;
+}
+
+
+/*
+ * Partition of the states of a voter graph by number of agents in state 1 (the part of k agents
+ * has value k and id k), or of each state on its own when perState is true (ordered by index).
+ */
+static Partition *getVoterCountPartition (int nodeNumber, bool perState)
+{
+	int size = 1 << nodeNumber;
+	int partNumber = perState ? size : nodeNumber + 1;
+	Partition *partition = new Partition ();
+	std::vector<Part*> parts (partNumber);
+	for (int k = 0; k < partNumber; k++) { parts[k] = new Part (); parts[k]->id = k; }
+	for (int i = 0; i < size; i++)
+	{
+		int k = perState ? i : __builtin_popcount(i);
+		parts[k]->addIndividual(i,false,k);
+	}
+	for (int k = 0; k < partNumber; k++) { partition->addPart(parts[k]); }
+	return partition;
+}
+
+
+/*
+ * Compare the interval tables of the ordered partitions of a voter ring to their definitions,
+ * then time the tables of a state-level ordered partition and their reuse for many values of beta.
+ */
+void benchmarkOrderedPartition ()
+{
+	int nodeNumber = 8;
+	int largeNodeNumber = 11;
+	int betaNumber = 100;
+	int time = 3;
+	int delay = 2;
+	double contrarian = 0.1;
+	double threshold = 1e-3;
+
+	VoterGraph *VG = new ChainVoterGraph (nodeNumber,contrarian,true);
+	MarkovProcess *process = VG->getMarkovProcess();
+	Partition *currentPartition = getVoterCountPartition(nodeNumber,false);
+	Partition *nextPartition = getVoterCountPartition(nodeNumber,false);
+	int microSize = currentPartition->size;
+
+	std::vector<double> macroEntropy (microSize*microSize);
+	std::vector<double> macroInformation (microSize*microSize);
+	process->computeOrderedTables(nextPartition,currentPartition,delay,time,macroEntropy.data(),macroInformation.data());
+
+	double error = 0;
+	for (int i = 0; i < microSize; i++)
+		for (int j = 0; j < microSize - i; j++)
+		{
+			Part *part = new Part ();
+			for (int k = i; k <= i+j; k++)
+			{
+				Part *microPart = currentPartition->getPartFromValue(k);
+				for (std::list<int>::iterator it = microPart->individuals->begin(); it != microPart->individuals->end(); ++it) { part->addIndividual(*it); }
+			}
+
+			double prob = process->getProbability(part,time);
+			double entropy = (prob > 0) ? - prob * log2(prob) : 0;
+			double information = 0;
+			for (std::list<Part*>::iterator it = nextPartition->parts->begin(); it != nextPartition->parts->end(); ++it)
+			{
+				double condProb = process->getNextProbability(*it,part,delay,time);
+				if (condProb > 0) { information += prob * condProb * log2(condProb / process->getProbability(*it,time+delay)); }
+			}
+
+			error = std::max(error,std::abs(macroEntropy[i+j*microSize] - entropy));
+			error = std::max(error,std::abs(macroInformation[i+j*microSize] - information));
+			delete part;
+		}
+
+	std::set<OrderedPartition*> *pSet = process->getOptimalOrderedPartition(nextPartition,currentPartition,delay,time,threshold);
+	std::cout << pSet->size() << " OPTIMAL ORDERED PARTITIONS OF " << microSize << " PARTS" << std::endl;
+
+	if (error > 1e-10) { std::cout << "ERROR: maximal difference = " << error << std::endl; }
+	else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	for (std::set<OrderedPartition*>::iterator it = pSet->begin(); it != pSet->end(); ++it) { delete [] (*it)->optimalCut; delete *it; }
+	delete pSet;
+	delete currentPartition;
+	delete nextPartition;
+	delete process;
+	delete VG;
+
+	VG = new ChainVoterGraph (largeNodeNumber,contrarian,true);
+	process = VG->getMarkovProcess();
+	currentPartition = getVoterCountPartition(largeNodeNumber,true);
+	nextPartition = getVoterCountPartition(largeNodeNumber,false);
+	microSize = currentPartition->size;
+	macroEntropy.resize((long) microSize*microSize);
+	macroInformation.resize((long) microSize*microSize);
+
+	double start = getWallTime();
+	process->computeOrderedTables(nextPartition,currentPartition,1,time,macroEntropy.data(),macroInformation.data());
+	std::cout << "TABLES OF THE INTERVALS OF " << microSize << " STATES in " << (getWallTime() - start) << " sec" << std::endl;
+
+	start = getWallTime();
+	int partNumber = 0;
+	for (int b = 0; b < betaNumber; b++)
+	{
+		int *optimalCut = process->getOptimalCut(microSize,macroEntropy.data(),macroInformation.data(),b * 10. / betaNumber);
+		for (int i = microSize; i > 0; i = optimalCut[i-1]) { partNumber++; }
+		delete [] optimalCut;
+	}
+	std::cout << "OPTIMAL CUTS FOR " << betaNumber << " VALUES OF BETA in " << (getWallTime() - start) << " sec (" << partNumber << " parts)" << std::endl;
+
+	delete currentPartition;
+	delete nextPartition;
+	delete process;
+	delete VG;
+}
+
+
+/*
+ * Score a partition of voter ring states on a dataset of trajectories, and compare the result
+ * (and the time) with the same score computed by looking up the parts with findPart.
+ */
+void benchmarkMarkovScore ()
+{
+	int nodeNumber = 10;
+	int trajectoryNumber = 100;
+	int length = 2000;
+	int trainingLength = 1000;
+	int delay = 1;
+	double contrarian = 0.1;
+
+	VoterGraph *VG = new ChainVoterGraph (nodeNumber,contrarian,true);
+	MarkovProcess *process = VG->getMarkovProcess();
+	MarkovDataSet *data = new MarkovDataSet (process,trajectoryNumber,0,length,42);
+	Partition *partition = getVoterCountPartition(nodeNumber,false);
+
+	double start = getWallTime();
+	double score = data->computeScore(partition,partition,delay,trainingLength);
+	std::cout << "SCORE = " << score << " in " << (getWallTime() - start) << " sec" << std::endl;
+
+	start = getWallTime();
+	int partNumber = partition->size;
+	std::vector<double> trainDist (partNumber * partNumber, 0);
+	for (int t = 0; t < trajectoryNumber; t++)
+		for (int time = 0; time < trainingLength; time++)
+			trainDist[partition->findPart(data->getState(t,time+delay))->id * partNumber + partition->findPart(data->getState(t,time))->id]++;
+	for (int i = 0; i < partNumber; i++)
+	{
+		double sum = 0;
+		for (int j = 0; j < partNumber; j++) { sum += trainDist[j * partNumber + i]; }
+		if (sum > 0) { for (int j = 0; j < partNumber; j++) { trainDist[j * partNumber + i] /= sum; } }
+	}
+	double naiveScore = 0;
+	int count = 0;
+	for (int t = 0; t < trajectoryNumber; t++)
+		for (int time = trainingLength; time < length - delay; time++)
+		{
+			naiveScore += -log(trainDist[partition->findPart(data->getState(t,time+delay))->id * partNumber + partition->findPart(data->getState(t,time))->id]);
+			count++;
+		}
+	naiveScore /= count;
+	std::cout << "SCORE WITH findPart = " << naiveScore << " in " << (getWallTime() - start) << " sec" << std::endl;
+
+	if (std::abs(score - naiveScore) > 1e-10) { std::cout << "ERROR: difference = " << std::abs(score - naiveScore) << std::endl; }
+	else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	delete partition;
+	delete data;
+	delete process;
+	delete VG;
+}
+
+
+/*
+ * Write a dataset of voter ring trajectories in a file, map it again, and check that it holds
+ * the same states and gives the same score as the dataset generated in memory with the same seed.
+ */
+void benchmarkMarkovDataSetFile ()
+{
+	int nodeNumber = 12;
+	int trajectoryNumber = 10;
+	int length = 1000000;
+	int trainingLength = 500000;
+	std::string fileName = "markov_dataset.bin";
+
+	VoterGraph *VG = new ChainVoterGraph (nodeNumber,0.1,true);
+	MarkovProcess *process = VG->getMarkovProcess();
+	Partition *partition = getVoterCountPartition(nodeNumber,false);
+
+	double start = getWallTime();
+	MarkovDataSet *data = new MarkovDataSet (process,trajectoryNumber,0,length,42,fileName);
+	std::cout << trajectoryNumber << " x " << length << " STATES OF " << data->stateBytes << " BYTES WRITTEN in " << (getWallTime() - start) << " sec" << std::endl;
+	delete data;
+
+	start = getWallTime();
+	MarkovDataSet *mappedData = new MarkovDataSet (process,fileName);
+	double mappedScore = mappedData->computeScore(partition,partition,1,trainingLength);
+	std::cout << "SCORE OF THE MAPPED DATASET = " << mappedScore << " in " << (getWallTime() - start) << " sec" << std::endl;
+
+	data = new MarkovDataSet (process,trajectoryNumber,0,length,42);
+	double score = data->computeScore(partition,partition,1,trainingLength);
+
+	bool identical = (mappedData->size == data->size && mappedData->length == data->length);
+	for (int t = 0; identical && t < trajectoryNumber; t++)
+		for (int l = 0; l < length; l++)
+			if (mappedData->getState(t,l) != data->getState(t,l)) { identical = false; break; }
+
+	if (!identical || score != mappedScore) { std::cout << "ERROR: the mapped dataset differs from the generated one" << std::endl; }
+	else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	delete data;
+	delete mappedData;
+	std::remove(fileName.c_str());
+	delete partition;
+	delete process;
+	delete VG;
+}
+
+
+/*
+ * Request distributions and kernels of voter rings in random order from a process with a bounded
+ * cache and checkpoints, and compare them with the ones of a process keeping all of them.
+ */
+void benchmarkMarkovCache ()
+{
+	int nodeNumber = 10;
+	int horizon = 5000;
+	int interval = 100;
+	int requestNumber = 200;
+	int kernelNodeNumber = 7;
+	int maxDelay = 64;
+
+	VoterGraph *VG = new ChainVoterGraph (nodeNumber,0.1,true);
+	MarkovProcess *process = VG->getMarkovProcess();
+	MarkovProcess *boundedProcess = VG->getMarkovProcess();
+	int size = process->size;
+	boundedProcess->setCacheBudget(64 * size * sizeof(double),interval);
+
+	double start = getWallTime();
+	process->getDistribution(horizon);
+	std::cout << "ALL DISTRIBUTIONS UP TO " << horizon << " in " << (getWallTime() - start) << " sec" << std::endl;
+
+	double error = 0;
+	start = getWallTime();
+	for (int r = 0; r < requestNumber; r++)
+	{
+		int time = rand() % (horizon+1);
+		double *dist = boundedProcess->getDistribution(time);
+		double *refDist = process->getDistribution(time);
+		for (int i = 0; i < size; i++) { error = std::max(error,std::abs(dist[i] - refDist[i])); }
+	}
+	std::cout << requestNumber << " RANDOM DISTRIBUTIONS WITH " << boundedProcess->cachedBytes << " CACHED BYTES in " << (getWallTime() - start) << " sec" << std::endl;
+
+	delete process;
+	delete boundedProcess;
+	delete VG;
+
+	// Evictions should take constant time, whatever the horizon
+	VG = new ChainVoterGraph (4,0.1,true);
+	for (int longHorizon = 20000; longHorizon <= 40000; longHorizon *= 2)
+	{
+		boundedProcess = VG->getMarkovProcess();
+		boundedProcess->setCacheBudget(64 * boundedProcess->size * sizeof(double),interval);
+		start = getWallTime();
+		for (int time = 0; time <= longHorizon; time++) { boundedProcess->getDistribution(time); }
+		std::cout << "ALL DISTRIBUTIONS UP TO " << longHorizon << " ON " << boundedProcess->size << " STATES WITH A BOUNDED CACHE in " << (getWallTime() - start) << " sec" << std::endl;
+		delete boundedProcess;
+	}
+	delete VG;
+
+	VG = new ChainVoterGraph (kernelNodeNumber,0.1,true);
+	process = VG->getMarkovProcess();
+	boundedProcess = VG->getMarkovProcess();
+	size = process->size;
+	boundedProcess->setCacheBudget(6 * size * size * sizeof(double));
+
+	for (int r = 0; r < requestNumber / 4; r++)
+	{
+		int delay = 1 + rand() % maxDelay;
+		double *trans = boundedProcess->getTransition(delay);
+		double *refTrans = process->getTransition(delay);
+		for (long k = 0; k < (long) size*size; k++) { error = std::max(error,std::abs(trans[k] - refTrans[k])); }
+	}
+	std::cout << "KERNELS WITH " << boundedProcess->cachedBytes << " CACHED BYTES (INSTEAD OF " << process->cachedBytes << ")" << std::endl;
+
+	if (error > 1e-12) { std::cout << "ERROR: maximal difference = " << error << std::endl; }
+	else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	delete process;
+	delete boundedProcess;
+	delete VG;
+}
+
+
+/*
+ * Voter graph made of communities of equal size, with edges of a given weight within each
+ * community and of another weight between communities.
+ */
+static VoterGraph *getCommunitiesVoterGraph (int communityNumber, int communitySize, double intraRate, double interRate, double contrarian, int update = UPDATE_EDGES)
+{
+	VoterGraph *VG = new VoterGraph (update);
+	std::vector<VoterNode*> nodes;
+	for (int n = 0; n < communityNumber * communitySize; n++) { nodes.push_back(VG->addNode(1,contrarian)); }
+	for (int n1 = 0; n1 < communityNumber * communitySize; n1++)
+		for (int n2 = 0; n2 < communityNumber * communitySize; n2++)
+			if (n1 != n2) { VG->addEdge(nodes[n1],nodes[n2],(n1 / communitySize == n2 / communitySize) ? intraRate : interRate); }
+	return VG;
+}
+
+
+/*
+ * Voter graph made of disjoint rings of equal size, with edges of a given weight.
+ */
+static VoterGraph *getRingsVoterGraph (int ringNumber, int ringSize, double rate, double contrarian)
+{
+	VoterGraph *VG = new VoterGraph (UPDATE_EDGES);
+	std::vector<VoterNode*> nodes;
+	for (int n = 0; n < ringNumber * ringSize; n++) { nodes.push_back(VG->addNode(1,contrarian)); }
+	for (int r = 0; r < ringNumber; r++)
+		for (int n = 0; n < ringSize; n++)
+		{
+			VoterNode *n1 = nodes[r*ringSize + n];
+			VoterNode *n2 = nodes[r*ringSize + (n+1) % ringSize];
+			VG->addEdge(n1,n2,rate);
+			VG->addEdge(n2,n1,rate);
+		}
+	return VG;
+}
+
+
+/*
+ * Check that the symmetry-reduced processes of several voter graphs are exact lumpings of their
+ * microscopic processes, then build the reduced processes of voter graphs of about 100 nodes.
+ */
+void benchmarkSymmetricVoterProcess ()
+{
+	int time = 20;
+
+	std::vector<VoterGraph*> graphs;
+	std::vector<std::string> names;
+	graphs.push_back(new CompleteVoterGraph (8,UPDATE_EDGES,0.1)); names.push_back("COMPLETE GRAPH OF 8 NODES");
+	graphs.push_back(new TwoCommunitiesVoterGraph (5,3,1,2,0.5,0.7,0.1,0.05,UPDATE_NODES)); names.push_back("TWO COMMUNITIES OF 5 AND 3 NODES");
+	graphs.push_back(getCommunitiesVoterGraph(3,3,1,0.2,0.1)); names.push_back("THREE COMMUNITIES OF 3 NODES");
+	graphs.push_back(new ChainVoterGraph (10,0.1,true)); names.push_back("RING OF 10 NODES");
+	graphs.push_back(new ChainVoterGraph (9,0.1,false,UPDATE_NODES)); names.push_back("CHAIN OF 9 NODES");
+	graphs.push_back(getRingsVoterGraph(2,5,1,0.1)); names.push_back("TWO RINGS OF 5 NODES");
+
+	double error = 0;
+	for (unsigned int g = 0; g < graphs.size(); g++)
+	{
+		MarkovProcess *process = graphs[g]->getMarkovProcess();
+		MarkovProcess *symmetricProcess = graphs[g]->getSymmetricMarkovProcess();
+		Partition *partition = graphs[g]->getSymmetricPartition();
+		std::cout << names[g] << ": " << process->size << " -> " << symmetricProcess->size << " STATES" << std::endl;
+
+		for (int t = 0; t <= time; t += time/4)
+			for (std::list<Part*>::iterator it = partition->parts->begin(); it != partition->parts->end(); ++it)
+				error = std::max(error,std::abs(process->getProbability(*it,t) - symmetricProcess->getProbability((*it)->id,t)));
+
+		delete partition;
+		delete process;
+		delete symmetricProcess;
+		delete graphs[g];
+	}
+
+	// Four rings of 5 nodes have 240000 automorphisms: their orbits are the multisets of 4 among the 8 orbits of a ring
+	VoterGraph *rings = getRingsVoterGraph(4,5,1,0.1);
+	double start = getWallTime();
+	MarkovProcess *ringsProcess = rings->getSymmetricMarkovProcess();
+	std::cout << "FOUR RINGS OF 5 NODES: " << ringsProcess->size << " STATES in " << (getWallTime() - start) << " sec" << std::endl;
+	if (ringsProcess->size != 330) { std::cout << "ERROR: " << ringsProcess->size << " STATES INSTEAD OF 330" << std::endl; error = 1; }
+	delete ringsProcess;
+	delete rings;
+
+	if (error > 1e-10) { std::cout << "ERROR: maximal difference = " << error << std::endl; }
+	else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	graphs.clear();
+	names.clear();
+	graphs.push_back(new CompleteVoterGraph (100,UPDATE_EDGES,0.01)); names.push_back("COMPLETE GRAPH OF 100 NODES");
+	graphs.push_back(getCommunitiesVoterGraph(3,33,1,0.1,0.01)); names.push_back("THREE COMMUNITIES OF 33 NODES");
+
+	for (unsigned int g = 0; g < graphs.size(); g++)
+	{
+		start = getWallTime();
+		MarkovProcess *process = graphs[g]->getSymmetricMarkovProcess();
+		std::cout << names[g] << ": " << process->size << " STATES, " << process->sparseTransition->getEntryNumber() << " TRANSITIONS in " << (getWallTime() - start) << " sec" << std::endl;
+
+		start = getWallTime();
+		int iterations = process->computeStationaryDistribution(1e-12,GAUSS_SEIDEL,100000);
+		std::cout << "STATIONARY DISTRIBUTION AFTER " << iterations << " ITERATIONS in " << (getWallTime() - start) << " sec" << std::endl;
+
+		delete process;
+		delete graphs[g];
+	}
+}
@@ -41,5 +41,16 @@ void testLogarithmicScore ();
 void getBinningComputationTime ();
 void optimalBinningOfVoterModel ();
 void minimalExample ();
+void testInformationBottleneck ();
+void benchmarkMarkovKernels ();
+void benchmarkSparseVoterProcess ();
+void benchmarkStationaryDistribution ();
+void benchmarkTrajectorySampler ();
+void benchmarkLumpedInformation ();
+void benchmarkOrderedPartition ();
+void benchmarkMarkovScore ();
+void benchmarkMarkovDataSetFile ();
+void benchmarkMarkovCache ();
+void benchmarkSymmetricVoterProcess ();
 
 #endif
@@ -38,12 +38,17 @@
 #include <iostream>
 #include <cmath>
 #include <fstream>
+#include <limits>
+#include <algorithm>
+#include <vector>
 
 #include "programs.hpp"
 #include "timer.hpp"
+#include "parallel_tools.hpp"
 
 #include "graph.hpp"
 #include "check_graph_datatree.hpp"
+#include "graph_loader.hpp"
 #include "csv_tools.hpp"
 #include "dataset.hpp"
 
@@ -57,6 +62,8 @@
 
 #include "relative_entropy.hpp"
 #include "information_criterion.hpp"
+#include "aggregated_statistics.hpp"
+#include "bidimensional_relative_entropy.hpp"
 #include "logarithmic_score.hpp"
 #include "prediction_dataset.hpp"
 
@@ -180,6 +187,74 @@ void testNonconstrainedSet ()
 }
 
 
+void testSpilledDatatree ()
+{
+    int size = 10;
+    double values [10];
+    double refValues [10];
+
+    for (int i = 0; i < size; i++)
+    {
+		values[i] = rand() % 1000;
+		refValues[i] = values[i] + rand() % 1000;
+    }
+
+    RelativeEntropy *m = new RelativeEntropy(size,values,refValues);
+
+    // Each set is optimized with its bipartition table in memory and spilled
+    AbstractSet *memorySets [2];
+    AbstractSet *spilledSets [2];
+
+    NonconstrainedSet *memorySet = new NonconstrainedSet(size);
+    NonconstrainedSet *spilledSet = new NonconstrainedSet(size);
+    spilledSet->setSpillDirectory("/tmp");
+    memorySets[0] = memorySet;
+    spilledSets[0] = spilledSet;
+
+    Graph *memoryGraph = new RandomGraph(size,2*size);
+    Graph *spilledGraph = new Graph(size);
+    for (int v = 0; v < size; v++) { for (int u = v+1; u < size; u++) { if (memoryGraph->adjacencySets[v].contains(u)) { spilledGraph->addEdge(v,u); } } }
+    spilledGraph->setSpillDirectory("/tmp");
+    memorySets[1] = memoryGraph;
+    spilledSets[1] = spilledGraph;
+
+    bool error = false;
+    for (int s = 0; s < 2; s++)
+    {
+		AbstractSet *sets [2] = {memorySets[s], spilledSets[s]};
+		for (int i = 0; i < 2; i++)
+		{
+			sets[i]->buildDataStructure();
+			sets[i]->setObjectiveFunction(m);
+			sets[i]->computeObjectiveValues();
+			sets[i]->normalizeObjectiveValues();
+		}
+
+		for (double parameter = 0; parameter <= 1; parameter += 0.01)
+		{
+			Partition *p1 = memorySets[s]->getOptimalPartition(parameter);
+			Partition *p2 = spilledSets[s]->getOptimalPartition(parameter);
+
+			if (p1->getFingerprint() != p2->getFingerprint())
+			{
+				std::cout << "ERROR: parameter = " << parameter << " -> ";
+				p1->print(); std::cout << " IN MEMORY AND "; p2->print(); std::cout << " SPILLED" << std::endl;
+				error = true;
+			}
+
+			delete p1;
+			delete p2;
+		}
+    }
+
+    if (error) { std::cout << "ERROR: there has been an error!" << std::endl; }
+    else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+    for (int s = 0; s < 2; s++) { delete memorySets[s]; delete spilledSets[s]; }
+    delete m;
+}
+
+
 void testNonconstrainedOrderedSet ()
 {
     int size1 = 4;
@@ -331,7 +406,21 @@ void testGraph ()
 		if (graphNb >= 0) { graph->printDataStructure(); }
 
 		bool errorParts = checkParts(graph);
-		error = error || errorParts;
+		bool errorSubsets = checkConnectedSubsets(graph);
+		bool errorPartitions = checkPartitions(graph);
+
+		// Optimal partition read from the datatree (without tracing the datatrees built by the check)
+		double values [size];
+		double refValues [size];
+		for (int i = 0; i < size; i++) { values[i] = rand() % 100; refValues[i] = values[i] + rand() % 100; }
+		RelativeEntropy *m = new RelativeEntropy(size,values,refValues);
+		bool verbose = VERBOSE;
+		VERBOSE = false;
+		bool errorOptimal = checkOptimalPartition(graph,m,0.5);
+		VERBOSE = verbose;
+		delete m;
+
+		error = error || errorParts || errorSubsets || errorPartitions || errorOptimal;
 
 		delete graph;
     }
@@ -341,6 +430,337 @@ void testGraph ()
 }
 
 
+void benchmarkGraphVerifier ()
+{
+    bool error = false;
+
+    std::cout << "VERTICES\tEDGES\tSUBSETS (sec)\tPARTITIONS (sec)\tOPTIMAL PARTITION (sec)" << std::endl;
+    for (int size = 8; size <= 14; size += 2)
+    {
+		int edgeNb = 2*size;
+		double values [size];
+		double refValues [size];
+		for (int i = 0; i < size; i++)
+		{
+			values[i] = rand() % 100;
+			refValues[i] = values[i] + rand() % 100;
+		}
+		RelativeEntropy *m = new RelativeEntropy(size,values,refValues);
+
+		Graph *graph = new RandomGraph (size,edgeNb);
+		graph->buildDataStructure();
+
+		double start = getWallTime();
+		error = checkConnectedSubsets(graph) || error;
+		float subsetTime = (getWallTime() - start);
+
+		start = getWallTime();
+		error = checkPartitions(graph) || error;
+		float partitionTime = (getWallTime() - start);
+
+		start = getWallTime();
+		error = checkOptimalPartition(graph,m,0.5) || error;
+		float optimalTime = (getWallTime() - start);
+
+		std::cout << size << "\t" << edgeNb << "\t" << subsetTime << "\t" << partitionTime << "\t" << optimalTime << std::endl;
+
+		delete graph;
+		delete m;
+    }
+
+    if (error) { std::cout << "ERROR: there has been an error!" << std::endl; }
+    else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+}
+
+
+/*
+ * Sorted fingerprints of a set of parts, so that two sets can be compared regardless of the order of their parts.
+ */
+static std::vector<unsigned long long> getSortedFingerprints (PartSet *parts)
+{
+	std::vector<unsigned long long> fingerprints;
+	for (PartSet::iterator it = parts->begin(); it != parts->end(); ++it) { fingerprints.push_back((*it)->getFingerprint()); }
+	std::sort(fingerprints.begin(),fingerprints.end());
+	return fingerprints;
+}
+
+
+void benchmarkGraphBuilders ()
+{
+    int size = 16;
+    int graphNb = 5;
+    int maxEdgeNb = size*(size-1)/2;
+    setThreadNumber(1);
+
+    std::cout << "EDGES\tPARTS\tROOT TREES (sec)\tSLYCE (sec)" << std::endl;
+    for (int edgeNb = size; edgeNb <= maxEdgeNb/2; edgeNb += size/2)
+    {
+		float mergeTime = 0;
+		float slyceTime = 0;
+		int partNb = 0;
+
+		for (int g = 0; g < graphNb; g++)
+		{
+			int seed = rand();
+
+			srand(seed);
+			Graph *graph = new RandomGraph (size,edgeNb);
+			double start = getWallTime();
+			graph->buildDataStructure();
+			mergeTime += (getWallTime() - start);
+
+			PartSet *parts = graph->getParts();
+			int mergeNb = parts->size();
+			std::vector<unsigned long long> mergeFingerprints = getSortedFingerprints(parts);
+			for (PartSet::iterator it = parts->begin(); it != parts->end(); ++it) { delete *it; }
+			delete parts;
+			delete graph;
+
+			srand(seed);
+			graph = new RandomGraph (size,edgeNb);
+			graph->slyceBuilder = true;
+			start = getWallTime();
+			graph->buildDataStructure();
+			slyceTime += (getWallTime() - start);
+
+			parts = graph->getParts();
+			if ((int) parts->size() != mergeNb) { std::cout << "ERROR: " << parts->size() << " PARTS WITH SLYCE INSTEAD OF " << mergeNb << std::endl; }
+			else if (getSortedFingerprints(parts) != mergeFingerprints) { std::cout << "ERROR: SLYCE AND ROOT TREES BUILD DIFFERENT PARTS" << std::endl; }
+			partNb += mergeNb;
+			for (PartSet::iterator it = parts->begin(); it != parts->end(); ++it) { delete *it; }
+			delete parts;
+			delete graph;
+		}
+
+		std::cout << edgeNb << "\t" << partNb / graphNb << "\t" << mergeTime / graphNb << "\t" << slyceTime / graphNb << std::endl;
+    }
+
+    setThreadNumber(0);
+}
+
+
+void benchmarkGraphLoaders ()
+{
+    int vertexNumber = 300000;
+    long edgeNumber = 1000000;
+    std::string path = "/tmp/";
+
+    // Random edge lists (with duplicates, loops and reversed edges), by index and by label
+    std::ofstream indexFile ((path + "edges.txt").c_str());
+    std::ofstream labelFile ((path + "edges.csv").c_str());
+    indexFile << "# source target" << std::endl;
+    for (long e = 0; e < edgeNumber; e++)
+    {
+		int v1 = rand() % vertexNumber;
+		int v2 = (v1 + 1 + rand() % 8) % vertexNumber;
+		if (rand() % 2 == 0) { int v = v1; v1 = v2; v2 = v; }
+		indexFile << v1 << " " << v2 << "\n";
+		labelFile << "R" << v1 << ";R" << v2 << "\n";
+    }
+    indexFile.close();
+    labelFile.close();
+
+    double start = getWallTime();
+    AdjacencyList *list = loadEdgeList(path + "edges.txt");
+    std::cout << "EDGE LIST (mmap): " << list->vertexNumber << " vertices, " << list->getEdgeNumber() << " edges in " << (getWallTime() - start) << " sec" << std::endl;
+
+    start = getWallTime();
+    AdjacencyList *bufferList = loadEdgeList(path + "edges.txt", 0, true, false);
+    std::cout << "EDGE LIST (read): " << bufferList->getEdgeNumber() << " edges in " << (getWallTime() - start) << " sec" << std::endl;
+
+    InternTable labels;
+    start = getWallTime();
+    AdjacencyList *labelList = loadEdgeList(path + "edges.csv", &labels);
+    std::cout << "LABELLED EDGE LIST: " << labels.size() << " labels, " << labelList->getEdgeNumber() << " edges in " << (getWallTime() - start) << " sec" << std::endl;
+
+    saveCSR(list, path + "edges.csr");
+    start = getWallTime();
+    AdjacencyList *csrList = loadCSR(path + "edges.csr");
+    std::cout << "CSR: " << csrList->getEdgeNumber() << " edges in " << (getWallTime() - start) << " sec" << std::endl;
+
+    bool error = (bufferList->offsets != list->offsets || bufferList->neighbours != list->neighbours
+				  || csrList->offsets != list->offsets || csrList->neighbours != list->neighbours
+				  || labelList->getEdgeNumber() != list->getEdgeNumber());
+
+    // Interned labels give the same adjacency, up to the renaming of vertices
+    for (int v = 0; v < labelList->vertexNumber && !error; v++)
+    {
+		int index = string2int(labels.getLabel(v).substr(1));
+		error = (labelList->offsets[v+1] - labelList->offsets[v] != list->offsets[index+1] - list->offsets[index]);
+    }
+
+    // Corrupt files are rejected: a neighbour out of range, decreasing offsets, and an index above INT_MAX
+    list->neighbours[0] = vertexNumber;
+    saveCSR(list, path + "corrupt.csr");
+    bool rejected = (loadCSR(path + "corrupt.csr") == 0);
+    list->neighbours[0] = csrList->neighbours[0];
+    std::swap(list->offsets[1], list->offsets[2]);
+    saveCSR(list, path + "corrupt.csr");
+    rejected = rejected && (loadCSR(path + "corrupt.csr") == 0);
+    std::swap(list->offsets[1], list->offsets[2]);
+
+    std::ofstream overflowFile ((path + "overflow.txt").c_str());
+    overflowFile << "0 1\n1 4294967298\n";
+    overflowFile.close();
+    AdjacencyList *overflowList = loadEdgeList(path + "overflow.txt");
+    rejected = rejected && overflowList->vertexNumber == 2 && overflowList->getEdgeNumber() == 1;
+
+    // Graphs are only built from small adjacency lists
+    rejected = rejected && list->buildGraph() == 0;
+    Graph *graph = overflowList->buildGraph();
+    rejected = rejected && graph != 0 && graph->areAdjacent(0,1);
+    delete graph;
+
+    if (error) { std::cout << "ERROR: loaders disagree!" << std::endl; }
+    else if (!rejected) { std::cout << "ERROR: corrupt files have been accepted!" << std::endl; }
+    else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+    delete list;
+    delete overflowList;
+    delete bufferList;
+    delete labelList;
+    delete csrList;
+}
+
+
+void testApproximateGraph ()
+{
+    int size = 9;
+    int edgeNb = 12;
+    int maxPartSize = 3;
+    int graphNb = 10;
+    bool error = false;
+
+    // On small graphs, the restricted problem is solved exactly: compare with all the partitions into connected parts of at most maxPartSize vertices
+    for (int g = 0; g < graphNb; g++)
+    {
+		double values [size];
+		double refValues [size];
+		for (int i = 0; i < size; i++)
+		{
+			values[i] = rand() % 100;
+			refValues[i] = values[i] + rand() % 100;
+		}
+		RelativeEntropy *m = new RelativeEntropy(size,values,refValues);
+
+		Graph *graph = new RandomGraph (size,edgeNb);
+		graph->setApproximation(maxPartSize);
+		graph->buildDataStructure();
+		graph->setObjectiveFunction(m);
+		graph->computeObjectiveValues();
+		graph->normalizeObjectiveValues();
+
+		ObjectiveValue *singletons [size];
+		for (int v = 0; v < size; v++) { singletons[v] = m->newObjectiveValue(v); singletons[v]->compute(); }
+
+		for (double parameter = 0; parameter <= 1; parameter += 0.1)
+		{
+			Partition *partition = graph->getOptimalPartition(parameter);
+			delete partition;
+
+			// Restricted growth strings: blocks[v] is the part of v, each part being numbered by order of first appearance
+			int blocks [size];
+			int maxBlocks [size];
+			for (int v = 0; v < size; v++) { blocks[v] = 0; maxBlocks[v] = 0; }
+			double best = m->maximize ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+
+			while (true)
+			{
+				int blockNb = maxBlocks[size-1] + 1;
+				bool feasible = true;
+				double score = 0;
+				for (int b = 0; b < blockNb && feasible; b++)
+				{
+					VertexSet part (size);
+					ObjectiveValue *value = 0;
+					for (int v = 0; v < size; v++)
+					{
+						if (blocks[v] != b) { continue; }
+						part.insert(v);
+						if (value == 0) { value = m->newObjectiveValue(v); value->compute(); continue; }
+						ObjectiveValue *newValue = m->newObjectiveValue();
+						newValue->compute(singletons[v],value);
+						delete value;
+						value = newValue;
+					}
+					feasible = part.count() <= maxPartSize && graph->isConnected(&part);
+					if (feasible) { score += value->getValue(parameter); }
+					delete value;
+				}
+				if (feasible && (m->maximize ? score > best : score < best)) { best = score; }
+
+				int v = size-1;
+				while (v > 0 && blocks[v] > maxBlocks[v-1]) { v--; }
+				if (v == 0) { break; }
+				blocks[v]++;
+				maxBlocks[v] = std::max(maxBlocks[v-1],blocks[v]);
+				for (int w = v+1; w < size; w++) { blocks[w] = 0; maxBlocks[w] = maxBlocks[v]; }
+			}
+
+			if (fabs(best - graph->approximateValue) > 1e-9 || graph->getApproximationGap() != 0)
+			{
+				std::cout << "ERROR: parameter = " << parameter << " -> " << graph->approximateValue << " INSTEAD OF " << best << std::endl;
+				error = true;
+			}
+		}
+
+		for (int v = 0; v < size; v++) { delete singletons[v]; }
+		delete graph;
+		delete m;
+    }
+
+    if (error) { std::cout << "ERROR: approximate aggregation differs from brute force!" << std::endl; }
+    else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+    // On large graphs, parts are packed greedily: report time and gap to the bound
+    int width = 25;
+    int height = 20;
+    size = width * height;
+    double values [size];
+    double refValues [size];
+    for (int i = 0; i < size; i++)
+    {
+		values[i] = rand() % 100;
+		refValues[i] = values[i] + rand() % 100;
+    }
+    RelativeEntropy *m = new RelativeEntropy(size,values,refValues);
+
+    Graph *grid = new Graph (size);
+    for (int x = 0; x < width; x++)
+		for (int y = 0; y < height; y++)
+		{
+			if (x+1 < width) { grid->addEdge(x*height+y,(x+1)*height+y); }
+			if (y+1 < height) { grid->addEdge(x*height+y,x*height+y+1); }
+		}
+
+    for (maxPartSize = 2; maxPartSize <= 9; maxPartSize++)
+    {
+		// The last run also bounds the radius of parts (crosses and smaller parts)
+		int maxPartRadius = (maxPartSize == 9) ? 1 : -1;
+		Graph *graph = new Graph (size);
+		for (int v = 0; v < size; v++) { graph->adjacencySets[v] = grid->adjacencySets[v]; }
+		graph->setApproximation(maxPartSize,maxPartRadius);
+
+		double start = getWallTime();
+		graph->buildDataStructure();
+		graph->setObjectiveFunction(m);
+		graph->computeObjectiveValues();
+		graph->normalizeObjectiveValues();
+		Partition *partition = graph->getOptimalPartition(0.5);
+		float time = (getWallTime() - start);
+
+		std::cout << "GRID " << width << "x" << height << ", PARTS OF AT MOST " << maxPartSize << " VERTICES" << (maxPartRadius >= 0 ? " AND RADIUS 1: " : ": ") << partition->size << " PARTS, VALUE = "
+				  << graph->approximateValue << ", BOUND = " << graph->approximationBound << ", GAP = " << graph->getApproximationGap() << " in " << time << " sec" << std::endl;
+
+		delete partition;
+		delete graph;
+    }
+
+    delete grid;
+    delete m;
+}
+
+
 void testBiSet ()
 {
 	UniSubset *h00 = new UniSubset (0);
@@ -667,6 +1087,98 @@ delete set;
 
 
 
+void testGraphBasedUniSet ()
+{
+	int size = 6;
+	int timeSize = 3;
+	int elementNb = size * timeSize;
+	bool error = false;
+
+	// A ring has n(n-1)+1 connected subsets
+	Graph *ring = new RingGraph (size);
+	GraphBasedUniSet *ringSet = new GraphBasedUniSet (ring);
+	ringSet->buildDataStructure();
+	if (ringSet->uniSubsetNumber != size*(size-1)+1)
+	{
+		std::cout << "ERROR: " << ringSet->uniSubsetNumber << " SUBSETS INSTEAD OF " << size*(size-1)+1 << std::endl;
+		error = true;
+	}
+
+	// On a complete graph, space x time aggregation is the same as with an unconstrained set
+	double values [elementNb];
+	double refValues [elementNb];
+	for (int i = 0; i < elementNb; i++)
+	{
+		values[i] = rand() % 100;
+		refValues[i] = values[i] + rand() % 100;
+	}
+	RelativeEntropy *m = new RelativeEntropy(elementNb,values,refValues);
+
+	Graph *complete = new CompleteGraph (size);
+	UniSet **graphArray = new UniSet* [2];
+	graphArray[0] = new GraphBasedUniSet (complete);
+	graphArray[1] = new OrderedUniSet (timeSize);
+	UniSet **unconstrainedArray = new UniSet* [2];
+	unconstrainedArray[0] = new UnconstrainedUniSet (size);
+	unconstrainedArray[1] = new OrderedUniSet (timeSize);
+
+	for (int d = 0; d < 2; d++) { graphArray[d]->buildDataStructure(); unconstrainedArray[d]->buildDataStructure(); }
+
+	MultiSet *graphSet = new MultiSet (graphArray, 2);
+	MultiSet *unconstrainedSet = new MultiSet (unconstrainedArray, 2);
+
+	MultiSet *sets [2] = {graphSet, unconstrainedSet};
+	for (int s = 0; s < 2; s++)
+	{
+		sets[s]->buildDataStructure();
+		sets[s]->setObjectiveFunction(m);
+		sets[s]->computeObjectiveValues();
+		sets[s]->normalizeObjectiveValues();
+	}
+
+	for (double parameter = 0; parameter <= 1; parameter += 0.05)
+	{
+		Partition *p1 = graphSet->getOptimalPartition(parameter);
+		Partition *p2 = unconstrainedSet->getOptimalPartition(parameter);
+		if (p1->getFingerprint() != p2->getFingerprint())
+		{
+			std::cout << "ERROR: parameter = " << parameter << " -> ";
+			p1->print(); std::cout << " ON THE COMPLETE GRAPH AND "; p2->print(); std::cout << " UNCONSTRAINED" << std::endl;
+			error = true;
+		}
+		delete p1;
+		delete p2;
+	}
+
+	// Space x time aggregation constrained by the ring
+	UniSet **ringArray = new UniSet* [2];
+	ringArray[0] = ringSet;
+	ringArray[1] = new OrderedUniSet (timeSize);
+	ringArray[1]->buildDataStructure();
+
+	MultiSet *ringMultiSet = new MultiSet (ringArray, 2);
+	ringMultiSet->buildDataStructure();
+	ringMultiSet->setObjectiveFunction(m);
+	ringMultiSet->computeObjectiveValues();
+	ringMultiSet->normalizeObjectiveValues();
+	ringMultiSet->printOptimalPartitionList(0.01);
+
+	if (error) { std::cout << "ERROR: there has been an error!" << std::endl; }
+	else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	delete ringMultiSet;
+	delete graphSet;
+	delete unconstrainedSet;
+	for (int d = 0; d < 2; d++) { delete ringArray[d]; delete graphArray[d]; delete unconstrainedArray[d]; }
+	delete [] ringArray;
+	delete [] graphArray;
+	delete [] unconstrainedArray;
+	delete m;
+	delete ring;
+	delete complete;
+}
+
+
 void testGraphCompression ()
 {
 	int size = 8;
@@ -799,3 +1311,133 @@ void testGraphCompression ()
     timer.stopMemory();
     timer.stop();
 }
+
+
+
+void testAggregatedStatistics ()
+{
+	UniSet *hSet = new BinaryTreeUniSet (2);
+	hSet->buildDataStructure();
+
+	UniSet *oSet = new OrderedUniSet (4);
+	oSet->buildDataStructure();
+
+	int dimension = 2;
+	UniSet **uniSetArray = new UniSet* [dimension];
+	uniSetArray[0] = hSet;
+	uniSetArray[1] = oSet;
+		
+	MultiSet *multiSet = new MultiSet (uniSetArray, dimension);
+	multiSet->buildDataStructure();
+
+	double values [16]		= {	54,	30,	4, 5,
+								54,	58,	64, 22,
+								50, 18, 2, 12,
+								45, 10, 3, 5 };
+
+	// Statistics are aggregated only once...
+	AggregatedStatistics *m = new AggregatedStatistics (16,values);
+	
+    multiSet->setObjectiveFunction(m);
+    multiSet->computeObjectiveValues();
+    multiSet->normalizeObjectiveValues();
+
+	// ... and then several objectives are evaluated on them
+	std::cout << "SIZE REDUCTION" << std::endl;
+	m->setMode(AggregatedStatistics::SIZE_REDUCTION);
+    multiSet->printOptimalPartitionList(0.001);
+
+	std::cout << "ENTROPY REDUCTION" << std::endl;
+	m->setMode(AggregatedStatistics::ENTROPY_REDUCTION);
+    multiSet->printOptimalPartitionList(0.001);
+
+	std::cout << "INFORMATION CRITERION" << std::endl;
+	m->setMode(AggregatedStatistics::INFORMATION_CRITERION,false);
+    multiSet->printOptimalPartitionList(0.001);
+
+	// Each mode gives the same optimal partitions as the corresponding standalone objective
+	AggregatedStatistics::Mode modes [3] = {AggregatedStatistics::SIZE_REDUCTION, AggregatedStatistics::ENTROPY_REDUCTION, AggregatedStatistics::INFORMATION_CRITERION};
+	ObjectiveFunction *objectives [3] = {new RelativeEntropy (16,values,0,false), new RelativeEntropy (16,values,0,true), new InformationCriterion (16,values)};
+
+	MultiSet *referenceSet = new MultiSet (uniSetArray, dimension);
+	referenceSet->buildDataStructure();
+
+	bool error = false;
+	for (int i = 0; i < 3; i++)
+	{
+		bool normalized = (modes[i] != AggregatedStatistics::INFORMATION_CRITERION);
+		m->setMode(modes[i],normalized);
+		referenceSet->setObjectiveFunction(objectives[i]);
+		referenceSet->computeObjectiveValues();
+		if (normalized) { referenceSet->normalizeObjectiveValues(); }
+
+		for (double unit = 0; unit < 1; unit += 0.05)
+		{
+			double parameter = m->getParameter(unit);
+			Partition *p1 = multiSet->getOptimalPartition(parameter);
+			Partition *p2 = referenceSet->getOptimalPartition(parameter);
+			if (p1->getFingerprint() != p2->getFingerprint())
+			{
+				std::cout << "ERROR: mode " << modes[i] << ", parameter = " << parameter << " -> ";
+				p1->print(); std::cout << " FROM THE STATISTICS AND "; p2->print(); std::cout << " FROM THE STANDALONE OBJECTIVE" << std::endl;
+				error = true;
+			}
+			delete p1;
+			delete p2;
+		}
+	}
+
+	if (error) { std::cout << "ERROR: there has been an error!" << std::endl; }
+	else { std::cout << "-> CHECK SUCCESSFUL!" << std::endl; }
+
+	for (int i = 0; i < 3; i++) { delete objectives[i]; }
+	delete referenceSet;
+	delete multiSet;
+	delete m;
+}
+
+
+
+void testBidimensionalRelativeEntropy ()
+{
+	int size1 = 4;
+	int size2 = 4;
+
+	UniSet *oSet1 = new OrderedUniSet (size1);
+	oSet1->buildDataStructure();
+
+	UniSet *oSet2 = new OrderedUniSet (size2);
+	oSet2->buildDataStructure();
+
+	BiSet *biSet = new BiSet (oSet1,oSet2);
+	biSet->buildDataStructure();
+
+	double values [16]		= {	54,	30,	4, 5,
+								54,	58,	64, 22,
+								50, 18, 2, 12,
+								45, 10, 3, 5 };
+
+	// Reference values are the product of the marginals of the data (independence model)
+	BidimensionalRelativeEntropy *m = new BidimensionalRelativeEntropy (size1,size2,values);
+
+    biSet->setObjectiveFunction(m);
+    biSet->computeObjectiveValues();
+    biSet->normalizeObjectiveValues();
+    biSet->printOptimalPartitionList(0.001);
+
+	std::vector<UniSet*> *setVector = new std::vector<UniSet*>();
+	setVector->push_back(oSet1);
+	setVector->push_back(oSet2);
+
+	MultiSet *multiSet = new MultiSet (setVector);
+	multiSet->buildDataStructure();
+
+    multiSet->setObjectiveFunction(m);
+    multiSet->computeObjectiveValues();
+    multiSet->normalizeObjectiveValues();
+    multiSet->printOptimalPartitionList(0.001);
+
+	delete multiSet;
+	delete biSet;
+	delete m;
+}
@@ -41,13 +41,21 @@
 void testHierarchicalSet ();
 void testOrderedSet ();
 void testNonconstrainedSet ();
+void testSpilledDatatree ();
 void testHierarchicalOrderedSet ();
 void testNonconstrainedOrderedSet ();
 void testHierarchicalHierarchicalSet ();
 void testGraph ();
+void benchmarkGraphVerifier ();
+void benchmarkGraphBuilders ();
+void benchmarkGraphLoaders ();
+void testApproximateGraph ();
 void testBiSet ();
 void testMultiSet ();
+void testGraphBasedUniSet ();
 void testGraphCompression ();
+void testAggregatedStatistics ();
+void testBidimensionalRelativeEntropy ();
 
 void ebolaAggregation();
 //void aggregateGeomediaticCube ();
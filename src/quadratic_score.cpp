@@ -121,6 +121,9 @@ void QuadraticScore::computeObjectiveValues ()
 }
 
 
+void QuadraticScore::normalizeObjectiveValues (ObjectiveValue *q) {}
+
+
 void QuadraticScore::printObjectiveValues (bool v)
 {
 	if (v)
@@ -250,9 +253,6 @@ void QuadraticScoreValue::compute (ObjectiveValueSet *valueSet)
 }
 
 
-void QuadraticScoreValue::normalize (ObjectiveValue *q) {}
-
-
 void QuadraticScoreValue::print (bool v)
 {
 	if (v)
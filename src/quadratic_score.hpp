@@ -74,6 +74,7 @@ public:
 	void setRandom ();
 	ObjectiveValue *newObjectiveValue (int index = -1);
 	void computeObjectiveValues();
+	void normalizeObjectiveValues (ObjectiveValue *q);
 	void printObjectiveValues (bool verbose = true);
 
 	double getParameter (double unit);
@@ -110,7 +111,6 @@ public:
 	void compute ();
 	void compute (ObjectiveValue *value1, ObjectiveValue *value2);
 	void compute (ObjectiveValueSet *valueset);
-	void normalize (ObjectiveValue *q);
 	void print (bool verbosex = true);
 	double getValue (double param);
 };
@@ -0,0 +1,125 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <atomic>
+#include <ctime>
+
+#include "random_tools.hpp"
+
+
+static unsigned long long mix (unsigned long long x)
+{
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+
+static const unsigned long long GOLDEN_GAMMA = 0x9e3779b97f4a7c15ULL;
+
+
+CounterRandomGenerator::CounterRandomGenerator (unsigned long long seed, unsigned long long stream)
+{
+	key = mix(mix(seed) + (stream + 1) * GOLDEN_GAMMA);
+	counter = 0;
+}
+
+
+unsigned long long CounterRandomGenerator::next () { return mix(key + (++counter) * GOLDEN_GAMMA); }
+
+
+
+static std::atomic<unsigned long long> RANDOM_SEED (time(NULL));
+static std::atomic<unsigned long long> RANDOM_STREAM_NUMBER (0);
+
+
+void setRandomSeed (unsigned long long seed) { RANDOM_SEED = seed; }
+
+
+RandomGenerator *getThreadRandomGenerator ()
+{
+	thread_local CounterRandomGenerator generator (RANDOM_SEED, RANDOM_STREAM_NUMBER++);
+	return &generator;
+}
+
+
+
+AliasTable::AliasTable () { offsets.push_back(0); }
+
+
+void AliasTable::addDistribution (const std::vector< std::pair<int,double> > &entries)
+{
+	long first = outcomes.size();
+	double sum = 0;
+	for (unsigned int e = 0; e < entries.size(); e++)
+	{
+		if (entries[e].second <= 0) { continue; }
+		outcomes.push_back(entries[e].first);
+		thresholds.push_back(entries[e].second);
+		aliases.push_back(0);
+		sum += entries[e].second;
+	}
+	int n = outcomes.size() - first;
+
+	// Scaled probabilities are split between entries below 1 (small) and above 1 (large): each small entry takes a large one as alias
+	std::vector<int> small;
+	std::vector<int> large;
+	for (int k = 0; k < n; k++)
+	{
+		thresholds[first+k] *= n / sum;
+		aliases[first+k] = k;
+		if (thresholds[first+k] < 1) { small.push_back(k); } else { large.push_back(k); }
+	}
+
+	while (!small.empty() && !large.empty())
+	{
+		int s = small.back();
+		int l = large.back();
+		small.pop_back();
+		aliases[first+s] = l;
+		thresholds[first+l] -= 1 - thresholds[first+s];
+		if (thresholds[first+l] < 1) { large.pop_back(); small.push_back(l); }
+	}
+
+	// Remaining entries are (up to rounding errors) exactly 1
+	for (unsigned int k = 0; k < small.size(); k++) { thresholds[first+small[k]] = 1; }
+	for (unsigned int k = 0; k < large.size(); k++) { thresholds[first+large[k]] = 1; }
+
+	offsets.push_back(outcomes.size());
+}
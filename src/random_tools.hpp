@@ -0,0 +1,140 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_RANDOM_TOOLS
+#define INCLUDE_RANDOM_TOOLS
+
+/*!
+ * \file random_tools.hpp
+ * \brief Reentrant random number generators (one stream per thread or per task, so that parallel simulations are reproducible) and alias tables to sample discrete distributions in constant time
+ * \author Robin Lamarche-Perrin
+ * \date 06/11/2015
+ */
+
+#include <vector>
+#include <utility>
+
+
+/*!
+ * \class RandomGenerator
+ * \brief Abstract source of 64-bit random words
+ */
+class RandomGenerator
+{
+public:
+	virtual ~RandomGenerator () {}
+
+	/*!
+	 * \brief Return the next random word
+	 */
+	virtual unsigned long long next () = 0;
+
+	/*!
+	 * \brief Return a uniform random number in [0,1)
+	 */
+	double uniform () { return (next() >> 11) * (1. / 9007199254740992.); }
+};
+
+
+/*!
+ * \class CounterRandomGenerator
+ * \brief Counter-based generator: the n-th word of a stream is a bijective mix (SplitMix64) of its key and of n, so that streams are independent of each other and of the threads using them
+ */
+class CounterRandomGenerator : public RandomGenerator
+{
+public:
+	unsigned long long key; /** \brief Key of the stream, derived from the seed and the stream number */
+	unsigned long long counter; /** \brief Number of words drawn so far */
+
+	/*!
+	 * \brief Constructor
+	 * \param seed : The seed shared by all the streams of a simulation
+	 * \param stream : The number of the stream (e.g. the index of a trajectory)
+	 */
+	CounterRandomGenerator (unsigned long long seed = 0, unsigned long long stream = 0);
+
+	unsigned long long next ();
+};
+
+
+/*!
+ * \brief Set the seed of the generators returned by getThreadRandomGenerator, which is otherwise the time at which the program started (the generators of threads that have already drawn words are not reset)
+ */
+void setRandomSeed (unsigned long long seed);
+
+/*!
+ * \brief Return the generator of the calling thread (the stream of the first thread that calls it is numbered 0, the next one 1, etc.)
+ */
+RandomGenerator *getThreadRandomGenerator ();
+
+
+/*!
+ * \class AliasTable
+ * \brief Alias tables (Vose's method) of a list of discrete distributions stored contiguously, each one being sampled with one random number in constant time
+ */
+class AliasTable
+{
+public:
+	std::vector<long> offsets; /** \brief The entries of the i-th distribution are stored from offsets[i] to offsets[i+1]-1 */
+	std::vector<int> outcomes; /** \brief Outcome of each entry */
+	std::vector<double> thresholds; /** \brief Probability to keep the outcome of an entry rather than its alias, once it has been drawn uniformly */
+	std::vector<int> aliases; /** \brief Alias of each entry (as an index within its distribution) */
+
+	AliasTable ();
+
+	/*!
+	 * \brief Add the next distribution
+	 * \param entries : The pairs (outcome, probability) of the distribution (null probabilities are discarded, and probabilities are normalised)
+	 */
+	void addDistribution (const std::vector< std::pair<int,double> > &entries);
+
+	int getDistributionNumber () const { return offsets.size() - 1; }
+
+	/*!
+	 * \brief Draw an outcome of the i-th distribution
+	 */
+	int sample (int i, RandomGenerator *random) const
+	{
+		long first = offsets[i];
+		double u = random->uniform() * (offsets[i+1] - first);
+		long e = first + (long) u;
+		return (u - (long) u < thresholds[e]) ? outcomes[e] : outcomes[first + aliases[e]];
+	}
+};
+
+
+#endif
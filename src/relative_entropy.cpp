@@ -51,6 +51,8 @@ RelativeEntropy::RelativeEntropy (int s, double *val, double *refVal, bool e)
 	maximize = true;
 	values = new double [size];
 	refValues = new double [size];
+	gainFactor = 1;
+	lossFactor = 1;
 
 	if (val != 0) { for (int i = 0; i < size; i++) { values[i] = val[i]; } }
 	if (refVal != 0 && val != 0) { for (int i = 0; i < size; i++) { refValues[i] = refVal[i]; } }
@@ -84,7 +86,23 @@ ObjectiveValue *RelativeEntropy::newObjectiveValue (int id)
 }
 
 
-void RelativeEntropy::computeObjectiveValues () {};
+void RelativeEntropy::computeObjectiveValues ()
+{
+	gainFactor = 1;
+	lossFactor = 1;
+}
+
+void RelativeEntropy::normalizeObjectiveValues (ObjectiveValue *q)
+{
+	RelativeObjectiveValue *rq = (RelativeObjectiveValue *) q;
+	double gain = rq->sizeReduction;
+	if (entropy) { gain = rq->entropyReduction; }
+
+	gainFactor = 1;
+	lossFactor = 1;
+	if (gain > 0) { gainFactor = gain; }
+	if (rq->divergence > 0) { lossFactor = rq->divergence; }
+}
 
 void RelativeEntropy::printObjectiveValues (bool v) {};
 
@@ -101,6 +119,7 @@ RelativeObjectiveValue::RelativeObjectiveValue (RelativeEntropy *m, int id)
 	objective = m;
 	index = id;
 	
+	size = 0;
 	sumValue = 0;
 	sumRefValue = 0;
 	microEntropy = 0;
@@ -126,6 +145,7 @@ void RelativeObjectiveValue::add (ObjectiveValue *q)
 {
 	RelativeObjectiveValue *value = (RelativeObjectiveValue *) q;
 	
+	size += value->size;
 	sumValue += value->sumValue;
 	sumRefValue += value->sumRefValue;
 	microEntropy += value->microEntropy;
@@ -138,6 +158,7 @@ void RelativeObjectiveValue::add (ObjectiveValue *q)
 
 void RelativeObjectiveValue::compute ()
 {
+	size = 1;
 	sumValue = ((RelativeEntropy*)objective)->values[index];
 	sumRefValue = ((RelativeEntropy*)objective)->refValues[index];
 
@@ -161,6 +182,7 @@ void RelativeObjectiveValue::compute (ObjectiveValue *q1, ObjectiveValue *q2)
 	RelativeObjectiveValue *rq1 = (RelativeObjectiveValue *) q1;
 	RelativeObjectiveValue *rq2 = (RelativeObjectiveValue *) q2;
 
+	size = rq1->size + rq2->size;
 	sumValue = rq1->sumValue + rq2->sumValue;
 	sumRefValue = rq1->sumRefValue + rq2->sumRefValue;
 	microEntropy = rq1->microEntropy + rq2->microEntropy;
@@ -181,6 +203,7 @@ void RelativeObjectiveValue::compute (ObjectiveValue *q1, ObjectiveValue *q2)
 
 void RelativeObjectiveValue::compute (ObjectiveValueSet *valueSet)
 {
+	size = 0;
 	sumValue = 0;
 	sumRefValue = 0;
 	microEntropy = 0;
@@ -191,6 +214,7 @@ void RelativeObjectiveValue::compute (ObjectiveValueSet *valueSet)
 	{
 		RelativeObjectiveValue *rq = (RelativeObjectiveValue *) (*it);
 
+		size += rq->size;
 		sumValue += rq->sumValue;
 		sumRefValue += rq->sumRefValue;
 		microEntropy += rq->microEntropy;
@@ -211,27 +235,14 @@ void RelativeObjectiveValue::compute (ObjectiveValueSet *valueSet)
 }
 
 
-void RelativeObjectiveValue::normalize (ObjectiveValue *q)
-{
-	RelativeObjectiveValue *rq = (RelativeObjectiveValue *) q;
-
-	if (rq->sizeReduction > 0) { sizeReduction = sizeReduction / rq->sizeReduction; }
-	if (rq->entropyReduction > 0) { entropyReduction = entropyReduction / rq->entropyReduction; }
-	if (rq->divergence > 0) { divergence /= rq->divergence; }
-}
-
-
 void RelativeObjectiveValue::print (bool v)
 {
 	if (v)
 	{
 		std::cout << "value = " << std::setw(5) << std::setprecision(3) << sumValue
-				  << "   refvalue = " << std::setw(5) << std::setprecision(3) << sumRefValue;
-
-		if (((RelativeEntropy*)objective)->entropy) { std::cout << "   gain = " << std::setw(5) << std::setprecision(3) << entropyReduction; }
-		else { std::cout << "   gain = " << std::setw(5) << std::setprecision(3) << sizeReduction; }
-
-		std::cout << "   loss = " << std::setw(5) << std::setprecision(3) << divergence << std::endl;
+				  << "   refvalue = " << std::setw(5) << std::setprecision(3) << sumRefValue
+				  << "   gain = " << std::setw(5) << std::setprecision(3) << getGain()
+				  << "   loss = " << std::setw(5) << std::setprecision(3) << getLoss() << std::endl;
 	}
 	else {
 		std::cout << "value = " << std::setw(5) << std::setprecision(3) << sumValue
@@ -240,9 +251,21 @@ void RelativeObjectiveValue::print (bool v)
 }
 
 
-double RelativeObjectiveValue::getValue (double param)
+double RelativeObjectiveValue::getValue (double param) { return param * getGain() - (1-param) * getLoss(); }
+
+
+double RelativeObjectiveValue::getGain (bool normalized)
 {
-	if (((RelativeEntropy*)objective)->entropy) { return param * entropyReduction - (1-param) * divergence; }
-	else { return param * sizeReduction - (1-param) * divergence; }
+	RelativeEntropy *m = (RelativeEntropy*) objective;
+	double gain = sizeReduction;
+	if (m->entropy) { gain = entropyReduction; }
+	if (normalized) { gain /= m->gainFactor; }
+	return gain;
 }
 
+
+double RelativeObjectiveValue::getLoss (bool normalized)
+{
+	if (normalized) { return divergence / ((RelativeEntropy*)objective)->lossFactor; }
+	return divergence;
+}
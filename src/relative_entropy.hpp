@@ -48,6 +48,8 @@ public:
 	bool entropy;
 	double *values;
 	double *refValues;
+	double gainFactor; /** \brief Gain of the whole set, by which gains are divided when normalised (see normalizeObjectiveValues) */
+	double lossFactor; /** \brief Loss of the whole set, by which losses are divided when normalised (see normalizeObjectiveValues) */
 		
 	RelativeEntropy (int size, double *values = 0, double *refValues = 0, bool entropy = false);
 	~RelativeEntropy ();
@@ -55,6 +57,7 @@ public:
 	void setRandom ();
 	ObjectiveValue *newObjectiveValue (int index = -1);
 	void computeObjectiveValues ();
+	void normalizeObjectiveValues (ObjectiveValue *q);
 	void printObjectiveValues (bool verbose = true);
 
 	double getParameter (double unit);
@@ -63,10 +66,15 @@ public:
 };
 
 
+/*!
+ * \class RelativeObjectiveValue
+ * \brief Sums of values and reference values of a part, with the resulting reductions and divergence; shared by RelativeEntropy, InformationCriterion and AggregatedStatistics, which only differ in the way they evaluate these statistics
+ */
 class RelativeObjectiveValue: public ObjectiveValue
 {
 public:
 	int index;
+	int size;
 	double sumValue;
 	double sumRefValue;
 	double microEntropy;
@@ -83,9 +91,10 @@ public:
 	void compute ();
 	void compute (ObjectiveValue *value1, ObjectiveValue *value2);
 	void compute (ObjectiveValueSet *valueset);
-	void normalize (ObjectiveValue *q);
 	void print (bool verbose = true);
 	double getValue (double param);
+	double getGain (bool normalized = true);
+	double getLoss (bool normalized = true);
 };
 
 
@@ -55,6 +55,8 @@ Ring::Ring (int s)
 	microInfos = new double [s2];
 	sizeReductions = new double [s2];
 	divergences = new double [s2];
+	sizeReductionFactor = 1;
+	divergenceFactor = 1;
 
 	optimalQualities = new double [s2];
 	optimalCuts = new int [s2-1];
@@ -104,6 +106,9 @@ void Ring::buildDataStructure () {}
 
 void Ring::computeObjectiveValues ()
 {
+	sizeReductionFactor = 1;
+	divergenceFactor = 1;
+
 	for (int i = 0; i < size; i++)
 	{
 		int newIndex = getIndex(i,i);
@@ -140,22 +145,8 @@ void Ring::computeObjectiveValues ()
 
 void Ring::normalizeObjectiveValues ()
 {
-	double maxSizeReduction = sizeReductions[getIndex(0,size-1)];
-	double maxDivergence = divergences[getIndex(0,size-1)];
-
-	for (int s = 1; s < size; s++)
-	{
-		for (int i = 0; i < size; i++)
-		{
-			if (s == size-1 && i > 0) break;
-			
-			int j = i+s;
-			int newIndex = getIndex(i,j);
-
-			sizeReductions[newIndex] /= maxSizeReduction;
-			divergences[newIndex] /= maxDivergence;
-		}
-	}
+	sizeReductionFactor = sizeReductions[getIndex(0,size-1)];
+	divergenceFactor = divergences[getIndex(0,size-1)];
 }
 
 
@@ -169,8 +160,8 @@ void Ring::printObjectiveValues ()
 			else { std::cout << "[" << i << "-" << (j%size) << "]" << std::endl;; }
 			std::cout << " -> values = " << sumValues[getIndex(i,j)] << std::endl;
 			std::cout << " -> infos  = " << microInfos[getIndex(i,j)] << std::endl;
-			std::cout << " -> gain   = " << sizeReductions[getIndex(i,j)] << std::endl;
-			std::cout << " -> loss   = " << divergences[getIndex(i,j)] << std::endl;
+			std::cout << " -> gain   = " << sizeReductions[getIndex(i,j)] / sizeReductionFactor << std::endl;
+			std::cout << " -> loss   = " << divergences[getIndex(i,j)] / divergenceFactor << std::endl;
 		}
 	}
 	
@@ -179,24 +170,26 @@ void Ring::printObjectiveValues ()
 	std::cout << "[" << i << "-" << (j%size) << "]";
 	std::cout << " -> values = " << sumValues[getIndex(i,j)] << std::endl;
 	std::cout << " -> infos  = " << microInfos[getIndex(i,j)] << std::endl;
-	std::cout << " -> gain   = " << sizeReductions[getIndex(i,j)] << std::endl;
-	std::cout << " -> loss   = " << divergences[getIndex(i,j)] << std::endl;
+	std::cout << " -> gain   = " << sizeReductions[getIndex(i,j)] / sizeReductionFactor << std::endl;
+	std::cout << " -> loss   = " << divergences[getIndex(i,j)] / divergenceFactor << std::endl;
 }
 
 
 void Ring::computeOptimalPartition (double parameter)
 {
-	
+	double gainWeight = parameter / sizeReductionFactor;
+	double lossWeight = (1-parameter) / divergenceFactor;
+
 	for (int i = 0; i < size-1; i++)
 	{
 		for (int j = i; j < size-1; j++)
 		{
-			optimalQualities[getIndex(i,j)] = parameter * sizeReductions[getIndex(i,j)] - (1-parameter) * divergences[getIndex(i,j)];
+			optimalQualities[getIndex(i,j)] = gainWeight * sizeReductions[getIndex(i,j)] - lossWeight * divergences[getIndex(i,j)];
 			optimalCuts[getIndex(i,j)] = i;
 			
 			for (int cut = i+1; cut <= j; cut++)
 			{
-			    double value = optimalQualities[getIndex(i,cut-1)] + parameter * sizeReductions[getIndex(cut,j)] - (1-parameter) * divergences[getIndex(cut,j)];
+			    double value = optimalQualities[getIndex(i,cut-1)] + gainWeight * sizeReductions[getIndex(cut,j)] - lossWeight * divergences[getIndex(cut,j)];
 				if (value > optimalQualities[getIndex(i,j)])
 				{
 					optimalQualities[getIndex(i,j)] = value;
@@ -208,13 +201,13 @@ void Ring::computeOptimalPartition (double parameter)
 		
 	firstOptimalCut = 0;
 	lastOptimalCut = size-1;
-	optimalQualities[getIndex(0,size-1)] = parameter * sizeReductions[getIndex(0,size-1)] - (1-parameter) * divergences[getIndex(0,size-1)];
+	optimalQualities[getIndex(0,size-1)] = gainWeight * sizeReductions[getIndex(0,size-1)] - lossWeight * divergences[getIndex(0,size-1)];
 
 	for (int i = 0; i < size-1; i++)
 	{
 		for (int j = i; j < size-1; j++)
 		{
-			double value = optimalQualities[getIndex(i,j)] + parameter * sizeReductions[getIndex(j+1,i-1)] - (1-parameter) * divergences[getIndex(j+1,i-1)];
+			double value = optimalQualities[getIndex(i,j)] + gainWeight * sizeReductions[getIndex(j+1,i-1)] - lossWeight * divergences[getIndex(j+1,i-1)];
 			if (value > optimalQualities[getIndex(0,size-1)])
 			{	
 				firstOptimalCut = i;
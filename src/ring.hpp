@@ -51,6 +51,8 @@ class Ring: public AbstractSet
 		double *microInfos;
 		double *sizeReductions;
 		double *divergences;
+		double sizeReductionFactor;
+		double divergenceFactor;
 	
 		double *optimalQualities;
 		int *optimalCuts;
@@ -38,6 +38,7 @@
 
 #include <iostream>
 #include <time.h>
+#include <chrono>
 #include <cstdio>
 #include <stdio.h>
 
@@ -167,3 +168,8 @@ int getMemory ()
     return 0;
 }
 
+
+double getWallTime ()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
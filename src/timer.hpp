@@ -90,4 +90,9 @@ private:
 
 int getMemory ();
 
+/*!
+ * \brief Return the elapsed wall-clock time in seconds since an arbitrary origin (unlike clock(), it does not sum the time of concurrent threads)
+ */
+double getWallTime ();
+
 #endif
@@ -128,6 +128,9 @@ void UniSet::print ()
 }
 
 
+void UniSet::getLazyRefinements (UniSubset *uniSubset, UniSubsetSetSet &refinements) {}
+
+
 UnconstrainedUniSet::UnconstrainedUniSet (int s, std::string *labels) : UniSet (0)
 {
 	size = s;
@@ -430,9 +433,162 @@ int BinaryTreeUniSet::buildTree (UniSubset *subset, int d, int i)
 }
 
 
-GraphBasedUniSet::GraphBasedUniSet (Graph *g) : UniSet (0)
+GraphBasedUniSet::GraphBasedUniSet (Graph *g, std::string *labels) : UniSet (0)
 {
-	graph = g;	
+	graph = g;
+	std::vector<UniSubset*> componentSubsets;
+
+	// Enumerate the connected subsets of each connected component
+	VertexSet reached (graph->size);
+	for (int vertex = 0; vertex < graph->size; vertex++)
+	{
+		if (reached.contains(vertex)) { continue; }
+
+		std::list<int> connectedVertices;
+		std::list<int> nextVertices;
+		VertexSet whole (graph->size);
+		nextVertices.push_back(vertex);
+		reached.insert(vertex);
+
+		while (!nextVertices.empty())
+		{
+			int v = nextVertices.front();
+			nextVertices.pop_front();
+			connectedVertices.push_back(v);
+			whole.insert(v);
+
+			VertexSet *adjVertices = &graph->adjacencySets[v];
+			for (int adjVertex = adjVertices->next(); adjVertex != -1; adjVertex = adjVertices->next(adjVertex+1))
+			{
+				if (!reached.contains(adjVertex)) { nextVertices.push_back(adjVertex); reached.insert(adjVertex); }
+			}
+		}
+
+		GraphComponent component (graph);
+		component.setVertices(&connectedVertices);
+
+		ConnectedSubsetIterator it (&component);
+		while (it.next())
+		{
+			VertexSet *subset = it.getSubset();
+			UniSubset *uniSubset = (it.getDepth() == 0) ? new UniSubset (it.getRoot()) : new UniSubset ();
+			if (labels != 0) { uniSubset->name = getLabel(subset,labels); }
+			subsetMap.insert(std::make_pair(*subset,uniSubset));
+		}
+
+		componentSubsets.push_back(subsetMap.at(whole));
+	}
+
+	// Stored refinements split off a vertex whose removal leaves the subset connected: every connected subset is reached this way, as a connected subset of a larger one misses at least one such vertex
+	for (UniSubsetMap::iterator it = subsetMap.begin(); it != subsetMap.end(); ++it)
+	{
+		const VertexSet &whole = it->first;
+		if (it->second->isAtomic) { continue; }
+
+		for (int v = whole.next(); v != -1; v = whole.next(v+1))
+		{
+			VertexSet rest (whole);
+			rest.erase(v);
+			if (rest.count() == 1 && v != whole.next()) { continue; }
+			if (!graph->isConnected(&rest)) { continue; }
+
+			VertexSet single (graph->size);
+			single.insert(v);
+			UniSubsetSet *subsetSet = new UniSubsetSet ();
+			subsetSet->push_back(subsetMap.at(single));
+			subsetSet->push_back(subsetMap.at(rest));
+			it->second->addUniSubsetSet(subsetSet);
+		}
+	}
+
+	// A disconnected graph is topped by the union of its components
+	if (componentSubsets.size() == 1) { firstUniSubset = componentSubsets.front(); }
+	else if (componentSubsets.size() > 1)
+	{
+		firstUniSubset = new UniSubset ();
+		if (labels != 0)
+		{
+			VertexSet all (graph->size);
+			for (int v = 0; v < graph->size; v++) { all.insert(v); }
+			firstUniSubset->name = getLabel(&all,labels);
+		}
+		firstUniSubset->addUniSubsetSet(new UniSubsetSet (componentSubsets.begin(), componentSubsets.end()));
+	}
+}
+
+
+std::string GraphBasedUniSet::getLabel (VertexSet *subset, std::string *labels)
+{
+	if (subset->count() == 1) { return "{" + labels[subset->next()] + "}"; }
+
+	bool first = true;
+	std::string label = "{";
+	for (int v = subset->next(); v != -1; v = subset->next(v+1))
+	{
+		if (!first) { label += ", "; } else { first = false; }
+		label += labels[v];
+	}
+	label += "}";
+	return label;
+}
+
+
+void GraphBasedUniSet::getLazyRefinements (UniSubset *uniSubset, UniSubsetSetSet &refinements)
+{
+	if (uniSubset->isAtomic) { return; }
+
+	VertexSet whole (graph->size);
+	for (IndexSet::iterator it = uniSubset->indexSet->begin(); it != uniSubset->indexSet->end(); ++it) { whole.insert(*it); }
+
+	// The top subset of a disconnected graph is only refined into its components
+	UniSubsetMap::iterator it = subsetMap.find(whole);
+	if (it == subsetMap.end() || it->second != uniSubset) { return; }
+
+	// Bipartitions are enumerated from the part containing the smallest vertex
+	int first = whole.next();
+	VertexSet part (graph->size);
+	VertexSet candidates (graph->adjacencySets[first]);
+	VertexSet forbidden (graph->size);
+	part.insert(first);
+	candidates.intersect(whole);
+	addRefinements(refinements,whole,part,candidates,forbidden);
+}
+
+
+void GraphBasedUniSet::addRefinements (UniSubsetSetSet &refinements, const VertexSet &whole, VertexSet &part, const VertexSet &candidates, const VertexSet &forbidden)
+{
+	// part is connected by construction: the refinement is feasible iff the rest of the subset is connected as well (refinements splitting off a single vertex being already stored)
+	int partSize = part.count();
+	int restSize = whole.count() - partSize;
+	if (partSize > 1 && restSize > 1)
+	{
+		VertexSet rest (whole);
+		rest.subtract(part);
+		if (graph->isConnected(&rest))
+		{
+			UniSubsetSet *subsetSet = new UniSubsetSet ();
+			subsetSet->push_back(subsetMap.at(part));
+			subsetSet->push_back(subsetMap.at(rest));
+			refinements.push_back(subsetSet);
+		}
+	}
+
+	// Each connected part is reached once: candidates are added in increasing order, and forbidden in the next branches once explored
+	VertexSet nextForbidden (forbidden);
+	for (int v = candidates.next(); v != -1; v = candidates.next(v+1))
+	{
+		VertexSet nextCandidates (candidates);
+		nextCandidates.unite(graph->adjacencySets[v]);
+		nextCandidates.intersect(whole);
+		nextCandidates.subtract(part);
+		nextCandidates.subtract(nextForbidden);
+		nextCandidates.erase(v);
+
+		part.insert(v);
+		addRefinements(refinements,whole,part,nextCandidates,nextForbidden);
+		part.erase(v);
+		nextForbidden.insert(v);
+	}
 }
 
 
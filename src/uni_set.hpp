@@ -40,6 +40,7 @@
 
 #include <list>
 #include <fstream>
+#include <unordered_map>
 
 #include "bi_set.hpp"
 #include "multi_set.hpp"
@@ -64,6 +65,8 @@ typedef std::list<UniSubset*> UniSubsetSet;
 typedef std::list<UniSubsetSet*> UniSubsetSetSet;
 typedef std::list<int> IndexSet;
 
+typedef std::unordered_map<VertexSet,UniSubset*,VertexSetHash> UniSubsetMap;
+
 typedef std::pair<UniSubset*,UniSubsetSet*> UniSubsetPair;
 typedef std::set<UniSubsetPair*> UniSubsetPairSet;
 
@@ -97,7 +100,7 @@ public:
 	/*!
      * \brief Destructor
      */
-	~UniSet ();
+	virtual ~UniSet ();
 
 	/*!
      * \brief Build a proper data structure to represent the uni-dimensional set of elements and its algebraic structure (warning: this method should be called after construction, and before actually using the set)
@@ -109,6 +112,13 @@ public:
      */
 	void print ();
 
+	/*!
+	 * \brief Generate the refinements of a subset that are not stored in its uniSubsetSetSet, when the optimisation visits it (none by default)
+	 * \param uniSubset : The subset to refine
+	 * \param refinements : List to which the generated refinements are added (to be deleted by the caller)
+	 */
+	virtual void getLazyRefinements (UniSubset *uniSubset, UniSubsetSetSet &refinements);
+
 protected:
 	VoterMeasurement *voterMeasurement; /** \brief (Optional) A probe measurement of a voter model that has been used to build this uni-dimensional set */
 	VoterProbe *voterProbe; /** \brief (Optional) A probe of a voter model that has been used to build this uni-dimensional set */
@@ -212,11 +222,36 @@ private:
 };
 
 
+/*!
+ * \class GraphBasedUniSet
+ * \brief A uni-dimensional set of elements structured according to a graph, and such that the feasible subsets are all the connected subsets of the graph (the refinements of a subset being its bipartitions into two connected subsets)
+ *
+ * Only the bipartitions splitting off a single vertex are stored, which is enough to reach every connected subset (the other ones, exponentially many on dense graphs, are generated by getLazyRefinements).
+ */
 class GraphBasedUniSet: public UniSet
 {
 public:
-	Graph *graph;
-	GraphBasedUniSet (Graph *graph);
+	Graph *graph; /** \brief Graph whose vertices are the elements of the set (only its adjacency is used) */
+
+	/*!
+	 * \brief Constructor
+	 * \param graph : Graph whose vertices are the elements of the set (Graph::buildDataStructure does not need to be called)
+	 * \param labels : (Optional) Labels for the atomic elements
+	 */
+	GraphBasedUniSet (Graph *graph, std::string *labels = 0);
+
+	/*!
+	 * \brief Generate the bipartitions of a connected subset into two connected subsets of at least two vertices each
+	 * \param uniSubset : The subset to refine
+	 * \param refinements : List to which the generated refinements are added (to be deleted by the caller)
+	 */
+	void getLazyRefinements (UniSubset *uniSubset, UniSubsetSetSet &refinements);
+
+private:
+	UniSubsetMap subsetMap; /** \brief Feasible subset associated to each connected subset of the graph */
+
+	std::string getLabel (VertexSet *subset, std::string *labels);
+	void addRefinements (UniSubsetSetSet &refinements, const VertexSet &whole, VertexSet &part, const VertexSet &candidates, const VertexSet &forbidden);
 };
 
 
@@ -0,0 +1,157 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "vertex_set.hpp"
+
+
+VertexSet::VertexSet (int s) { allocate(s); }
+
+
+VertexSet::VertexSet (const VertexSet &set)
+{
+	allocate(set.size);
+	for (int w = 0; w < wordNumber; w++) { words[w] = set.words[w]; }
+}
+
+
+VertexSet::~VertexSet () { if (words != &inlineWord) { delete [] words; } }
+
+
+VertexSet &VertexSet::operator= (const VertexSet &set)
+{
+	if (this == &set) { return *this; }
+	if (set.wordNumber != wordNumber)
+	{
+		if (words != &inlineWord) { delete [] words; }
+		allocate(set.size);
+	}
+	size = set.size;
+	for (int w = 0; w < wordNumber; w++) { words[w] = set.words[w]; }
+	return *this;
+}
+
+
+bool VertexSet::operator== (const VertexSet &set) const
+{
+	if (set.wordNumber != wordNumber) { return false; }
+	for (int w = 0; w < wordNumber; w++) { if (words[w] != set.words[w]) { return false; } }
+	return true;
+}
+
+
+size_t VertexSet::hash () const
+{
+	VertexWord h = 0;
+	for (int w = 0; w < wordNumber; w++)
+	{
+		h ^= words[w] + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+	}
+	h ^= h >> 31;
+	h *= 0xbf58476d1ce4e5b9ULL;
+	h ^= h >> 29;
+	return (size_t) h;
+}
+
+
+void VertexSet::allocate (int s)
+{
+	size = s;
+	wordNumber = (size + 63) / 64;
+	if (wordNumber <= 1) { words = &inlineWord; wordNumber = 1; }
+	else { words = new VertexWord [wordNumber]; }
+	clear();
+}
+
+
+void VertexSet::clear () { for (int w = 0; w < wordNumber; w++) { words[w] = 0; } }
+
+
+bool VertexSet::empty () const
+{
+	for (int w = 0; w < wordNumber; w++) { if (words[w] != 0) { return false; } }
+	return true;
+}
+
+
+int VertexSet::count () const
+{
+	int c = 0;
+	for (int w = 0; w < wordNumber; w++) { c += __builtin_popcountll(words[w]); }
+	return c;
+}
+
+
+bool VertexSet::intersects (const VertexSet &set) const
+{
+	for (int w = 0; w < wordNumber; w++) { if (words[w] & set.words[w]) { return true; } }
+	return false;
+}
+
+
+bool VertexSet::includes (const VertexSet &set) const
+{
+	for (int w = 0; w < wordNumber; w++) { if (set.words[w] & ~words[w]) { return false; } }
+	return true;
+}
+
+
+void VertexSet::unite (const VertexSet &set) { for (int w = 0; w < wordNumber; w++) { words[w] |= set.words[w]; } }
+void VertexSet::intersect (const VertexSet &set) { for (int w = 0; w < wordNumber; w++) { words[w] &= set.words[w]; } }
+void VertexSet::subtract (const VertexSet &set) { for (int w = 0; w < wordNumber; w++) { words[w] &= ~set.words[w]; } }
+
+
+Vertices *VertexSet::toVertices () const
+{
+	Vertices *vertices = new Vertices();
+	for (int v = next(); v != -1; v = next(v+1)) { vertices->insert(vertices->end(),v); }
+	return vertices;
+}
+
+
+void VertexSet::print (bool endl) const
+{
+	std::cout << "{";
+	bool first = true;
+	for (int v = next(); v != -1; v = next(v+1))
+	{
+		if (!first) { std::cout << ","; }
+		std::cout << v;
+		first = false;
+	}
+	std::cout << "}";
+	if (endl) { std::cout << std::endl; }
+}
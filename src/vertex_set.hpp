@@ -0,0 +1,144 @@
+/*
+ * This file is part of Optimal Partition.
+ *
+ * Optimal Partition is a toolbox to solve special versions of the Set
+ * Partitioning Problem, that is the combinatorial optimisation of a
+ * decomposable objective over a set of feasible partitions (defined
+ * according to specific algebraic structures: e.g., hierachies, sets of
+ * intervals, graphs). The objectives are mainly based on information theory,
+ * in the perspective of multilevel analysis of large-scale datasets, and the
+ * algorithms are based on dynamic programming. For details regarding the
+ * formal grounds of this work, please refer to:
+ * 
+ * Robin Lamarche-Perrin, Yves Demazeau and Jean-Marc Vincent. A Generic Set
+ * Partitioning Algorithm with Applications to Hierarchical and Ordered Sets.
+ * Technical Report 105/2014, Max-Planck-Institute for Mathematics in the
+ * Sciences, Leipzig, Germany, May 2014.
+ * 
+ * <http://www.mis.mpg.de/publications/preprints/2014/prepr2014-105.html>
+ * 
+ * Copyright © 2015 Robin Lamarche-Perrin
+ * (<Robin.Lamarche-Perrin@lip6.fr>)
+ * 
+ * Optimal Partition is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * Optimal Partition is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INCLUDE_VERTEX_SET
+#define INCLUDE_VERTEX_SET
+
+#include <set>
+#include <iostream>
+
+/*!
+ * \file vertex_set.hpp
+ * \brief Bitset representation of sets of vertices, so that unions, intersections and inclusion tests on graphs are word-parallel
+ * \author Robin Lamarche-Perrin
+ * \date 06/11/2015
+ */
+
+
+typedef std::set<int> Vertices;
+typedef unsigned long long VertexWord;
+
+
+/*!
+ * \class VertexSet
+ * \brief A set of vertices among {0,...,size-1} stored as a bitset (sets of at most 64 vertices are stored inline, without any allocation)
+ */
+class VertexSet
+{
+public:
+	int size; /** \brief Number of vertices that can be stored in the set */
+	int wordNumber; /** \brief Number of 64-bit words used to store the set */
+
+	/*!
+	 * \brief Constructor
+	 * \param size : The number of vertices that can be stored in the set (the set is initially empty)
+	 */
+	VertexSet (int size = 0);
+	VertexSet (const VertexSet &set);
+	~VertexSet ();
+
+	VertexSet &operator= (const VertexSet &set);
+	bool operator== (const VertexSet &set) const;
+
+	void insert (int v) { words[v >> 6] |= (VertexWord) 1 << (v & 63); }
+	void erase (int v) { words[v >> 6] &= ~((VertexWord) 1 << (v & 63)); }
+	bool contains (int v) const { return (words[v >> 6] >> (v & 63)) & 1; }
+
+	void clear ();
+	bool empty () const;
+	int count () const;
+
+	/*!
+	 * \brief Return true iff this set and the given set have at least one common vertex
+	 */
+	bool intersects (const VertexSet &set) const;
+
+	/*!
+	 * \brief Return true iff all the vertices of the given set are in this set (same as std::includes on sorted sets)
+	 */
+	bool includes (const VertexSet &set) const;
+
+	void unite (const VertexSet &set);
+	void intersect (const VertexSet &set);
+	void subtract (const VertexSet &set);
+
+	/*!
+	 * \brief Return the smallest vertex of the set that is greater than or equal to v, or -1 if there is none (iterate with `for (int v = set.next(); v != -1; v = set.next(v+1))`)
+	 */
+	int next (int v = 0) const;
+
+	/*!
+	 * \brief Return a hash of the vertices of the set, so that sets can be used as keys of unordered containers (see VertexSetHash)
+	 */
+	size_t hash () const;
+
+	Vertices *toVertices () const;
+	void print (bool endl = false) const;
+
+private:
+	VertexWord inlineWord; /** \brief Storage of the set when size <= 64 */
+	VertexWord *words; /** \brief Storage of the set (points to inlineWord when size <= 64) */
+
+	void allocate (int size);
+};
+
+
+/*!
+ * \struct VertexSetHash
+ * \brief Hash functor for unordered containers of vertex sets
+ */
+struct VertexSetHash
+{
+	size_t operator() (const VertexSet &set) const { return set.hash(); }
+};
+
+
+inline int VertexSet::next (int v) const
+{
+	if (v >= size) { return -1; }
+	int w = v >> 6;
+	VertexWord word = words[w] & (~(VertexWord) 0 << (v & 63));
+	while (word == 0)
+	{
+		if (++w == wordNumber) { return -1; }
+		word = words[w];
+	}
+	return (w << 6) + __builtin_ctzll(word);
+}
+
+
+#endif
@@ -48,6 +48,9 @@
 #include <cmath>
 #include <iterator>
 #include <sstream>
+#include <functional>
+#include <limits>
+#include <algorithm>
 
 #include "uni_set.hpp"
 #include "voter_graph.hpp"
@@ -310,83 +313,411 @@ MarkovProcess *VoterGraph::getMarkovProcess()
 {
     unsigned long int size = 1 << nodeNumber;
 
-    process = new MarkovProcess(size);
+    // Each state has at most one successor per node (plus itself): the kernel is built row by row as a sparse matrix
+    process = new MarkovProcess(size,false);
+    SparseMatrix *successors = new SparseMatrix (size);
+    std::vector< std::pair<int,double> > entries;
 
     for (unsigned long int i = 0; i < size; i++)
 		process->distribution[i] = 1./size;
 
     for (unsigned long int i = 0; i < size; i++)
-		for (unsigned long int j = 0; j < size; j++)
-			process->transition[j*size+i] = 0.;
-
-    if (updateProcess == UPDATE_EDGES)
     {
-		for (unsigned long int i = 0; i < size; i++)
+		getSuccessors(i,entries);
+		successors->addRow(entries);
+    }
+
+    process->setSparseTransition(successors);
+    return process;
+}
+
+
+void VoterGraph::getSuccessors (unsigned long int i, std::vector< std::pair<int,double> > &entries)
+{
+    entries.clear();
+
+	if (updateProcess == UPDATE_EDGES)
+	{
+		if (edgeNumber == 0 || edgeWeight == 0.) { entries.push_back(std::make_pair(i,1.)); std::cout << "NO EDGE!\n"; }
+		else {
+			for (std::set<VoterEdge*>::iterator it = edgeSet->begin(); it != edgeSet->end(); ++it)
+			{
+				VoterEdge *e = *it;
+				int n1 = e->node1->id;
+				int n2 = e->node2->id;
+	
+				bool s1 = (i >> n1) % 2;
+				bool s2 = (i >> n2) % 2;
+				
+				unsigned long int j;
+				if (s1 && !s2) { j = i + (1 << n2); }
+				else if (!s1 && s2) { j = i - (1 << n2); }
+				else { j = i; }
+				
+				double p = e->weight/edgeWeight * (1 - e->node2->contrarian);
+				if (p != 0) { entries.push_back(std::make_pair(j,p)); }
+
+
+				if (s1 && s2) { j = i - (1 << n2); }
+				else if (!s1 && !s2) { j = i + (1 << n2); }
+				else { j = i; }
+				
+				p = e->weight/edgeWeight * e->node2->contrarian;
+				if (p != 0) { entries.push_back(std::make_pair(j,p)); }
+			}
+		}
+	}
+
+	if (updateProcess == UPDATE_NODES)
+	{
+		for (std::set<VoterNode*>::iterator it1 = nodeSet->begin(); it1 != nodeSet->end(); ++it1)
 		{
-			if (edgeNumber == 0 || edgeWeight == 0.) { process->transition[i*size+i] = 1.; std::cout << "NO EDGE!\n"; }
-			else {
-				for (std::set<VoterEdge*>::iterator it = edgeSet->begin(); it != edgeSet->end(); ++it)
-				{
-					VoterEdge *e = *it;
-					int n1 = e->node1->id;
-					int n2 = e->node2->id;
-		
-					bool s1 = (i >> n1) % 2;
-					bool s2 = (i >> n2) % 2;
-					
-					unsigned long int j;
-					if (s1 && !s2) { j = i + (1 << n2); }
-					else if (!s1 && s2) { j = i - (1 << n2); }
-					else { j = i; }
-					
-					process->transition[j*size+i] += e->weight/edgeWeight * (1 - e->node2->contrarian);
+			VoterNode *node2 = *it1;
+			int n2 = node2->id;
+			bool s2 = (i >> n2) % 2;
 
+			unsigned long int j;
+			if (s2) { j = i - (1 << n2); } else { j = i + (1 << n2); }
+			double p = node2->weight/nodeWeight * node2->contrarian;
+			if (p != 0) { entries.push_back(std::make_pair(j,p)); }
+			
+			for (std::set<VoterEdge*>::iterator it2 = node2->inEdgeSet->begin(); it2 != node2->inEdgeSet->end(); ++it2)
+			{
+				VoterEdge *e = *it2;
+				int n1 = e->node1->id;
 
-					if (s1 && s2) { j = i - (1 << n2); }
-					else if (!s1 && !s2) { j = i + (1 << n2); }
-					else { j = i; }
+				bool s1 = (i >> n1) % 2;
+				
+				if (s1 && !s2) { j = i + (1 << n2); }
+				else if (!s1 && s2) { j = i - (1 << n2); }
+				else { j = i; }
 					
-					process->transition[j*size+i] += e->weight/edgeWeight * e->node2->contrarian;
-				}
+				p = node2->weight/nodeWeight * e->weight/node2->inEdgeWeight * (1 - node2->contrarian);
+				if (p != 0) { entries.push_back(std::make_pair(j,p)); }
 			}
 		}
+	}
+}
+
+
+std::vector<double> VoterGraph::getEdgeWeights ()
+{
+    std::vector<double> weights ((long) nodeNumber*nodeNumber, 0);
+    for (std::set<VoterEdge*>::iterator it = edgeSet->begin(); it != edgeSet->end(); ++it)
+		weights[(long) (*it)->node1->id*nodeNumber + (*it)->node2->id] += (*it)->weight;
+    return weights;
+}
+
+
+void VoterGraph::computeNodeClasses ()
+{
+    std::vector<double> weights = getEdgeWeights();
+    int N = nodeNumber;
+
+    // Swapping u and v is an automorphism iff they have the same attributes and the same edges with every other node
+    auto interchangeable = [&] (int u, int v)
+    {
+		VoterNode *nu = nodeMap->at(u);
+		VoterNode *nv = nodeMap->at(v);
+		if (nu->weight != nv->weight || nu->contrarian != nv->contrarian) { return false; }
+		if (weights[(long) u*N+u] != weights[(long) v*N+v] || weights[(long) u*N+v] != weights[(long) v*N+u]) { return false; }
+		for (int x = 0; x < N; x++)
+		{
+			if (x == u || x == v) { continue; }
+			if (weights[(long) x*N+u] != weights[(long) x*N+v] || weights[(long) u*N+x] != weights[(long) v*N+x]) { return false; }
+		}
+		return true;
+    };
+
+    std::vector< std::vector<int> > classes;
+    nodeClasses.assign(N,-1);
+    for (int u = 0; u < N; u++)
+    {
+		for (unsigned int c = 0; c < classes.size() && nodeClasses[u] == -1; c++)
+		{
+			bool member = true;
+			for (unsigned int m = 0; m < classes[c].size() && member; m++) { member = interchangeable(u,classes[c][m]); }
+			if (member) { nodeClasses[u] = c; classes[c].push_back(u); }
+		}
+		if (nodeClasses[u] == -1) { nodeClasses[u] = classes.size(); classes.push_back(std::vector<int>(1,u)); }
     }
-	
-    if (updateProcess == UPDATE_NODES)
+
+    classSizes.resize(classes.size());
+    for (unsigned int c = 0; c < classes.size(); c++) { classSizes[c] = classes[c].size(); }
+}
+
+
+std::vector< std::vector<int> > VoterGraph::getAutomorphismGenerators ()
+{
+    std::vector<double> weights = getEdgeWeights();
+    int N = nodeNumber;
+
+    std::vector< std::vector<int> > generators;
+    std::vector<int> image (N,-1);
+    std::vector<bool> used (N,false);
+
+    // Node v can be the image of node u given the images of the previous nodes
+    auto compatible = [&] (int u, int v) -> bool
     {
-		for (unsigned long int i = 0; i < size; i++)
+		VoterNode *nu = nodeMap->at(u);
+		VoterNode *nv = nodeMap->at(v);
+		if (nu->weight != nv->weight || nu->contrarian != nv->contrarian || weights[(long) u*N+u] != weights[(long) v*N+v]) { return false; }
+		for (int x = 0; x < u; x++)
+			if (weights[(long) x*N+u] != weights[(long) image[x]*N+v] || weights[(long) u*N+x] != weights[(long) v*N+image[x]]) { return false; }
+		return true;
+    };
+
+    // Depth-first search of the images of the next nodes, stopping at the first automorphism
+    std::function<bool (int)> extend = [&] (int u) -> bool
+    {
+		if (u == N) { return true; }
+		for (int v = 0; v < N; v++)
 		{
-			for (std::set<VoterNode*>::iterator it1 = nodeSet->begin(); it1 != nodeSet->end(); ++it1)
+			if (used[v] || !compatible(u,v)) { continue; }
+			image[u] = v;
+			used[v] = true;
+			if (extend(u+1)) { return true; }
+			used[v] = false;
+		}
+		image[u] = -1;
+		return false;
+    };
+
+    // For each node u, an automorphism fixing the previous nodes and mapping u to each node of its orbit under their stabilizer (these coset representatives generate the whole group)
+    for (int u = 0; u < N; u++)
+    {
+		unsigned int levelStart = generators.size();
+		std::vector<bool> orbit (N,false);
+		orbit[u] = true;
+
+		for (int v = u+1; v < N; v++)
+		{
+			if (orbit[v]) { continue; }
+
+			std::fill(image.begin(),image.end(),-1);
+			std::fill(used.begin(),used.end(),false);
+			for (int x = 0; x < u; x++) { image[x] = x; used[x] = true; }
+			if (!compatible(u,v)) { continue; }
+			image[u] = v;
+			used[v] = true;
+			if (!extend(u+1)) { continue; }
+			generators.push_back(image);
+
+			// Orbit of u under the automorphisms found at this level
+			std::vector<int> nodes (1,u);
+			std::fill(orbit.begin(),orbit.end(),false);
+			orbit[u] = true;
+			for (unsigned int k = 0; k < nodes.size(); k++)
+				for (unsigned int g = levelStart; g < generators.size(); g++)
+				{
+					int w = generators[g][nodes[k]];
+					if (!orbit[w]) { orbit[w] = true; nodes.push_back(w); }
+				}
+		}
+    }
+
+    return generators;
+}
+
+
+int VoterGraph::getSymmetricState (unsigned long int i)
+{
+    if (!orbitIndices.empty()) { return orbitIndices[i]; }
+
+    std::vector<int> counts (classSizes.size(), 0);
+    for (int n = 0; n < nodeNumber; n++) { counts[nodeClasses[n]] += (i >> n) % 2; }
+
+    int state = 0;
+    int stride = 1;
+    for (unsigned int c = 0; c < classSizes.size(); c++) { state += counts[c] * stride; stride *= classSizes[c] + 1; }
+    return state;
+}
+
+
+MarkovProcess *VoterGraph::getSymmetricMarkovProcess ()
+{
+    computeNodeClasses();
+    orbitIndices.clear();
+    int classNumber = classSizes.size();
+
+    if (classNumber == nodeNumber)
+    {
+		// No interchangeable nodes: the states are lumped by orbits under the automorphisms
+		if (nodeNumber > MAX_ORBIT_NODES) { std::cout << "ERROR: too many nodes to enumerate the orbits of the states!" << std::endl; return 0; }
+
+		// Orbits are the classes of the states linked by a generator of the automorphism group (union-find with path halving)
+		std::vector< std::vector<int> > generators = getAutomorphismGenerators();
+		unsigned long int microSize = 1UL << nodeNumber;
+		std::vector<int> roots (microSize);
+		for (unsigned long int i = 0; i < microSize; i++) { roots[i] = i; }
+		auto find = [&] (int i) { while (roots[i] != i) { roots[i] = roots[roots[i]]; i = roots[i]; } return i; };
+
+		for (unsigned int g = 0; g < generators.size(); g++)
+			for (unsigned long int i = 0; i < microSize; i++)
 			{
-				VoterNode *node2 = *it1;
-				int n2 = node2->id;
-				bool s2 = (i >> n2) % 2;
+				unsigned long int j = 0;
+				for (int n = 0; n < nodeNumber; n++) { j |= ((i >> n) & 1UL) << generators[g][n]; }
+				int ri = find(i);
+				int rj = find(j);
+				if (ri != rj) { roots[std::max(ri,rj)] = std::min(ri,rj); }
+			}
 
-				unsigned long int j;
-				if (s2) { j = i - (1 << n2); } else { j = i + (1 << n2); }
-				process->transition[j*size+i] += node2->weight/nodeWeight * node2->contrarian;
-				
-				for (std::set<VoterEdge*>::iterator it2 = node2->inEdgeSet->begin(); it2 != node2->inEdgeSet->end(); ++it2)
+		// Orbits are indexed in the order of their smallest state, which represents them
+		orbitIndices.assign(microSize,-1);
+		std::vector<unsigned long int> representatives;
+		std::vector<int> orbitSizes;
+		for (unsigned long int i = 0; i < microSize; i++)
+		{
+			int r = find(i);
+			if (orbitIndices[r] == -1) { orbitIndices[r] = representatives.size(); representatives.push_back(i); orbitSizes.push_back(0); }
+			orbitIndices[i] = orbitIndices[r];
+			orbitSizes[orbitIndices[i]]++;
+		}
+
+		int size = representatives.size();
+		process = new MarkovProcess(size,false);
+		SparseMatrix *successors = new SparseMatrix (size);
+		std::vector< std::pair<int,double> > entries;
+
+		for (int o = 0; o < size; o++)
+		{
+			process->distribution[o] = ((double) orbitSizes[o]) / microSize;
+			getSuccessors(representatives[o],entries);
+			for (unsigned int e = 0; e < entries.size(); e++) { entries[e].first = orbitIndices[entries[e].first]; }
+			successors->addRow(entries);
+		}
+
+		process->setSparseTransition(successors);
+		return process;
+    }
+
+    // Otherwise, a state gives the number of nodes in state 1 within each class (in mixed radix)
+    std::vector<double> weights = getEdgeWeights();
+    std::vector<int> representatives (classNumber);
+    for (int n = nodeNumber-1; n >= 0; n--) { representatives[nodeClasses[n]] = n; }
+
+    std::vector<long> strides (classNumber+1, 1);
+    for (int c = 0; c < classNumber; c++) { strides[c+1] = strides[c] * (classSizes[c] + 1); }
+    if (strides[classNumber] > std::numeric_limits<int>::max()) { std::cout << "ERROR: too many classes of interchangeable nodes!" << std::endl; return 0; }
+    int size = strides[classNumber];
+
+    // classWeights[a*classNumber+b] is the weight of each edge from a node of class a to another node of class b, selfWeights[a] the weight of the loops
+    std::vector<double> classWeights ((long) classNumber*classNumber, 0);
+    std::vector<double> selfWeights (classNumber);
+    for (int a = 0; a < classNumber; a++)
+    {
+		int u = representatives[a];
+		selfWeights[a] = weights[(long) u*nodeNumber+u];
+		for (int v = 0; v < nodeNumber; v++)
+			if (v != u) { classWeights[a*classNumber+nodeClasses[v]] = weights[(long) u*nodeNumber+v]; }
+    }
+
+    process = new MarkovProcess(size,false);
+    SparseMatrix *successors = new SparseMatrix (size);
+    std::vector< std::pair<int,double> > entries;
+    std::vector<int> counts (classNumber);
+
+    for (int i = 0; i < size; i++)
+    {
+		for (int c = 0; c < classNumber; c++) { counts[c] = (i / strides[c]) % (classSizes[c] + 1); }
+
+		double logProb = - nodeNumber * log(2.);
+		for (int c = 0; c < classNumber; c++) { logProb += lgamma(classSizes[c]+1) - lgamma(counts[c]+1) - lgamma(classSizes[c]-counts[c]+1); }
+		process->distribution[i] = exp(logProb);
+
+		entries.clear();
+		auto add = [&] (int j, double p) { if (p != 0) { entries.push_back(std::make_pair(j,p)); } };
+
+		if (updateProcess == UPDATE_EDGES)
+		{
+			if (edgeNumber == 0 || edgeWeight == 0.) { entries.push_back(std::make_pair(i,1.)); std::cout << "NO EDGE!\n"; }
+
+			for (int a = 0; a < classNumber && edgeWeight != 0.; a++)
+				for (int b = 0; b < classNumber; b++)
 				{
-					VoterEdge *e = *it2;
-					int n1 = e->node1->id;
+					double f = classWeights[a*classNumber+b] / edgeWeight;
+					double c = nodeMap->at(representatives[b])->contrarian;
+					double ka = counts[a], kb = counts[b], na = classSizes[a], nb = classSizes[b];
 
-					bool s1 = (i >> n1) % 2;
-					
-					if (s1 && !s2) { j = i + (1 << n2); }
-					else if (!s1 && s2) { j = i - (1 << n2); }
-					else { j = i; }
-						
-					process->transition[j*size+i] += node2->weight/nodeWeight * e->weight/node2->inEdgeWeight * (1 - node2->contrarian);
+					// Number of edges from a to b whose nodes are in states (1,0), (0,1), (1,1) and (0,0)
+					double n10, n01, n11, n00;
+					if (a != b) { n10 = ka*(nb-kb); n01 = (na-ka)*kb; n11 = ka*kb; n00 = (na-ka)*(nb-kb); }
+					else { n10 = ka*(na-ka); n01 = (na-ka)*ka; n11 = ka*(ka-1); n00 = (na-ka)*(na-ka-1); }
+
+					if (a == b && selfWeights[a] != 0)
+					{
+						double g = selfWeights[a] / edgeWeight;
+						add(i, g*ka*(1-c));
+						add(i - strides[a], g*ka*c);
+						add(i, g*(na-ka)*(1-c));
+						add(i + strides[a], g*(na-ka)*c);
+					}
+					if (f == 0) { continue; }
+
+					add(i + strides[b], f*n10*(1-c)); add(i, f*n10*c);
+					add(i - strides[b], f*n01*(1-c)); add(i, f*n01*c);
+					add(i, f*n11*(1-c)); add(i - strides[b], f*n11*c);
+					add(i, f*n00*(1-c)); add(i + strides[b], f*n00*c);
 				}
+		}
+
+		if (updateProcess == UPDATE_NODES)
+		{
+			for (int b = 0; b < classNumber; b++)
+			{
+				VoterNode *node = nodeMap->at(representatives[b]);
+				double nodeProb = node->weight / nodeWeight;
+				double c = node->contrarian;
+				double kb = counts[b], nb = classSizes[b];
+
+				// Weights of the incoming edges of a node of class b from nodes in state 1 and in state 0 (other nodes of b excluded)
+				double ones = 0, zeros = 0;
+				for (int a = 0; a < classNumber; a++)
+					if (a != b) { ones += classWeights[a*classNumber+b] * counts[a]; zeros += classWeights[a*classNumber+b] * (classSizes[a]-counts[a]); }
+				double intra = classWeights[b*classNumber+b];
+
+				// Nodes of class b in state 1, then in state 0
+				add(i - strides[b], kb * nodeProb * c);
+				add(i + strides[b], (nb-kb) * nodeProb * c);
+				if (node->inEdgeWeight > 0)
+				{
+					double q = nodeProb * (1-c) / node->inEdgeWeight;
+					add(i - strides[b], kb * q * (zeros + intra*(nb-kb)));
+					add(i, kb * q * (ones + intra*(kb-1) + selfWeights[b]));
+					add(i + strides[b], (nb-kb) * q * (ones + intra*kb));
+					add(i, (nb-kb) * q * (zeros + intra*(nb-kb-1) + selfWeights[b]));
+				}
+				else { add(i, nb * nodeProb * (1-c)); }
 			}
 		}
+
+		successors->addRow(entries);
     }
 
+    process->setSparseTransition(successors);
     return process;
 }
 
 
+Partition *VoterGraph::getSymmetricPartition ()
+{
+    if (nodeNumber > MAX_ORBIT_NODES) { std::cout << "ERROR: too many nodes to enumerate the microscopic states!" << std::endl; return 0; }
+    unsigned long int microSize = 1UL << nodeNumber;
+    int size = (process != 0) ? process->size : 0;
+    Partition *partition = new Partition();
+
+    std::vector<Part*> parts (size);
+    for (int s = 0; s < size; s++) { parts[s] = new Part(); parts[s]->id = s; }
+    for (unsigned long int i = 0; i < microSize; i++)
+    {
+		int s = getSymmetricState(i);
+		parts[s]->addIndividual(i,false,s);
+    }
+    for (int s = 0; s < size; s++) { partition->addPart(parts[s]); }
+    return partition;
+}
+
+
 
 Partition *VoterGraph::getMarkovPartition (VoterProbe *probe, VoterMetric metric)
 {
@@ -78,6 +78,12 @@ enum UpdateProcess {
 };
 
 
+/*!
+ * \brief The maximal number of nodes of a graph without interchangeable nodes for which getSymmetricMarkovProcess enumerates the orbits of the states
+ */
+const int MAX_ORBIT_NODES = 22;
+
+
 /*!
  * \brief A specific measurement in the case of a two-communities interaction graphs
  */
@@ -211,6 +217,10 @@ public:
     std::set<VoterEdge*> *edgeSet;		/*!< The set of all edges*/
 		
     MarkovProcess *process;		/*!< The Markov chain associated to the described Voter Model*/
+
+    std::vector<int> nodeClasses;	/*!< The class of interchangeable nodes of each node (by id), computed by getSymmetricMarkovProcess*/
+    std::vector<int> classSizes;	/*!< The size of each class of interchangeable nodes*/
+    std::vector<int> orbitIndices;	/*!< If no nodes are interchangeable, the lumped state of each microscopic state, computed by getSymmetricMarkovProcess (empty otherwise)*/
 		
     /*!
      * \brief Constructor
@@ -260,6 +270,22 @@ public:
      * \return The computed Markov chain
      */
     MarkovProcess *getMarkovProcess ();
+
+    /*!
+     * \brief Build the Markov chain associated to the described Voter Model, exactly lumped according to the symmetries of the graph: if some nodes are interchangeable (as in complete graphs or communities), a state gives the number of nodes in state 1 within each class of interchangeable nodes; otherwise, a state is an orbit of microscopic states under the automorphisms of the graph (as the rotations and reflections of a ring), for graphs of at most MAX_ORBIT_NODES nodes
+     * \return The computed lumped Markov chain (null if the state space is too large)
+     */
+    MarkovProcess *getSymmetricMarkovProcess ();
+
+    /*!
+     * \brief Build the partition of the Markov chain state space (see getMarkovProcess) into the lumped states of getSymmetricMarkovProcess (which should be called before), each part having the index of its lumped state as id and value, for graphs of at most MAX_ORBIT_NODES nodes
+     */
+    Partition *getSymmetricPartition ();
+
+    /*!
+     * \brief Get a generating set of the automorphisms of the graph (the permutations of the nodes preserving their weights and contrarian rates and the weights of the edges), each one giving the image of each node: for each node, automorphisms fixing the previous nodes and mapping it to each node of its orbit (hence at most N(N-1)/2 generators)
+     */
+    std::vector< std::vector<int> > getAutomorphismGenerators ();
 		
     /*!
      * \brief Build the partition of the Markov chain state space associated to a probe with a given metric (e.g., METRIC_MACRO_STATE of METRIC_ACTIVE_EDGES)
@@ -275,6 +301,27 @@ public:
      * \return The computed partition
      */
     Partition *getMarkovPartition (VoterMeasurement *measurement);
+
+private:
+    /*!
+     * \brief Return the matrix of the weights of the edges between nodes, n1 to n2 being at n1*nodeNumber+n2
+     */
+    std::vector<double> getEdgeWeights ();
+
+    /*!
+     * \brief Compute the classes of interchangeable nodes (two nodes are interchangeable if swapping them is an automorphism)
+     */
+    void computeNodeClasses ();
+
+    /*!
+     * \brief Get the pairs (next state, probability) of a microscopic state (possibly with duplicated next states)
+     */
+    void getSuccessors (unsigned long int i, std::vector< std::pair<int,double> > &entries);
+
+    /*!
+     * \brief Get the index of the lumped state of a microscopic state (see getSymmetricMarkovProcess)
+     */
+    int getSymmetricState (unsigned long int i);
 };
 
 